@@ -37,7 +37,7 @@ NS_CC_BEGIN
 // Action Base Class
 //
 
-Action::Action() : _originalTarget(nullptr), _target(nullptr), _tag(Action::INVALID_TAG), _flags(0) {}
+Action::Action() : _originalTarget(nullptr), _target(nullptr), _tag(Action::INVALID_TAG), _flags(0), _batchSlot(-1) {}
 
 Action::~Action()
 {
@@ -178,6 +178,10 @@ protected:
     int _tag;
     /** The action flag field. To categorize action into certain groups.*/
     unsigned int _flags;
+    /** The slot of the action in the batch of its ActionManager, -1 when the action is stepped. */
+    int _batchSlot;
+    friend class ActionBatch;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Action);
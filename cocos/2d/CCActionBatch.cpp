@@ -0,0 +1,480 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCActionBatch.h"
+#include "2d/CCActionInterval.h"
+#include "2d/CCActionEase.h"
+#include "2d/CCTweenFunction.h"
+#include "2d/CCNode.h"
+#include "base/ccMacros.h"
+
+#include <algorithm>
+#include <typeinfo>
+
+NS_CC_BEGIN
+
+namespace
+{
+struct EaseFunction
+{
+    const std::type_info& type;
+    float (*function)(float);
+};
+
+// the ease actions defined with EASE_TEMPLATE_IMPL
+const EaseFunction s_easeFunctions[] = {
+    {typeid(EaseExponentialIn), tweenfunc::expoEaseIn},
+    {typeid(EaseExponentialOut), tweenfunc::expoEaseOut},
+    {typeid(EaseExponentialInOut), tweenfunc::expoEaseInOut},
+    {typeid(EaseSineIn), tweenfunc::sineEaseIn},
+    {typeid(EaseSineOut), tweenfunc::sineEaseOut},
+    {typeid(EaseSineInOut), tweenfunc::sineEaseInOut},
+    {typeid(EaseBounceIn), tweenfunc::bounceEaseIn},
+    {typeid(EaseBounceOut), tweenfunc::bounceEaseOut},
+    {typeid(EaseBounceInOut), tweenfunc::bounceEaseInOut},
+    {typeid(EaseBackIn), tweenfunc::backEaseIn},
+    {typeid(EaseBackOut), tweenfunc::backEaseOut},
+    {typeid(EaseBackInOut), tweenfunc::backEaseInOut},
+    {typeid(EaseQuadraticActionIn), tweenfunc::quadraticIn},
+    {typeid(EaseQuadraticActionOut), tweenfunc::quadraticOut},
+    {typeid(EaseQuadraticActionInOut), tweenfunc::quadraticInOut},
+    {typeid(EaseQuarticActionIn), tweenfunc::quartEaseIn},
+    {typeid(EaseQuarticActionOut), tweenfunc::quartEaseOut},
+    {typeid(EaseQuarticActionInOut), tweenfunc::quartEaseInOut},
+    {typeid(EaseQuinticActionIn), tweenfunc::quintEaseIn},
+    {typeid(EaseQuinticActionOut), tweenfunc::quintEaseOut},
+    {typeid(EaseQuinticActionInOut), tweenfunc::quintEaseInOut},
+    {typeid(EaseCircleActionIn), tweenfunc::circEaseIn},
+    {typeid(EaseCircleActionOut), tweenfunc::circEaseOut},
+    {typeid(EaseCircleActionInOut), tweenfunc::circEaseInOut},
+    {typeid(EaseCubicActionIn), tweenfunc::cubicEaseIn},
+    {typeid(EaseCubicActionOut), tweenfunc::cubicEaseOut},
+    {typeid(EaseCubicActionInOut), tweenfunc::cubicEaseInOut},
+};
+}  // namespace
+
+bool ActionBatch::add(Action* action, bool paused)
+{
+    CCASSERT(action->_batchSlot < 0, "action is already batched");
+
+    // only the exact types, so that an overridden update() is never skipped
+    const std::type_info& type = typeid(*action);
+
+    EaseType easeType            = EASE_NONE;
+    float easeRate               = 0.0f;
+    float (*easeFunction)(float) = nullptr;
+    Action* inner                = action;
+    if (type == typeid(EaseIn))
+        easeType = EASE_IN;
+    else if (type == typeid(EaseOut))
+        easeType = EASE_OUT;
+    else if (type == typeid(EaseInOut))
+        easeType = EASE_IN_OUT;
+    else
+    {
+        for (auto&& ease : s_easeFunctions)
+        {
+            if (type == ease.type)
+            {
+                easeType     = EASE_FUNCTION;
+                easeFunction = ease.function;
+                break;
+            }
+        }
+    }
+
+    if (easeType != EASE_NONE)
+    {
+        if (easeType != EASE_FUNCTION)
+            easeRate = static_cast<EaseRateAction*>(action)->_rate;
+        inner = static_cast<ActionEase*>(action)->_inner;
+    }
+
+    const std::type_info& innerType = typeid(*inner);
+
+    int lane;
+    size_t index;
+    if (innerType == typeid(MoveTo) || innerType == typeid(MoveBy))
+    {
+        auto move = static_cast<MoveBy*>(inner);
+        lane      = LANE_MOVE;
+        index     = _moves.values.size();
+        _moves.values.push_back({move->_startPosition, move->_positionDelta, move->_previousPosition});
+    }
+    else if (innerType == typeid(ScaleTo) || innerType == typeid(ScaleBy))
+    {
+        auto scale = static_cast<ScaleTo*>(inner);
+        lane       = LANE_SCALE;
+        index      = _scales.values.size();
+        _scales.values.push_back({Vec3(scale->_startScaleX, scale->_startScaleY, scale->_startScaleZ),
+                                  Vec3(scale->_deltaX, scale->_deltaY, scale->_deltaZ)});
+    }
+    else if (innerType == typeid(RotateTo) && !static_cast<RotateTo*>(inner)->_is3D)
+    {
+        auto rotate = static_cast<RotateTo*>(inner);
+        lane        = LANE_ROTATE;
+        index       = _rotations.values.size();
+        _rotations.values.push_back({Vec2(rotate->_startAngle.x, rotate->_startAngle.y),
+                                     Vec2(rotate->_diffAngle.x, rotate->_diffAngle.y)});
+    }
+    else if (innerType == typeid(FadeTo))
+    {
+        auto fade = static_cast<FadeTo*>(inner);
+        lane      = LANE_FADE;
+        index     = _fades.values.size();
+        _fades.values.push_back({(float)fade->_fromOpacity, (float)fade->_toOpacity});
+    }
+    else if (innerType == typeid(TintTo))
+    {
+        auto tint = static_cast<TintTo*>(inner);
+        lane      = LANE_TINT;
+        index     = _tints.values.size();
+        _tints.values.push_back({tint->_from, tint->_to});
+    }
+    else
+    {
+        return false;
+    }
+
+    auto interval  = static_cast<ActionInterval*>(action);
+    Timing& timing = getTiming(lane);
+    timing.actions.push_back(action);
+    timing.inners.push_back(static_cast<ActionInterval*>(inner));
+    timing.targets.push_back(action->getTarget());
+    timing.elapsed.push_back(interval->_elapsed);
+    timing.durations.push_back(interval->getDuration());
+    timing.firstTicks.push_back(interval->_firstTick);
+    timing.paused.push_back(paused);
+    timing.easeTypes.push_back(easeType);
+    timing.easeRates.push_back(easeRate);
+    timing.easeFunctions.push_back(easeFunction);
+
+    action->_batchSlot = (int)(index * LANE_COUNT + lane);
+    ++_size;
+    return true;
+}
+
+void ActionBatch::remove(Action* action)
+{
+    CCASSERT(action->_batchSlot >= 0, "action isn't batched");
+
+    int lane     = action->_batchSlot % LANE_COUNT;
+    size_t index = action->_batchSlot / LANE_COUNT;
+    writeBack(lane, index);
+    action->_batchSlot = -1;
+    --_size;
+
+    // the lanes are being iterated, they are compacted once update() is done
+    if (_updating)
+    {
+        getTiming(lane).actions[index] = nullptr;
+        _needCompact                   = true;
+    }
+    else
+    {
+        erase(lane, index);
+    }
+}
+
+void ActionBatch::setPaused(Action* action, bool paused)
+{
+    CCASSERT(action->_batchSlot >= 0, "action isn't batched");
+    getTiming(action->_batchSlot % LANE_COUNT).paused[action->_batchSlot / LANE_COUNT] = paused;
+}
+
+void ActionBatch::update(float dt, std::vector<Action*>& finished)
+{
+    // the setters of the targets may add or remove actions, so lanes are indexed again after every call into a node
+    _updating = true;
+    updateMoves(dt, finished);
+    updateScales(dt, finished);
+    updateRotations(dt, finished);
+    updateFades(dt, finished);
+    updateTints(dt, finished);
+    _updating = false;
+
+    if (_needCompact)
+    {
+        compact();
+    }
+}
+
+ActionBatch::Timing& ActionBatch::getTiming(int lane)
+{
+    switch (lane)
+    {
+    case LANE_MOVE:
+        return _moves;
+    case LANE_SCALE:
+        return _scales;
+    case LANE_ROTATE:
+        return _rotations;
+    case LANE_FADE:
+        return _fades;
+    default:
+        return _tints;
+    }
+}
+
+float ActionBatch::stepTime(Timing& timing, size_t index, float dt)
+{
+    // same as ActionInterval::step()
+    float& elapsed = timing.elapsed[index];
+    if (timing.firstTicks[index])
+    {
+        timing.firstTicks[index] = false;
+        elapsed                  = 0;
+    }
+    else
+    {
+        elapsed += dt;
+    }
+
+    float time = std::max(0.0f, std::min(1.0f, elapsed / timing.durations[index]));
+    switch (timing.easeTypes[index])
+    {
+    case EASE_IN:
+        return tweenfunc::easeIn(time, timing.easeRates[index]);
+    case EASE_OUT:
+        return tweenfunc::easeOut(time, timing.easeRates[index]);
+    case EASE_IN_OUT:
+        return tweenfunc::easeInOut(time, timing.easeRates[index]);
+    case EASE_FUNCTION:
+        return timing.easeFunctions[index](time);
+    default:
+        return time;
+    }
+}
+
+void ActionBatch::finishIfDone(Timing& timing, size_t index, std::vector<Action*>& finished)
+{
+    // the action may have been removed by the target
+    if (timing.actions[index] && timing.elapsed[index] >= timing.durations[index])
+    {
+        // retained, the setters of the targets may remove the action before the caller stops it
+        timing.actions[index]->retain();
+        finished.emplace_back(timing.actions[index]);
+    }
+}
+
+void ActionBatch::updateMoves(float dt, std::vector<Action*>& finished)
+{
+    for (size_t i = 0, count = _moves.actions.size(); i < count; ++i)
+    {
+        if (!_moves.actions[i] || _moves.paused[i])
+            continue;
+
+        float t      = stepTime(_moves, i, dt);
+        auto& values = _moves.values[i];
+        Node* target = _moves.targets[i];
+        // same as MoveBy::update()
+#if CC_ENABLE_STACKABLE_ACTIONS
+        Vec3 diff    = target->getPosition3D() - values.previous;
+        values.start = values.start + diff;
+        Vec3 newPos  = values.start + (values.delta * t);
+        target->setPosition3D(newPos);
+        _moves.values[i].previous = newPos;
+#else
+        target->setPosition3D(values.start + values.delta * t);
+#endif  // CC_ENABLE_STACKABLE_ACTIONS
+        finishIfDone(_moves, i, finished);
+    }
+}
+
+void ActionBatch::updateScales(float dt, std::vector<Action*>& finished)
+{
+    for (size_t i = 0, count = _scales.actions.size(); i < count; ++i)
+    {
+        if (!_scales.actions[i] || _scales.paused[i])
+            continue;
+
+        float t      = stepTime(_scales, i, dt);
+        Vec3 scale   = _scales.values[i].start + _scales.values[i].delta * t;
+        Node* target = _scales.targets[i];
+        // same as ScaleTo::update()
+        target->setScaleX(scale.x);
+        target->setScaleY(scale.y);
+        target->setScaleZ(scale.z);
+        finishIfDone(_scales, i, finished);
+    }
+}
+
+void ActionBatch::updateRotations(float dt, std::vector<Action*>& finished)
+{
+    for (size_t i = 0, count = _rotations.actions.size(); i < count; ++i)
+    {
+        if (!_rotations.actions[i] || _rotations.paused[i])
+            continue;
+
+        float t            = stepTime(_rotations, i, dt);
+        const auto& values = _rotations.values[i];
+        Vec2 rotation      = values.start + values.delta * t;
+        Node* target       = _rotations.targets[i];
+        // same as RotateTo::update()
+#if CC_USE_PHYSICS
+        if (values.start.x == values.start.y && values.delta.x == values.delta.y)
+        {
+            target->setRotation(rotation.x);
+        }
+        else
+        {
+            target->setRotationSkewX(rotation.x);
+            target->setRotationSkewY(rotation.y);
+        }
+#else
+        target->setRotationSkewX(rotation.x);
+        target->setRotationSkewY(rotation.y);
+#endif  // CC_USE_PHYSICS
+        finishIfDone(_rotations, i, finished);
+    }
+}
+
+void ActionBatch::updateFades(float dt, std::vector<Action*>& finished)
+{
+    for (size_t i = 0, count = _fades.actions.size(); i < count; ++i)
+    {
+        if (!_fades.actions[i] || _fades.paused[i])
+            continue;
+
+        float t            = stepTime(_fades, i, dt);
+        const auto& values = _fades.values[i];
+        // same as FadeTo::update()
+        _fades.targets[i]->setOpacity((uint8_t)(values.from + (values.to - values.from) * t));
+        finishIfDone(_fades, i, finished);
+    }
+}
+
+void ActionBatch::updateTints(float dt, std::vector<Action*>& finished)
+{
+    for (size_t i = 0, count = _tints.actions.size(); i < count; ++i)
+    {
+        if (!_tints.actions[i] || _tints.paused[i])
+            continue;
+
+        float t          = stepTime(_tints, i, dt);
+        const auto& from = _tints.values[i].from;
+        const auto& to   = _tints.values[i].to;
+        // same as TintTo::update()
+        _tints.targets[i]->setColor(Color3B(uint8_t(from.r + (to.r - from.r) * t),
+                                            (uint8_t)(from.g + (to.g - from.g) * t),
+                                            (uint8_t)(from.b + (to.b - from.b) * t)));
+        finishIfDone(_tints, i, finished);
+    }
+}
+
+void ActionBatch::writeBack(int lane, size_t index)
+{
+    Timing& timing     = getTiming(lane);
+    auto action        = static_cast<ActionInterval*>(timing.actions[index]);
+    action->_elapsed   = timing.elapsed[index];
+    action->_firstTick = timing.firstTicks[index];
+    if (!action->_firstTick)
+    {
+        action->_done = timing.elapsed[index] >= timing.durations[index];
+    }
+
+    // the start of a stacked move follows the other actions moving the target
+    if (lane == LANE_MOVE)
+    {
+        auto move               = static_cast<MoveBy*>(timing.inners[index]);
+        move->_startPosition    = _moves.values[index].start;
+        move->_previousPosition = _moves.values[index].previous;
+    }
+}
+
+template <typename T>
+void ActionBatch::eraseValues(Lane<T>& lane, size_t index, size_t last)
+{
+    lane.values[index] = lane.values[last];
+    lane.values.pop_back();
+}
+
+void ActionBatch::erase(int lane, size_t index)
+{
+    // swap with the last action of the lane
+    Timing& timing = getTiming(lane);
+    size_t last    = timing.actions.size() - 1;
+    if (index != last && timing.actions[last])
+    {
+        timing.actions[last]->_batchSlot = (int)(index * LANE_COUNT + lane);
+    }
+
+    timing.actions[index]       = timing.actions[last];
+    timing.inners[index]        = timing.inners[last];
+    timing.targets[index]       = timing.targets[last];
+    timing.elapsed[index]       = timing.elapsed[last];
+    timing.durations[index]     = timing.durations[last];
+    timing.firstTicks[index]    = timing.firstTicks[last];
+    timing.paused[index]        = timing.paused[last];
+    timing.easeTypes[index]     = timing.easeTypes[last];
+    timing.easeRates[index]     = timing.easeRates[last];
+    timing.easeFunctions[index] = timing.easeFunctions[last];
+    timing.actions.pop_back();
+    timing.inners.pop_back();
+    timing.targets.pop_back();
+    timing.elapsed.pop_back();
+    timing.durations.pop_back();
+    timing.firstTicks.pop_back();
+    timing.paused.pop_back();
+    timing.easeTypes.pop_back();
+    timing.easeRates.pop_back();
+    timing.easeFunctions.pop_back();
+
+    switch (lane)
+    {
+    case LANE_MOVE:
+        eraseValues(_moves, index, last);
+        break;
+    case LANE_SCALE:
+        eraseValues(_scales, index, last);
+        break;
+    case LANE_ROTATE:
+        eraseValues(_rotations, index, last);
+        break;
+    case LANE_FADE:
+        eraseValues(_fades, index, last);
+        break;
+    default:
+        eraseValues(_tints, index, last);
+        break;
+    }
+}
+
+void ActionBatch::compact()
+{
+    for (int lane = 0; lane < LANE_COUNT; ++lane)
+    {
+        Timing& timing = getTiming(lane);
+        for (size_t index = timing.actions.size(); index-- > 0;)
+        {
+            if (!timing.actions[index])
+            {
+                erase(lane, index);
+            }
+        }
+    }
+    _needCompact = false;
+}
+
+NS_CC_END
@@ -0,0 +1,167 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "platform/CCPlatformMacros.h"
+#include "base/ccTypes.h"
+#include "math/Vec2.h"
+#include "math/Vec3.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @addtogroup actions
+ * @{
+ */
+NS_CC_BEGIN
+
+class Action;
+class ActionInterval;
+class Node;
+
+/**
+ * @class ActionBatch
+ * @brief Steps the common interval actions of an ActionManager in tight loops instead of through Action::step().
+ * MoveTo, MoveBy, ScaleTo, ScaleBy, 2D RotateTo, FadeTo and TintTo, bare or wrapped in one rate or tween ease action,
+ * are kept in one lane per property, as arrays of their timing and interpolation values.
+ * Subclasses of these actions are never batched, since they may override update().
+ * The elapsed time of a batched action is written back to it when it leaves the batch.
+ * @see `ActionManager::setBatchingEnabled(bool)`
+ * @js NA
+ */
+class CC_DLL ActionBatch
+{
+public:
+    /** Adds a started action, returns false when it isn't one of the batched types. */
+    bool add(Action* action, bool paused);
+
+    /** Removes an action and writes back its state, so that it can be stepped again. */
+    void remove(Action* action);
+
+    void setPaused(Action* action, bool paused);
+
+    /** Steps the unpaused actions, the ones that are done are retained and appended to finished. */
+    void update(float dt, std::vector<Action*>& finished);
+
+    size_t size() const { return _size; }
+
+protected:
+    enum LaneType
+    {
+        LANE_MOVE,
+        LANE_SCALE,
+        LANE_ROTATE,
+        LANE_FADE,
+        LANE_TINT,
+        LANE_COUNT
+    };
+
+    enum EaseType : uint8_t
+    {
+        EASE_NONE,
+        EASE_IN,
+        EASE_OUT,
+        EASE_IN_OUT,
+        EASE_FUNCTION
+    };
+
+    struct MoveValues
+    {
+        Vec3 start;
+        Vec3 delta;
+        Vec3 previous;
+    };
+    struct ScaleValues
+    {
+        Vec3 start;
+        Vec3 delta;
+    };
+    struct RotateValues
+    {
+        Vec2 start;
+        Vec2 delta;
+    };
+    struct FadeValues
+    {
+        float from;
+        float to;
+    };
+    struct TintValues
+    {
+        Color3B from;
+        Color3B to;
+    };
+
+    /** The timing of a lane, one element per action. */
+    struct Timing
+    {
+        std::vector<Action*> actions;         // nullptr when removed during update()
+        std::vector<ActionInterval*> inners;  // the action holding the interpolated values
+        std::vector<Node*> targets;
+        std::vector<float> elapsed;
+        std::vector<float> durations;
+        std::vector<uint8_t> firstTicks;
+        std::vector<uint8_t> paused;
+        std::vector<uint8_t> easeTypes;
+        std::vector<float> easeRates;
+        std::vector<float (*)(float)> easeFunctions;
+    };
+
+    template <typename T>
+    struct Lane : Timing
+    {
+        std::vector<T> values;
+    };
+
+    Timing& getTiming(int lane);
+    float stepTime(Timing& timing, size_t index, float dt);
+    void finishIfDone(Timing& timing, size_t index, std::vector<Action*>& finished);
+    void writeBack(int lane, size_t index);
+    void erase(int lane, size_t index);
+    void compact();
+
+    template <typename T>
+    void eraseValues(Lane<T>& lane, size_t index, size_t last);
+
+    void updateMoves(float dt, std::vector<Action*>& finished);
+    void updateScales(float dt, std::vector<Action*>& finished);
+    void updateRotations(float dt, std::vector<Action*>& finished);
+    void updateFades(float dt, std::vector<Action*>& finished);
+    void updateTints(float dt, std::vector<Action*>& finished);
+
+    Lane<MoveValues> _moves;
+    Lane<ScaleValues> _scales;
+    Lane<RotateValues> _rotations;
+    Lane<FadeValues> _fades;
+    Lane<TintValues> _tints;
+    size_t _size      = 0;
+    bool _updating    = false;
+    bool _needCompact = false;
+};
+
+NS_CC_END
+
+// end of actions group
+/// @}
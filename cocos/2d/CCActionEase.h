@@ -73,6 +73,7 @@ public:
 protected:
     /** The inner action */
     ActionInterval* _inner;
+    friend class ActionBatch;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ActionEase);
@@ -111,6 +112,7 @@ public:
 
 protected:
     float _rate;
+    friend class ActionBatch;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(EaseRateAction);
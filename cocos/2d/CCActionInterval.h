@@ -117,6 +117,7 @@ protected:
     float _elapsed;
     bool _firstTick;
     bool _done;
+    friend class ActionBatch;
 
 protected:
     bool sendUpdateEventToScript(float dt, Action* actionObject);
@@ -458,6 +459,7 @@ protected:
     Vec3 _dstAngle;
     Vec3 _startAngle;
     Vec3 _diffAngle;
+    friend class ActionBatch;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateTo);
@@ -578,6 +580,7 @@ protected:
     Vec3 _positionDelta;
     Vec3 _startPosition;
     Vec3 _previousPosition;
+    friend class ActionBatch;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MoveBy);
@@ -1064,6 +1067,7 @@ protected:
     float _deltaX;
     float _deltaY;
     float _deltaZ;
+    friend class ActionBatch;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ScaleTo);
@@ -1201,6 +1205,7 @@ protected:
     uint8_t _fromOpacity;
     friend class FadeOut;
     friend class FadeIn;
+    friend class ActionBatch;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FadeTo);
@@ -1318,6 +1323,7 @@ public:
 protected:
     Color3B _to;
     Color3B _from;
+    friend class ActionBatch;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(TintTo);
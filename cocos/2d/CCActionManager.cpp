@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "2d/CCActionManager.h"
 #include "2d/CCNode.h"
 #include "2d/CCAction.h"
+#include "2d/CCActionBatch.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/ccCArray.h"
@@ -47,22 +48,30 @@ typedef struct _hashElement
     Action* currentAction;
     bool currentActionSalvaged;
     bool paused;
+    int batchedCount;  // actions stepped by the ActionBatch
     UT_hash_handle hh;
 } tHashElement;
 
-ActionManager::ActionManager() : _targets(nullptr), _currentTarget(nullptr), _currentTargetSalvaged(false) {}
+ActionManager::ActionManager()
+    : _targets(nullptr)
+    , _currentTarget(nullptr)
+    , _currentTargetSalvaged(false)
+    , _batch(nullptr)
+{}
 
 ActionManager::~ActionManager()
 {
     CCLOGINFO("deallocing ActionManager: %p", this);
 
     removeAllActions();
+    CC_SAFE_DELETE(_batch);
 }
 
 // private
 
 void ActionManager::deleteHashElement(tHashElement* element)
 {
+    unbatchActions(element);
     ccArrayFree(element->actions);
     HASH_DEL(_targets, element);
     element->target->release();
@@ -92,6 +101,12 @@ void ActionManager::removeActionAtIndex(ssize_t index, tHashElement* element)
         element->currentActionSalvaged = true;
     }
 
+    if (action->_batchSlot >= 0)
+    {
+        _batch->remove(action);
+        --element->batchedCount;
+    }
+
     ccArrayRemoveObjectAtIndex(element->actions, index, true);
 
     // update actionIndex in case we are in tick. looping over the actions
@@ -121,7 +136,7 @@ void ActionManager::pauseTarget(Node* target)
     HASH_FIND_PTR(_targets, &target, element);
     if (element)
     {
-        element->paused = true;
+        setElementPaused(element, true);
     }
 }
 
@@ -131,7 +146,7 @@ void ActionManager::resumeTarget(Node* target)
     HASH_FIND_PTR(_targets, &target, element);
     if (element)
     {
-        element->paused = false;
+        setElementPaused(element, false);
     }
 }
 
@@ -143,7 +158,7 @@ Vector<Node*> ActionManager::pauseAllRunningActions()
     {
         if (!element->paused)
         {
-            element->paused = true;
+            setElementPaused(element, true);
             idsWithActions.pushBack(element->target);
         }
     }
@@ -159,6 +174,70 @@ void ActionManager::resumeTargets(const Vector<Node*>& targetsToResume)
     }
 }
 
+void ActionManager::setElementPaused(tHashElement* element, bool paused)
+{
+    element->paused = paused;
+    for (int i = 0; element->batchedCount > 0 && i < element->actions->num; ++i)
+    {
+        Action* action = static_cast<Action*>(element->actions->arr[i]);
+        if (action->_batchSlot >= 0)
+        {
+            _batch->setPaused(action, paused);
+        }
+    }
+}
+
+// batching
+
+void ActionManager::setBatchingEnabled(bool enabled)
+{
+    if (enabled == (_batch != nullptr))
+    {
+        return;
+    }
+
+    if (enabled)
+    {
+        _batch = new ActionBatch();
+    }
+
+    for (tHashElement* element = _targets; element != nullptr; element = (tHashElement*)element->hh.next)
+    {
+        if (!enabled)
+        {
+            unbatchActions(element);
+            continue;
+        }
+
+        for (int i = 0; i < element->actions->num; ++i)
+        {
+            Action* action = static_cast<Action*>(element->actions->arr[i]);
+            if (action != element->currentAction && _batch->add(action, element->paused))
+            {
+                ++element->batchedCount;
+            }
+        }
+    }
+
+    if (!enabled)
+    {
+        CC_SAFE_DELETE(_batch);
+    }
+}
+
+void ActionManager::unbatchActions(tHashElement* element)
+{
+    for (int i = 0; element->batchedCount > 0 && i < element->actions->num; ++i)
+    {
+        Action* action = static_cast<Action*>(element->actions->arr[i]);
+        if (action->_batchSlot >= 0)
+        {
+            _batch->remove(action);
+            --element->batchedCount;
+        }
+    }
+}
+
 // run
 
 void ActionManager::addAction(Action* action, Node* target, bool paused)
@@ -187,6 +266,11 @@ void ActionManager::addAction(Action* action, Node* target, bool paused)
     ccArrayAppendObject(element->actions, action);
 
     action->startWithTarget(target);
+
+    if (_batch && _batch->add(action, element->paused))
+    {
+        ++element->batchedCount;
+    }
 }
 
 // remove
@@ -219,6 +303,7 @@ void ActionManager::removeAllActionsFromTarget(Node* target)
             element->currentActionSalvaged = true;
         }
 
+        unbatchActions(element);
         ccArrayRemoveAllObjects(element->actions);
         if (_currentTarget == element)
         {
@@ -428,24 +513,42 @@ ssize_t ActionManager::getNumberOfRunningActions() const
 // main loop
 void ActionManager::update(float dt)
 {
+    if (_batch && _batch->size() > 0)
+    {
+        _batch->update(dt, _finishedBatchActions);
+        for (auto action : _finishedBatchActions)
+        {
+            // the stop of a previous action may have removed this one
+            if (action->_batchSlot >= 0)
+            {
+                action->stop();
+                removeAction(action);
+            }
+            action->release();
+        }
+        _finishedBatchActions.clear();
+    }
+
     for (tHashElement* elt = _targets; elt != nullptr;)
     {
         _currentTarget         = elt;
         _currentTargetSalvaged = false;
 
-        if (!_currentTarget->paused)
+        if (!_currentTarget->paused && _currentTarget->batchedCount < _currentTarget->actions->num)
         {
             // The 'actions' MutableArray may change while inside this loop.
             for (_currentTarget->actionIndex = 0; _currentTarget->actionIndex < _currentTarget->actions->num;
                  _currentTarget->actionIndex++)
             {
-                _currentTarget->currentAction =
-                    static_cast<Action*>(_currentTarget->actions->arr[_currentTarget->actionIndex]);
-                if (_currentTarget->currentAction == nullptr)
+                Action* action = static_cast<Action*>(_currentTarget->actions->arr[_currentTarget->actionIndex]);
+                // batched actions were stepped above
+                if (action == nullptr || action->_batchSlot >= 0)
                 {
                     continue;
                 }
 
+                _currentTarget->currentAction = action;
+
                 _currentTarget->currentActionSalvaged = false;
 
                 _currentTarget->currentAction->step(dt);
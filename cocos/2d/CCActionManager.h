@@ -37,6 +37,7 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 class Action;
+class ActionBatch;
 
 struct _hashElement;
 
@@ -188,6 +189,17 @@ public:
      */
     virtual void resumeTargets(const Vector<Node*>& targetsToResume);
 
+    /** Steps MoveTo, MoveBy, ScaleTo, ScaleBy, 2D RotateTo, FadeTo and TintTo actions, bare or wrapped in one rate or
+     * tween ease action, in tight loops over their values instead of through Action::step().
+     * Batched actions run before the other actions of their target, and their elapsed time is only written back to
+     * them when they stop. Worth enabling with thousands of such actions. Disabled by default.
+     * @see ActionBatch
+     */
+    void setBatchingEnabled(bool enabled);
+
+    /** Whether the common interval actions are batched. */
+    bool isBatchingEnabled() const { return _batch != nullptr; }
+
     /** Main loop of ActionManager.
      * @param dt    In seconds.
      */
@@ -199,11 +211,15 @@ protected:
     void removeActionAtIndex(ssize_t index, struct _hashElement* element);
     void deleteHashElement(struct _hashElement* element);
     void actionAllocWithHashElement(struct _hashElement* element);
+    void setElementPaused(struct _hashElement* element, bool paused);
+    void unbatchActions(struct _hashElement* element);
 
 protected:
     struct _hashElement* _targets;
     struct _hashElement* _currentTarget;
     bool _currentTargetSalvaged;
+    ActionBatch* _batch;
+    std::vector<Action*> _finishedBatchActions;
 };
 
 // end of actions group
@@ -312,6 +312,7 @@ public:
     CameraBackgroundBrush* getBackgroundBrush() const { return _clearBrush; }
 
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
     bool isBrushValid();
 
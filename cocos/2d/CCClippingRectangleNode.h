@@ -83,6 +83,7 @@ public:
 
     // virtual void draw(Renderer* renderer, const Mat4 &transform, uint32_t flags) override;
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
 protected:
     ClippingRectangleNode() = default;
@@ -33,6 +33,7 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "base/CCMemoryTracker.h"
 
 NS_CC_BEGIN
 
@@ -90,12 +91,18 @@ FontAtlas::FontAtlas(Font* theFont) : _font(theFont)
 void FontAtlas::reinit()
 {
     if (!_currentPageData)
+    {
         _currentPageData = new uint8_t[_currentPageDataSize];
+        MemoryTracker::getInstance()->allocate(MemoryTracker::TAG_FONT_ATLAS, _currentPageDataSize);
+    }
     _currentPage = -1;
 
 #if defined(CC_USE_METAL)
     if (_strideShift && !_currentPageDataRGBA)
+    {
         _currentPageDataRGBA = new uint8_t[_currentPageDataSizeRGBA];
+        MemoryTracker::getInstance()->allocate(MemoryTracker::TAG_FONT_ATLAS, _currentPageDataSizeRGBA);
+    }
 #endif
 
     addNewPage();
@@ -115,8 +122,12 @@ FontAtlas::~FontAtlas()
     _font->release();
     releaseTextures();
 
+    if (_currentPageData)
+        MemoryTracker::getInstance()->release(MemoryTracker::TAG_FONT_ATLAS, _currentPageDataSize);
     CC_SAFE_DELETE_ARRAY(_currentPageData);
 #if defined(CC_USE_METAL)
+    if (_currentPageDataRGBA)
+        MemoryTracker::getInstance()->release(MemoryTracker::TAG_FONT_ATLAS, _currentPageDataSizeRGBA);
     CC_SAFE_DELETE_ARRAY(_currentPageDataRGBA);
 #endif
 }
@@ -336,6 +347,7 @@ void FontAtlas::updateTextureContent(backend::PixelFormat format, int startY)
 void FontAtlas::addNewPage()
 {
     auto texture = new Texture2D();
+    texture->setMemoryTag(MemoryTracker::TAG_FONT_ATLAS);
 
     memset(_currentPageData, 0, _currentPageDataSize);
 
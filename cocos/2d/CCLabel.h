@@ -692,6 +692,7 @@ public:
     virtual Rect getBoundingBox() const override;
 
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
     virtual void draw(Renderer* renderer, const Mat4& transform, uint32_t flags) override;
 
     virtual void setCameraMask(unsigned short mask, bool applyChildren = true) override;
@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include "2d/CCNode.h"
 
 #include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <string>
 #include <regex>
 
@@ -43,6 +45,7 @@ THE SOFTWARE.
 #include "2d/CCActionManager.h"
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
+#include "2d/CCSpatialIndex.h"
 #include "renderer/CCMaterial.h"
 #include "math/TransformUtils.h"
 #include "renderer/backend/ProgramStateRegistry.h"
@@ -63,8 +66,22 @@ NS_CC_BEGIN
 // FIXME:: Yes, nodes might have a sort problem once every 30 days if the game runs at 60 FPS and each frame sprites are
 // reordered.
 std::uint32_t Node::s_globalOrderOfArrival = 0;
+std::uint32_t Node::s_hierarchyVersion     = 0;
 int Node::__attachedNodeCount              = 0;
 
+namespace
+{
+// buffers of the visits culling their children, reused every frame. One per level of nested culling visits, since a
+// child culls its own children while the buffers of its parent are iterated
+struct CullingBuffers
+{
+    std::vector<Node*> children;
+    std::vector<Node*> entered;
+};
+std::vector<std::unique_ptr<CullingBuffers>> s_cullingBuffers;
+size_t s_cullingDepth = 0;
+}  // namespace
+
 // MARK: Constructor, Destructor, Init
 
 Node::Node()
@@ -88,8 +105,10 @@ Node::Node()
     , _additionalTransform(nullptr)
     , _additionalTransformDirty(false)
     , _transformUpdated(true)
+    , _modelViewPrecomputed(false)
     // children (lazy allocs)
     , _childrenIndexer(nullptr)
+    , _spatialIndex(nullptr)
     // lazy alloc
     , _localZOrder$Arrival(0LL)
     , _globalZOrder(0)
@@ -158,6 +177,7 @@ Node::~Node()
     CCLOGINFO("deallocing Node: %p - tag: %i", this, _tag);
 
     CC_SAFE_DELETE(_childrenIndexer);
+    CC_SAFE_DELETE(_spatialIndex);
 
 #if CC_ENABLE_SCRIPT_BINDING
     if (_updateScriptHandler)
@@ -256,6 +276,7 @@ void Node::setSkewX(float skewX)
 
     _skewX            = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 }
 
 float Node::getSkewY() const
@@ -270,6 +291,7 @@ void Node::setSkewY(float skewY)
 
     _skewY            = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 }
 
 void Node::setLocalZOrder(std::int32_t z)
@@ -322,6 +344,7 @@ void Node::setRotation(float rotation)
 
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 
     updateRotationQuat();
 }
@@ -337,6 +360,7 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
 
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -390,6 +414,7 @@ void Node::setRotationQuat(const Quaternion& quat)
     _rotationQuat = quat;
     updateRotation3D();
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 }
 
 Quaternion Node::getRotationQuat() const
@@ -404,6 +429,7 @@ void Node::setRotationSkewX(float rotationX)
 
     _rotationZ_X      = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 
     updateRotationQuat();
 }
@@ -420,6 +446,7 @@ void Node::setRotationSkewY(float rotationY)
 
     _rotationZ_Y      = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 
     updateRotationQuat();
 }
@@ -439,6 +466,7 @@ void Node::setScale(float scale)
 
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 }
 
 /// scaleX getter
@@ -456,6 +484,7 @@ void Node::setScale(float scaleX, float scaleY)
     _scaleX           = scaleX;
     _scaleY           = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 }
 
 /// scaleX setter
@@ -466,6 +495,7 @@ void Node::setScaleX(float scaleX)
 
     _scaleX           = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 }
 
 /// scaleY getter
@@ -482,6 +512,7 @@ void Node::setScaleZ(float scaleZ)
 
     _scaleZ           = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 }
 
 /// scaleY getter
@@ -498,6 +529,7 @@ void Node::setScaleY(float scaleY)
 
     _scaleY           = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 }
 
 /// position getter
@@ -528,6 +560,7 @@ void Node::setPosition(float x, float y)
 
     _transformUpdated = _transformDirty = _inverseDirty = true;
     _usingNormalizedPosition                            = false;
+    invalidateParentSpatialIndex();
 }
 
 void Node::setPosition3D(const Vec3& position)
@@ -572,6 +605,7 @@ void Node::setPositionZ(float positionZ)
         return;
 
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 
     _positionZ = positionZ;
 }
@@ -592,6 +626,7 @@ void Node::setPositionNormalized(const Vec2& position)
     _usingNormalizedPosition = true;
     _normalizedPositionDirty = true;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 }
 
 ssize_t Node::getChildrenCount() const
@@ -634,6 +669,7 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        invalidateParentSpatialIndex();
     }
 }
 
@@ -651,6 +687,7 @@ void Node::setContentSize(const Vec2& size)
 
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        invalidateParentSpatialIndex();
     }
 }
 
@@ -670,6 +707,17 @@ bool Node::isRunning() const
 /// parent setter
 void Node::setParent(Node* parent)
 {
+    if (_parent != parent)
+    {
+        // only running trees are flattened by a TransformSystem, a tree starting to run invalidates it
+        if ((_parent && _parent->_running) || (parent && parent->_running))
+            ++s_hierarchyVersion;
+        _modelViewPrecomputed = false;
+        if (_parent && _parent->_spatialIndex)
+            _parent->_spatialIndex->remove(this);
+        if (parent && parent->_spatialIndex)
+            parent->_spatialIndex->insert(this);
+    }
     _parent           = parent;
     _normalizedPositionDirty = true;
     _transformUpdated = _transformDirty = _inverseDirty = true;
@@ -688,6 +736,7 @@ void Node::setIgnoreAnchorPointForPosition(bool newValue)
     {
         _ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        invalidateParentSpatialIndex();
     }
 }
 
@@ -1227,20 +1276,69 @@ void Node::visit()
     visit(renderer, parentTransform, FLAGS_TRANSFORM_DIRTY);
 }
 
-uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
+void Node::collectDrawList(std::vector<DrawListEntry>& list,
+                           const Mat4& parentTransform,
+                           uint32_t parentFlags,
+                           unsigned short cameraFlags)
 {
-    if (_usingNormalizedPosition)
+    // same order as visit(), see visit()
+    if (!_visible)
+        return;
+
+    if (hasCustomVisit())
+    {
+        list.push_back({this, &parentTransform, parentFlags, true});
+        return;
+    }
+
+    uint32_t flags = processParentFlags(parentTransform, parentFlags);
+
+    const bool drawable = (_cameraMask & cameraFlags) != 0;
+
+    int i = 0;
+
+    if (!_children.empty())
     {
-        CCASSERT(_parent, "setPositionNormalized() doesn't work with orphan nodes");
-        if ((parentFlags & FLAGS_CONTENT_SIZE_DIRTY) || _normalizedPositionDirty)
+        sortAllChildren();
+        for (auto size = _children.size(); i < size; ++i)
         {
-            auto& s           = _parent->getContentSize();
-            _position.x       = _normalizedPosition.x * s.width;
-            _position.y       = _normalizedPosition.y * s.height;
-            _transformUpdated = _transformDirty = _inverseDirty = true;
-            _normalizedPositionDirty                            = false;
+            auto node = _children.at(i);
+
+            if (node && node->_localZOrder < 0)
+                node->collectDrawList(list, _modelViewTransform, flags, cameraFlags);
+            else
+                break;
         }
+        if (drawable)
+            list.push_back({this, &_modelViewTransform, flags, false});
+
+        for (auto it = _children.cbegin() + i, itCend = _children.cend(); it != itCend; ++it)
+            (*it)->collectDrawList(list, _modelViewTransform, flags, cameraFlags);
     }
+    else if (drawable)
+    {
+        list.push_back({this, &_modelViewTransform, flags, false});
+    }
+}
+
+void Node::updateNormalizedPosition(uint32_t parentFlags)
+{
+    CCASSERT(_parent, "setPositionNormalized() doesn't work with orphan nodes");
+    if ((parentFlags & FLAGS_CONTENT_SIZE_DIRTY) || _normalizedPositionDirty)
+    {
+        auto& s           = _parent->getContentSize();
+        _position.x       = _normalizedPosition.x * s.width;
+        _position.y       = _normalizedPosition.y * s.height;
+        _transformUpdated = _transformDirty = _inverseDirty = true;
+        _normalizedPositionDirty                            = false;
+        invalidateParentSpatialIndex();
+    }
+}
+
+uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
+{
+    if (_usingNormalizedPosition)
+        updateNormalizedPosition(parentFlags);
 
     // Fixes Github issue #16100. Basically when having two cameras, one camera might set as dirty the
     // node that is not visited by it, and might affect certain calculations. Besides, it is faster to do this.
@@ -1251,11 +1349,13 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     flags |= (_transformUpdated ? FLAGS_TRANSFORM_DIRTY : 0);
     flags |= (_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
 
-    if (flags & FLAGS_DIRTY_MASK)
+    // the transform pass of the scene may have computed it for this frame already
+    if ((flags & FLAGS_DIRTY_MASK) && !_modelViewPrecomputed)
         _modelViewTransform = this->transform(parentTransform);
 
-    _transformUpdated = false;
-    _contentSizeDirty = false;
+    _transformUpdated     = false;
+    _contentSizeDirty     = false;
+    _modelViewPrecomputed = false;
 
     return flags;
 }
@@ -1267,6 +1367,74 @@ bool Node::isVisitableByVisitingCamera() const
     return visibleByCamera;
 }
 
+void Node::setSpatialIndexEnabled(bool enabled, float cellSize, float margin)
+{
+    CC_SAFE_DELETE(_spatialIndex);
+    if (!enabled)
+        return;
+
+    _spatialIndex = new SpatialIndex(cellSize, margin);
+    for (const auto& child : _children)
+        _spatialIndex->insert(child);
+}
+
+void Node::invalidateParentSpatialIndex()
+{
+    if (_parent && _parent->_spatialIndex)
+        _parent->_spatialIndex->invalidate(this);
+}
+
+bool Node::getChildrenInView(std::vector<Node*>& children, std::vector<Node*>& entered)
+{
+    if (!Camera::getVisitingCamera())
+        return false;
+
+    // the plane z = 0 of this node maps to the clip space through a homography, the rows x, y and w of the MVP
+    const Mat4 mvp = _director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION) * _modelViewTransform;
+    const float* m = mvp.m;
+    const float a  = m[0], b = m[4], c = m[12];
+    const float d  = m[1], e = m[5], f = m[13];
+    const float g  = m[3], h = m[7], k = m[15];
+
+    const float i0 = e * k - f * h, i1 = c * h - b * k, i2 = b * f - c * e;
+    const float i3 = f * g - d * k, i4 = a * k - c * g, i5 = c * d - a * f;
+    const float i6 = d * h - e * g, i7 = b * g - a * h, i8 = a * e - b * d;
+    const float det = a * i0 + b * i3 + c * i6;
+    if (det == 0.0f)
+        return false;
+
+    // unproject the corners of the viewport onto the plane
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (int corner = 0; corner < 4; ++corner)
+    {
+        const float x  = (corner & 1) ? 1.0f : -1.0f;
+        const float y  = (corner & 2) ? 1.0f : -1.0f;
+        const float w  = i6 * x + i7 * y + i8;
+        const float px = (i0 * x + i1 * y + i2) / w;
+        const float py = (i3 * x + i4 * y + i5) / w;
+        // the horizon is in view, the viewport doesn't map to a bounded area
+        if (!std::isfinite(px) || !std::isfinite(py) || g * px + h * py + k <= 0.0f)
+            return false;
+        minX = std::min(minX, px);
+        maxX = std::max(maxX, px);
+        minY = std::min(minY, py);
+        maxY = std::max(maxY, py);
+    }
+
+    const auto& found = _spatialIndex->query(Rect(minX, minY, maxX - minX, maxY - minY), entered);
+
+    // the transform of a culled child isn't updated when this node moves
+    for (auto child : entered)
+        child->_transformUpdated = true;
+
+    children.assign(found.begin(), found.end());
+    std::sort(children.begin(), children.end(), [](Node* n1, Node* n2) {
+        return (n1->_localZOrder == n2->_localZOrder && n1->_orderOfArrival < n2->_orderOfArrival) ||
+               n1->_localZOrder < n2->_localZOrder;
+    });
+    return true;
+}
+
 void Node::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags)
 {
     // quick return if not visible. children won't be drawn.
@@ -1287,7 +1455,41 @@ void Node::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t paren
 
     int i = 0;
 
-    if (!_children.empty())
+    CullingBuffers* culling = nullptr;
+    // children positioned relative to the content size are only moved when visited
+    if (_spatialIndex && !_children.empty() && !(flags & FLAGS_CONTENT_SIZE_DIRTY))
+    {
+        if (s_cullingDepth == s_cullingBuffers.size())
+            s_cullingBuffers.emplace_back(std::make_unique<CullingBuffers>());
+        culling = s_cullingBuffers[s_cullingDepth].get();
+        if (getChildrenInView(culling->children, culling->entered))
+            ++s_cullingDepth;
+        else
+            culling = nullptr;
+    }
+
+    if (culling)
+    {
+        const auto& childrenInView = culling->children;
+        // same as below, for the children in view only
+        for (auto size = static_cast<int>(childrenInView.size()); i < size; ++i)
+        {
+            auto node = childrenInView[i];
+
+            if (node->_localZOrder < 0)
+                node->visit(renderer, _modelViewTransform, flags);
+            else
+                break;
+        }
+        if (visibleByCamera)
+            this->draw(renderer, _modelViewTransform, flags);
+
+        for (auto it = childrenInView.cbegin() + i, itCend = childrenInView.cend(); it != itCend; ++it)
+            (*it)->visit(renderer, _modelViewTransform, flags);
+
+        --s_cullingDepth;
+    }
+    else if (!_children.empty())
     {
         sortAllChildren();
         // draw children zOrder < 0
@@ -1801,6 +2003,7 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform        = transform;
     _transformDirty   = false;
     _transformUpdated = true;
+    invalidateParentSpatialIndex();
 
     if (_additionalTransform)
         // _additionalTransform[1] has a copy of lastest transform
@@ -1836,6 +2039,7 @@ void Node::setAdditionalTransform(const Mat4* additionalTransform)
         _additionalTransform[0] = *additionalTransform;
     }
     _transformUpdated = _additionalTransformDirty = _inverseDirty = true;
+    invalidateParentSpatialIndex();
 }
 
 void Node::setAdditionalTransform(const Mat4& additionalTransform)
@@ -48,6 +48,7 @@
 NS_CC_BEGIN
 
 class GridBase;
+class SpatialIndex;
 class Touch;
 class Action;
 class LabelProtocol;
@@ -941,6 +942,19 @@ public:
      */
     virtual void sortAllChildren();
 
+    /**
+     * Enables/disables a spatial index of the children, which lets visit() skip the children outside of the
+     * viewport along with their subtree.
+     * A child is tested with its own content box only, so use it for containers of many children which don't draw
+     * outside of their content size, like a large scrolling layer of sprites, or give a margin.
+     *
+     * @param enabled Whether to index the children.
+     * @param cellSize Size of a cell of the index, in points of the space of this node.
+     * @param margin Added to every side of the content box of the children.
+     */
+    void setSpatialIndexEnabled(bool enabled, float cellSize = 256.0f, float margin = 0.0f);
+    bool isSpatialIndexEnabled() const { return _spatialIndex != nullptr; }
+
     /**
      * Sorts helper function
      *
@@ -1141,6 +1155,38 @@ public:
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit() final;
 
+    /**
+     * Returns whether the class overrides visit(Renderer*, const Mat4&, uint32_t).
+     * When a Scene shares one traversal between its cameras, such a node is not flattened into the draw list
+     * and its visit() is called again for every camera, so subclasses overriding visit() must override this too.
+     *
+     * @see `Scene::setSharedCameraTraversal(bool)`
+     */
+    virtual bool hasCustomVisit() const { return false; }
+
+    /** An entry of the draw list built by collectDrawList(). */
+    struct DrawListEntry
+    {
+        Node* node;
+        const Mat4* transform;  // model view of the node, or of its parent for a visit entry
+        uint32_t flags;
+        bool visit;  // call node->visit() instead of node->draw()
+    };
+
+    /**
+     * Flattens the visible subtree into draw list entries in visit order, computing transforms once.
+     * Nodes which can't be drawn by any of the given camera flags are skipped, their children are not.
+     *
+     * @param list The list entries are appended to.
+     * @param parentTransform A transform matrix.
+     * @param parentFlags Renderer flag.
+     * @param cameraFlags Union of the flags of the cameras the list is drawn for.
+     */
+    void collectDrawList(std::vector<DrawListEntry>& list,
+                         const Mat4& parentTransform,
+                         uint32_t parentFlags,
+                         unsigned short cameraFlags);
+
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
      This function recursively calls parent->getScene() until parent is a Scene object. The results are not cached. It
@@ -1863,6 +1909,7 @@ protected:
 
     Mat4 transform(const Mat4& parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
+    void updateNormalizedPosition(uint32_t parentFlags);
 
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
@@ -1876,6 +1923,11 @@ protected:
     // check whether this camera mask is visible by the current visiting camera
     bool isVisitableByVisitingCamera() const;
 
+    // tells the spatial index of the parent that the bounds of this node changed
+    void invalidateParentSpatialIndex();
+    // the children the spatial index finds in the viewport, in drawing order, false if it can't tell
+    bool getChildrenInView(std::vector<Node*>& children, std::vector<Node*>& entered);
+
     // update quaternion from Rotation3D
     void updateRotationQuat();
     // update Rotation3D from quaternion
@@ -1947,9 +1999,11 @@ protected:
     float _globalZOrder;  ///< Global order used to sort the node
 
     static std::uint32_t s_globalOrderOfArrival;
+    static std::uint32_t s_hierarchyVersion;  ///< changes whenever a node is added to or removed from a running node
 
     Vector<Node*> _children;             ///< array of children nodes
     NodeIndexerMap_t* _childrenIndexer;  ///< The children indexer for fast find child
+    SpatialIndex* _spatialIndex;         ///< Optional index of the bounds of the children, for culling
     Node* _parent;                       ///< weak reference to parent node
     Director* _director;                 // cached director pointer to improve rendering performance
     int _tag;                            ///< a tag. Can be any number you assigned just to identify this node
@@ -1981,6 +2035,7 @@ protected:
     mutable bool _inverseDirty;              ///< inverse transform dirty flag
     mutable bool _additionalTransformDirty;  ///< transform dirty ?
     bool _transformUpdated;                  ///< Whether or not the Transform object was updated since the last frame
+    bool _modelViewPrecomputed;              ///< _modelViewTransform was updated by a TransformSystem for this visit
 
     bool _usingNormalizedPosition;
     bool _normalizedPositionDirty;
@@ -2031,6 +2086,8 @@ public:
 
     static int __attachedNodeCount;
 
+    friend class TransformSystem;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
 };
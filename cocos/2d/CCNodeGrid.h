@@ -87,6 +87,7 @@ public:
 
     // overrides
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
     NodeGrid();
     virtual ~NodeGrid();
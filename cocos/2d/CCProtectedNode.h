@@ -150,6 +150,7 @@ public:
      * @js NA
      */
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
     virtual void cleanup() override;
 
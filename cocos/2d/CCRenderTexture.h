@@ -93,6 +93,7 @@ public:
 
     // Overrides
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
     virtual void draw(Renderer* renderer, const Mat4& transform, uint32_t flags) override;
 
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "2d/CCScene.h"
 #include "base/CCDirector.h"
 #include "2d/CCCamera.h"
+#include "2d/CCTransformSystem.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/ccUTF8.h"
@@ -74,6 +75,8 @@ Scene::~Scene()
     _director->getEventDispatcher()->removeEventListener(_event);
     CC_SAFE_RELEASE(_event);
 
+    CC_SAFE_DELETE(_transformSystem);
+
 #if CC_USE_PHYSICS
     delete _physicsWorld;
 #endif
@@ -184,6 +187,32 @@ void Scene::render(Renderer* renderer, const Mat4& eyeTransform, const Mat4* eye
     Camera* defaultCamera = nullptr;
     const auto& transform = getNodeToParentTransform();
 
+    if (_transformSystem)
+        _transformSystem->update(this, transform);
+
+    // traverse once for all visible cameras, each of them draws from the list
+    bool shared = false;
+    if (_sharedCameraTraversal)
+    {
+        unsigned short cameraFlags = 0;
+        int visibleCameras         = 0;
+        for (const auto& camera : getCameras())
+        {
+            if (camera->isVisible())
+            {
+                cameraFlags |= (unsigned short)camera->getCameraFlag();
+                ++visibleCameras;
+            }
+        }
+        shared = visibleCameras > 1;
+        if (shared)
+        {
+            _drawList.clear();
+            Camera::_visitingCamera = nullptr;
+            collectDrawList(_drawList, transform, 0, cameraFlags);
+        }
+    }
+
     for (const auto& camera : getCameras())
     {
         if (!camera->isVisible())
@@ -214,7 +243,10 @@ void Scene::render(Renderer* renderer, const Mat4& eyeTransform, const Mat4* eye
         // clear background with max depth
         camera->clearBackground();
         // visit the scene
-        visit(renderer, transform, 0);
+        if (shared)
+            drawList(renderer, camera);
+        else
+            visit(renderer, transform, 0);
 #if CC_USE_NAVMESH
         if (_navMesh && _navMeshDebugCamera == camera)
         {
@@ -258,6 +290,42 @@ void Scene::render(Renderer* renderer, const Mat4& eyeTransform, const Mat4* eye
     Camera::_visitingCamera = nullptr;
 }
 
+void Scene::setTransformSystemEnabled(bool enabled, int threads)
+{
+    CC_SAFE_DELETE(_transformSystem);
+    if (enabled)
+        _transformSystem = new TransformSystem(threads);
+}
+
+void Scene::onEnter()
+{
+    // nodes added or removed while the scene wasn't running didn't change the hierarchy version
+    if (_transformSystem)
+        _transformSystem->invalidate();
+    Node::onEnter();
+}
+
+void Scene::drawList(Renderer* renderer, Camera* camera)
+{
+    const auto cameraFlag = (unsigned short)camera->getCameraFlag();
+
+    // the model view stack is still filled for nodes relying on it, as visit() does
+    _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    for (const auto& entry : _drawList)
+    {
+        if (entry.visit)
+        {
+            entry.node->visit(renderer, *entry.transform, entry.flags);
+        }
+        else if (entry.node->getCameraMask() & cameraFlag)
+        {
+            _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, *entry.transform);
+            entry.node->draw(renderer, *entry.transform, entry.flags);
+        }
+    }
+    _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+}
+
 void Scene::removeAllChildren()
 {
     if (_defaultCamera)
@@ -40,6 +40,7 @@ class BaseLight;
 class Renderer;
 class EventListenerCustom;
 class EventCustom;
+class TransformSystem;
 #if CC_USE_PHYSICS
 class PhysicsWorld;
 #endif
@@ -115,8 +116,28 @@ public:
      */
     virtual void render(Renderer* renderer, const Mat4& eyeTransform, const Mat4* eyeProjection = nullptr);
 
+    /**
+     * Enable/disable sharing one traversal of the scene between the visible cameras.
+     * The tree is traversed and its transforms are computed once per frame, then every camera draws
+     * the nodes matching its flag from the resulting draw list, in the same order as a visit would.
+     * Nodes overriding visit() are still visited once per camera. Disabled by default.
+     * @see `Node::hasCustomVisit()`
+     */
+    void setSharedCameraTraversal(bool enabled) { _sharedCameraTraversal = enabled; }
+    bool isSharedCameraTraversal() const { return _sharedCameraTraversal; }
+
+    /**
+     * Enable/disable updating the transforms of the scene in one linear pass before it's visited.
+     * @param enabled Whether to use a TransformSystem.
+     * @param threads Number of threads updating the nodes of a same depth, including the render thread.
+     * @see `TransformSystem`
+     */
+    void setTransformSystemEnabled(bool enabled, int threads = 1);
+    bool isTransformSystemEnabled() const { return _transformSystem != nullptr; }
+
     /** override function */
     virtual void removeAllChildren() override;
+    virtual void onEnter() override;
 
     Scene();
     virtual ~Scene();
@@ -150,7 +171,14 @@ protected:
 
     std::vector<BaseLight*> _lights;
 
+    bool _sharedCameraTraversal = false;
+    std::vector<Node::DrawListEntry> _drawList;
+
+    TransformSystem* _transformSystem = nullptr;
+
 private:
+    void drawList(Renderer* renderer, Camera* camera);
+
     CC_DISALLOW_COPY_AND_ASSIGN(Scene);
 
 #if (CC_USE_PHYSICS || (CC_USE_3D_PHYSICS && CC_ENABLE_BULLET_INTEGRATION))
@@ -0,0 +1,208 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCSpatialIndex.h"
+#include "2d/CCNode.h"
+#include "math/CCAffineTransform.h"
+
+#include <algorithm>
+#include <cmath>
+
+NS_CC_BEGIN
+
+SpatialIndex::SpatialIndex(float cellSize, float margin) : _cellSize(std::max(cellSize, 1.0f)), _margin(margin) {}
+
+void SpatialIndex::insert(Node* child)
+{
+    _entries.emplace(child, Entry{child, 0, 0, -1, -1, false, false, 0});
+    invalidate(child);
+}
+
+void SpatialIndex::remove(Node* child)
+{
+    auto it = _entries.find(child);
+    if (it == _entries.end())
+        return;
+
+    auto entry = &it->second;
+    unlink(*entry);
+    if (entry->dirty)
+        _dirty.erase(std::find(_dirty.begin(), _dirty.end(), entry));
+    _entries.erase(it);
+}
+
+void SpatialIndex::invalidate(Node* child)
+{
+    auto it = _entries.find(child);
+    if (it == _entries.end() || it->second.dirty)
+        return;
+
+    it->second.dirty = true;
+    _dirty.push_back(&it->second);
+}
+
+void SpatialIndex::clear()
+{
+    _entries.clear();
+    _cells.clear();
+    _oversized.clear();
+    _dirty.clear();
+    _result.clear();
+}
+
+const std::vector<Node*>& SpatialIndex::query(const Rect& rect, std::vector<Node*>& entered)
+{
+    for (auto entry : _dirty)
+        update(*entry);
+    _dirty.clear();
+
+    _result.clear();
+    entered.clear();
+    // marks tell whether a child spanning several cells was already returned, and whether it was in the last query
+    if (++_queryMark <= 1)
+    {
+        for (auto&& it : _entries)
+            it.second.queryMark = 0;
+        _queryMark = 2;
+    }
+
+    for (auto entry : _oversized)
+        collect(*entry, entered);
+
+    const int minX = cellOf(rect.getMinX());
+    const int maxX = cellOf(rect.getMaxX());
+    const int minY = cellOf(rect.getMinY());
+    const int maxY = cellOf(rect.getMaxY());
+
+    // a large query is cheaper on the entries than on the cells
+    if ((int64_t)(maxX - minX + 1) * (maxY - minY + 1) > (int64_t)_cells.size())
+    {
+        for (auto&& it : _entries)
+        {
+            auto& e = it.second;
+            if (!e.oversized && e.minX <= maxX && e.maxX >= minX && e.minY <= maxY && e.maxY >= minY)
+                collect(e, entered);
+        }
+        return _result;
+    }
+
+    for (int x = minX; x <= maxX; ++x)
+    {
+        for (int y = minY; y <= maxY; ++y)
+        {
+            auto cell = _cells.find(cellKey(x, y));
+            if (cell == _cells.end())
+                continue;
+            for (auto entry : cell->second)
+            {
+                if (entry->queryMark != _queryMark)
+                    collect(*entry, entered);
+            }
+        }
+    }
+    return _result;
+}
+
+void SpatialIndex::collect(Entry& entry, std::vector<Node*>& entered)
+{
+    if (entry.queryMark != _queryMark - 1)
+        entered.push_back(entry.node);
+    entry.queryMark = _queryMark;
+    _result.push_back(entry.node);
+}
+
+void SpatialIndex::update(Entry& entry)
+{
+    entry.dirty = false;
+
+    const auto& size = entry.node->getContentSize();
+    auto bounds      = RectApplyTransform(Rect(0, 0, size.width, size.height), entry.node->getNodeToParentTransform());
+
+    const int minX = cellOf(bounds.getMinX() - _margin);
+    const int maxX = cellOf(bounds.getMaxX() + _margin);
+    const int minY = cellOf(bounds.getMinY() - _margin);
+    const int maxY = cellOf(bounds.getMaxY() + _margin);
+    if (minX == entry.minX && maxX == entry.maxX && minY == entry.minY && maxY == entry.maxY)
+        return;
+
+    unlink(entry);
+    entry.minX = minX;
+    entry.maxX = maxX;
+    entry.minY = minY;
+    entry.maxY = maxY;
+
+    if ((int64_t)(maxX - minX + 1) * (maxY - minY + 1) > MAX_CELLS_PER_NODE)
+    {
+        entry.oversized = true;
+        _oversized.push_back(&entry);
+        return;
+    }
+
+    for (int x = minX; x <= maxX; ++x)
+        for (int y = minY; y <= maxY; ++y)
+            _cells[cellKey(x, y)].push_back(&entry);
+}
+
+void SpatialIndex::unlink(Entry& entry)
+{
+    if (entry.oversized)
+    {
+        _oversized.erase(std::find(_oversized.begin(), _oversized.end(), &entry));
+        entry.oversized = false;
+    }
+    else
+    {
+        for (int x = entry.minX; x <= entry.maxX; ++x)
+        {
+            for (int y = entry.minY; y <= entry.maxY; ++y)
+            {
+                auto cell = _cells.find(cellKey(x, y));
+                if (cell == _cells.end())
+                    continue;
+                auto& entries = cell->second;
+                auto it       = std::find(entries.begin(), entries.end(), &entry);
+                if (it != entries.end())
+                {
+                    *it = entries.back();
+                    entries.pop_back();
+                }
+                if (entries.empty())
+                    _cells.erase(cell);
+            }
+        }
+    }
+    entry.minX = entry.minY = 0;
+    entry.maxX = entry.maxY = -1;
+}
+
+int SpatialIndex::cellOf(float v) const
+{
+    // clamped so that huge or invalid bounds can't overflow the cell coordinates
+    const float c = std::floor(v / _cellSize);
+    if (!(c > -1e6f))
+        return -1000000;
+    return c < 1e6f ? (int)c : 1000000;
+}
+
+NS_CC_END
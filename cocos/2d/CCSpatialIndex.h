@@ -0,0 +1,104 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "platform/CCPlatformMacros.h"
+#include "math/Rect.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+NS_CC_BEGIN
+
+class Node;
+
+/**
+ * @class SpatialIndex
+ * @brief A uniform grid of the bounding boxes of the children of a node, in the space of that node.
+ * Bounds are refreshed lazily: children report transform or content size changes with `invalidate`,
+ * and the next `query` updates their cells.
+ * @see `Node::setSpatialIndexEnabled(bool)`
+ * @js NA
+ */
+class CC_DLL SpatialIndex
+{
+public:
+    /** Children spanning more cells than this are kept out of the grid and always returned by `query`. */
+    static const int MAX_CELLS_PER_NODE = 64;
+
+    /**
+     * @param cellSize Size of a cell, in points of the parent space.
+     * @param margin Added to every side of the bounding boxes, for children drawing outside of their content size.
+     */
+    explicit SpatialIndex(float cellSize = 256.0f, float margin = 0.0f);
+
+    void insert(Node* child);
+    void remove(Node* child);
+    void invalidate(Node* child);
+    void clear();
+
+    /**
+     * Returns the children whose bounds intersect rect, in no particular order.
+     * The result is valid until the next query.
+     * @param entered Set to the returned children which were not returned by the previous query.
+     */
+    const std::vector<Node*>& query(const Rect& rect, std::vector<Node*>& entered);
+
+    size_t getCount() const { return _entries.size(); }
+
+protected:
+    struct Entry
+    {
+        Node* node;
+        int minX, minY, maxX, maxY;  // covered cells, minX > maxX when not in the grid
+        bool dirty;
+        bool oversized;
+        uint32_t queryMark;  // last query which returned the entry
+    };
+
+    void update(Entry& entry);
+    void unlink(Entry& entry);
+    void collect(Entry& entry, std::vector<Node*>& entered);
+    int cellOf(float v) const;
+    static uint64_t cellKey(int x, int y) { return (uint64_t)(uint32_t)x << 32 | (uint32_t)y; }
+
+    float _cellSize;
+    float _margin;
+    uint32_t _queryMark = 0;
+    // unordered_map never moves its elements, so entries can be referenced from the cells
+    std::unordered_map<Node*, Entry> _entries;
+    std::unordered_map<uint64_t, std::vector<Entry*>> _cells;
+    std::vector<Entry*> _oversized;
+    std::vector<Entry*> _dirty;
+    std::vector<Node*> _result;
+};
+
+NS_CC_END
+// end of _2d group
+/// @}
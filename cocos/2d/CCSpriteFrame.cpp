@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "renderer/CCTextureCache.h"
 #include "2d/CCSpriteFrame.h"
 #include "base/CCDirector.h"
+#include "base/CCMemoryTracker.h"
 #include "platform/CCFileUtils.h"
 
 NS_CC_BEGIN
@@ -86,7 +87,10 @@ SpriteFrame* SpriteFrame::create(std::string_view filename,
     return nullptr;
 }
 
-SpriteFrame::SpriteFrame() : _rotated(false), _texture(nullptr) {}
+SpriteFrame::SpriteFrame() : _rotated(false), _texture(nullptr)
+{
+    MemoryTracker::getInstance()->allocate(MemoryTracker::TAG_SPRITE_FRAME, sizeof(SpriteFrame));
+}
 
 bool SpriteFrame::initWithTexture(Texture2D* texture, const Rect& rect)
 {
@@ -154,6 +158,7 @@ SpriteFrame::~SpriteFrame()
 {
     CCLOGINFO("deallocing SpriteFrame: %p", this);
     CC_SAFE_RELEASE(_texture);
+    MemoryTracker::getInstance()->release(MemoryTracker::TAG_SPRITE_FRAME, sizeof(SpriteFrame));
 }
 
 SpriteFrame* SpriteFrame::clone() const
@@ -222,6 +222,7 @@ public:
     virtual bool isSecureTextEntry() const;
 
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
     virtual void update(float delta) override;
 
@@ -0,0 +1,147 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCTransformSystem.h"
+#include "2d/CCNode.h"
+#include "base/CCWorkerPool.h"
+
+NS_CC_BEGIN
+
+TransformSystem::TransformSystem(int threads)
+{
+    if (threads > 1)
+        _workerPool = new WorkerPool(threads - 1);
+}
+
+TransformSystem::~TransformSystem()
+{
+    CC_SAFE_DELETE(_workerPool);
+}
+
+void TransformSystem::rebuild(Node* root)
+{
+    _nodes.clear();
+    _parents.clear();
+    _depthStarts.clear();
+
+    _root    = root;
+    _version = Node::s_hierarchyVersion;
+    if (root->hasCustomVisit())
+        return;
+
+    _nodes.push_back(root);
+    _parents.push_back(-1);
+    size_t depthStart = 0;
+    while (depthStart < _nodes.size())
+    {
+        const size_t depthEnd = _nodes.size();
+        _depthStarts.push_back(depthStart);
+        for (size_t i = depthStart; i < depthEnd; ++i)
+        {
+            for (const auto& child : _nodes[i]->_children)
+            {
+                if (child->hasCustomVisit())
+                    continue;
+                _nodes.push_back(child);
+                _parents.push_back((int)i);
+            }
+        }
+        depthStart = depthEnd;
+    }
+    _depthStarts.push_back(_nodes.size());
+
+    _world.resize(_nodes.size());
+    _flags.resize(_nodes.size());
+    _hidden.resize(_nodes.size());
+}
+
+void TransformSystem::update(Node* root, const Mat4& rootTransform)
+{
+    if (root != _root || _version != Node::s_hierarchyVersion)
+        rebuild(root);
+
+    _rootTransform = &rootTransform;
+    for (size_t depth = 0; depth + 1 < _depthStarts.size(); ++depth)
+    {
+        const size_t begin = _depthStarts[depth];
+        const size_t end   = _depthStarts[depth + 1];
+        if (_workerPool && end - begin >= PARALLEL_MIN_NODES)
+        {
+            // normalized positions may touch the spatial index of the parent, which isn't thread safe
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto node = _nodes[i];
+                if (node->_usingNormalizedPosition && node->_visible && !_hidden[_parents[i]])
+                    node->updateNormalizedPosition(_flags[_parents[i]]);
+            }
+            _workerPool->parallelFor(end - begin, PARALLEL_GRAIN, [this, begin](size_t first, size_t last) {
+                updateRange(begin + first, begin + last, false);
+            });
+        }
+        else
+        {
+            updateRange(begin, end, true);
+        }
+    }
+}
+
+void TransformSystem::updateRange(size_t begin, size_t end, bool normalizedPositions)
+{
+    // same as Node::processParentFlags(), ignoring the camera mask since the transforms don't depend on it
+    for (size_t i = begin; i < end; ++i)
+    {
+        const auto node   = _nodes[i];
+        const int parent  = _parents[i];
+        const bool hidden = !node->_visible || (parent >= 0 && _hidden[parent]);
+        _hidden[i]        = hidden;
+        if (hidden)
+        {
+            node->_modelViewPrecomputed = false;
+            continue;
+        }
+
+        const uint32_t parentFlags = parent >= 0 ? _flags[parent] : 0;
+        if (normalizedPositions && node->_usingNormalizedPosition)
+            node->updateNormalizedPosition(parentFlags);
+
+        uint32_t flags = parentFlags;
+        flags |= (node->_transformUpdated ? Node::FLAGS_TRANSFORM_DIRTY : 0);
+        flags |= (node->_contentSizeDirty ? Node::FLAGS_CONTENT_SIZE_DIRTY : 0);
+        _flags[i] = flags;
+
+        if (flags & Node::FLAGS_DIRTY_MASK)
+        {
+            _world[i] = node->transform(parent >= 0 ? _world[parent] : *_rootTransform);
+            node->_modelViewTransform   = _world[i];
+            node->_modelViewPrecomputed = true;
+        }
+        else
+        {
+            _world[i]                   = node->_modelViewTransform;
+            node->_modelViewPrecomputed = false;
+        }
+    }
+}
+
+NS_CC_END
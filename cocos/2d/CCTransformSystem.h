@@ -0,0 +1,99 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "platform/CCPlatformMacros.h"
+#include "math/Mat4.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+NS_CC_BEGIN
+
+class Node;
+class WorkerPool;
+
+/**
+ * @class TransformSystem
+ * @brief Updates the model view transforms of a node tree in one linear pass before it is visited.
+ * The tree is flattened breadth first, so every depth is a contiguous range of the arrays and parents are
+ * always updated before their children. The flattening is cached until a node is added to or removed from a running
+ * node, changes to a tree which isn't running need invalidate() once it runs again.
+ * The subtrees of nodes overriding visit() are left to visit(), since it may change their transforms.
+ * @see `Scene::setTransformSystemEnabled(bool, int)`
+ * @js NA
+ */
+class CC_DLL TransformSystem
+{
+public:
+    /** Depths with fewer nodes than this are always updated on the calling thread. */
+    static const int PARALLEL_MIN_NODES = 4096;
+    /** The number of nodes a worker takes at a time. */
+    static const int PARALLEL_GRAIN = 256;
+
+    /**
+     * @param threads Number of threads updating a depth, including the calling thread.
+     */
+    explicit TransformSystem(int threads = 1);
+    ~TransformSystem();
+
+    /**
+     * Computes the model view transforms of the dirty nodes under root, the same ones
+     * root->visit(renderer, rootTransform, 0) would compute, and marks them so that visit() doesn't do it again.
+     */
+    void update(Node* root, const Mat4& rootTransform);
+
+    /** Flattens the tree again on the next update. */
+    void invalidate() { _root = nullptr; }
+
+    /** Returns the number of nodes in the flattened tree. */
+    size_t getCount() const { return _nodes.size(); }
+
+protected:
+    void rebuild(Node* root);
+    void updateRange(size_t begin, size_t end, bool normalizedPositions);
+
+    // flattened tree, breadth first
+    std::vector<Node*> _nodes;
+    std::vector<int> _parents;  // index in _nodes, -1 for the root
+    std::vector<size_t> _depthStarts;
+
+    // per frame state
+    std::vector<Mat4> _world;
+    std::vector<uint32_t> _flags;
+    std::vector<uint8_t> _hidden;
+    const Mat4* _rootTransform = nullptr;
+
+    Node* _root             = nullptr;
+    std::uint32_t _version  = 0;
+    WorkerPool* _workerPool = nullptr;
+};
+
+NS_CC_END
+// end of _2d group
+/// @}
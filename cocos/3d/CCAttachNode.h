@@ -58,6 +58,7 @@ public:
     virtual Mat4 getNodeToWorldTransform() const override;
     virtual const Mat4& getNodeToParentTransform() const override;
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
     AttachNode();
     virtual ~AttachNode();
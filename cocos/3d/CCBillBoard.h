@@ -94,6 +94,7 @@ public:
 
     /** update billboard's transform and turn it towards camera */
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
     /**
      * draw BillBoard object.
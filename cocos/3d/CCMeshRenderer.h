@@ -231,6 +231,7 @@ public:
      * setForce2DQueue()
      */
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
     /** generate default material. */
     void genMaterial(bool useLight = false);
@@ -34,6 +34,8 @@
 #include <thread>
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCFrameProfiler.h"
+#include "base/CCMemoryTracker.h"
 
 #include "audio/AudioDecoderManager.h"
 #include "audio/AudioDecoder.h"
@@ -65,6 +67,7 @@ AudioCache::AudioCache()
     , _duration(0.0f)
     , _alBufferId(INVALID_AL_BUFFER_ID)
     , _queBufferFrames(0)
+    , _memorySize(0)
     , _state(State::INITIAL)
     , _isDestroyed(std::make_shared<bool>(false))
     , _id(++__idIndex)
@@ -117,6 +120,7 @@ AudioCache::~AudioCache()
             free(_queBuffers[index]);
         }
     }
+    MemoryTracker::getInstance()->release(MemoryTracker::TAG_AUDIO, _memorySize);
     ALOGVV("~AudioCache() %p, id=%u, end", this, _id);
     _readDataTaskMutex.unlock();
 }
@@ -126,6 +130,8 @@ void AudioCache::readDataTask(unsigned int selfId)
     // Note: It's in sub thread
     ALOGVV("readDataTask begin, cache id=%u", selfId);
 
+    CC_PROFILE_ZONE("AudioCache::readDataTask");
+
     _readDataTaskMutex.lock();
     _state = State::LOADING;
 
@@ -296,7 +302,8 @@ void AudioCache::readDataTask(unsigned int selfId)
                 break;
             }
 
-            _state = State::READY;
+            _memorySize = dataSize;
+            _state      = State::READY;
         }
         else
         {
@@ -313,7 +320,8 @@ void AudioCache::readDataTask(unsigned int selfId)
                 decoder->readFixedFrames(_queBufferFrames, _queBuffers[index]);
             }
 
-            _state = State::READY;
+            _memorySize = queBufferBytes * QUEUEBUFFER_NUM;
+            _state      = State::READY;
         }
 
     } while (false);
@@ -331,6 +339,9 @@ void AudioCache::readDataTask(unsigned int selfId)
         }
     }
 
+    if (_state == State::READY)
+        MemoryTracker::getInstance()->allocate(MemoryTracker::TAG_AUDIO, _memorySize);
+
     // Set before invokingPlayCallbacks, otherwise, may cause dead-lock
     _isLoadingFinished = true;
 
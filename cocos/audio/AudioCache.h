@@ -88,6 +88,9 @@ protected:
     ALsizei _queBufferSize[QUEUEBUFFER_NUM];
     uint32_t _queBufferFrames;
 
+    // bytes of the pcm data or of the queue buffers, accounted under MemoryTracker::TAG_AUDIO once ready
+    uint32_t _memorySize;
+
     std::mutex _playCallbackMutex;
     std::vector<std::function<void()>> _playCallbacks;
 
@@ -47,6 +47,37 @@ void AsyncTaskPool::destroyInstance()
 
 AsyncTaskPool::AsyncTaskPool() {}
 
-AsyncTaskPool::~AsyncTaskPool() {}
+AsyncTaskPool::~AsyncTaskPool()
+{
+    for (int type = 0; type < int(TaskType::TASK_MAX_TYPE); ++type)
+    {
+        stopTasks(TaskType(type));
+    }
+}
+
+void AsyncTaskPool::stopTasks(TaskType type)
+{
+    std::lock_guard<std::mutex> lock(_tokenMutex);
+    _tokens[(int)type].cancel();
+    _tokens[(int)type] = JobSystem::CancellationToken();
+}
+
+void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type,
+                            TaskCallBack callback,
+                            void* callbackParam,
+                            std::function<void()> task)
+{
+    auto priority = type == TaskType::TASK_NETWORK ? JobSystem::Priority::LOW : JobSystem::Priority::NORMAL;
+
+    // every task depends on the previous one of its type, so a type runs its tasks one at a time in order,
+    // e.g. two async writes of the same file
+    std::lock_guard<std::mutex> lock(_tokenMutex);
+    _lastJobs[(int)type] = JobSystem::getInstance()->schedule(
+        [task = std::move(task), callback = std::move(callback), callbackParam]() {
+            task();
+            Director::getInstance()->getScheduler()->performFunctionInCocosThread(std::bind(callback, callbackParam));
+        },
+        {_lastJobs[(int)type]}, priority, &_tokens[(int)type]);
+}
 
 NS_CC_END
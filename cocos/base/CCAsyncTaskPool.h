@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "platform/CCPlatformMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCJobSystem.h"
 #include <vector>
 #include <queue>
 #include <memory>
@@ -48,6 +49,7 @@ NS_CC_BEGIN
 /**
  * @class AsyncTaskPool
  * @brief This class allows to perform background operations without having to manipulate threads.
+ * The tasks run on the shared JobSystem, tasks of the same type run one at a time in the order they were enqueued.
  * @js NA
  */
 class CC_DLL AsyncTaskPool
@@ -74,7 +76,7 @@ public:
     static void destroyInstance();
 
     /**
-     * Stop tasks.
+     * Stop tasks, tasks which are already running finish but their callbacks are still called.
      *
      * @param type Task type you want to stop.
      */
@@ -83,7 +85,7 @@ public:
     /**
      * Enqueue a asynchronous task.
      *
-     * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+     * @param type task type is io task, network task or others, network tasks run with a lower priority.
      * @param callback callback when the task is finished. The callback is called in the main thread instead of task
      * thread.
      * @param callbackParam parameter used by the callback.
@@ -95,7 +97,7 @@ public:
     /**
      * Enqueue a asynchronous task.
      *
-     * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+     * @param type task type is io task, network task or others, network tasks run with a lower priority.
      * @param task: task can be lambda function to be performed off thread.
      * @lua NA
      */
@@ -105,120 +107,15 @@ public:
     ~AsyncTaskPool();
 
 protected:
-    // thread tasks internally used
-    class ThreadTasks
-    {
-        struct AsyncTaskCallBack
-        {
-            TaskCallBack callback;
-            void* callbackParam;
-        };
-
-    public:
-        ThreadTasks() : _stop(false)
-        {
-            _thread = std::thread([this] {
-                for (;;)
-                {
-                    std::function<void()> task;
-                    AsyncTaskCallBack callback;
-                    {
-                        std::unique_lock<std::mutex> lock(this->_queueMutex);
-                        this->_condition.wait(lock, [this] { return this->_stop || !this->_tasks.empty(); });
-                        if (this->_stop && this->_tasks.empty())
-                            return;
-                        task     = std::move(this->_tasks.front());
-                        callback = std::move(this->_taskCallBacks.front());
-                        this->_tasks.pop();
-                        this->_taskCallBacks.pop();
-                    }
-
-                    task();
-                    Director::getInstance()->getScheduler()->performFunctionInCocosThread(
-                        std::bind(callback.callback, callback.callbackParam));
-                }
-            });
-        }
-        ~ThreadTasks()
-        {
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-                _stop = true;
-
-                while (_tasks.size())
-                    _tasks.pop();
-                while (_taskCallBacks.size())
-                    _taskCallBacks.pop();
-            }
-            _condition.notify_all();
-            _thread.join();
-        }
-        void clear()
-        {
-            std::unique_lock<std::mutex> lock(_queueMutex);
-            while (_tasks.size())
-                _tasks.pop();
-            while (_taskCallBacks.size())
-                _taskCallBacks.pop();
-        }
-
-        void enqueue(TaskCallBack callback, void* callbackParam, std::function<void()> task)
-        {
-            AsyncTaskCallBack taskCallBack;
-            taskCallBack.callback      = std::move(callback);
-            taskCallBack.callbackParam = callbackParam;
-
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-
-                // don't allow enqueueing after stopping the pool
-                if (_stop)
-                {
-                    CC_ASSERT(0 && "already stop");
-                    return;
-                }
-
-                _tasks.push(std::move(task));
-                _taskCallBacks.push(std::move(taskCallBack));
-            }
-            _condition.notify_one();
-        }
-
-    private:
-        // need to keep track of thread so we can join them
-        std::thread _thread;
-        // the task queue
-        std::queue<std::function<void()>> _tasks;
-        std::queue<AsyncTaskCallBack> _taskCallBacks;
-
-        // synchronization
-        std::mutex _queueMutex;
-        std::condition_variable _condition;
-        bool _stop;
-    };
-
-    // tasks
-    ThreadTasks _threadTasks[int(TaskType::TASK_MAX_TYPE)];
+    // canceled and replaced by stopTasks()
+    JobSystem::CancellationToken _tokens[int(TaskType::TASK_MAX_TYPE)];
+    // the next task of a type waits for it
+    JobSystem::JobHandle _lastJobs[int(TaskType::TASK_MAX_TYPE)];
+    std::mutex _tokenMutex;
 
     static AsyncTaskPool* s_asyncTaskPool;
 };
 
-inline void AsyncTaskPool::stopTasks(TaskType type)
-{
-    auto& threadTask = _threadTasks[(int)type];
-    threadTask.clear();
-}
-
-inline void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type,
-                                   TaskCallBack callback,
-                                   void* callbackParam,
-                                   std::function<void()> task)
-{
-    auto& threadTask = _threadTasks[(int)type];
-
-    threadTask.enqueue(std::move(callback), callbackParam, std::move(task));
-}
-
 inline void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, std::function<void()> task)
 {
     enqueue(
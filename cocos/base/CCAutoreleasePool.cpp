@@ -25,11 +25,14 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "base/CCAutoreleasePool.h"
 #include "base/ccMacros.h"
+#include <algorithm>
 
 NS_CC_BEGIN
 
 AutoreleasePool::AutoreleasePool()
     : _name("")
+    , _lastClearedObjectCount(0)
+    , _peakObjectCount(0)
 #if defined(CC_DEBUG) && (CC_DEBUG > 0)
     , _isClearing(false)
 #endif
@@ -40,6 +43,8 @@ AutoreleasePool::AutoreleasePool()
 
 AutoreleasePool::AutoreleasePool(std::string_view name)
     : _name(name)
+    , _lastClearedObjectCount(0)
+    , _peakObjectCount(0)
 #if defined(CC_DEBUG) && (CC_DEBUG > 0)
     , _isClearing(false)
 #endif
@@ -66,12 +71,22 @@ void AutoreleasePool::clear()
 #if defined(CC_DEBUG) && (CC_DEBUG > 0)
     _isClearing = true;
 #endif
+    _lastClearedObjectCount = _managedObjectArray.size();
+    _peakObjectCount        = std::max(_peakObjectCount, _lastClearedObjectCount);
+
     std::vector<Ref*> releasings;
     releasings.swap(_managedObjectArray);
     for (const auto& obj : releasings)
     {
         obj->release();
     }
+
+    // keep the storage for the next frame, unless the released objects autoreleased others
+    if (_managedObjectArray.empty())
+    {
+        releasings.clear();
+        _managedObjectArray.swap(releasings);
+    }
 #if defined(CC_DEBUG) && (CC_DEBUG > 0)
     _isClearing = false;
 #endif
@@ -111,6 +111,28 @@ public:
      */
     bool contains(Ref* object) const;
 
+    /**
+     * Returns the number of objects in the pool.
+     * @js NA
+     * @lua NA
+     */
+    size_t getObjectCount() const { return _managedObjectArray.size(); }
+
+    /**
+     * Returns the number of objects released by the last `clear`. For the pool of the engine, which is cleared at the
+     * end of every frame, it's the number of objects autoreleased during the previous frame.
+     * @js NA
+     * @lua NA
+     */
+    size_t getLastClearedObjectCount() const { return _lastClearedObjectCount; }
+
+    /**
+     * Returns the largest number of objects the pool contained when it was cleared.
+     * @js NA
+     * @lua NA
+     */
+    size_t getPeakObjectCount() const { return _peakObjectCount; }
+
     /**
      * Dump the objects that are put into the autorelease pool. It is used for debugging.
      *
@@ -135,6 +157,9 @@ private:
     std::vector<Ref*> _managedObjectArray;
     std::string _name;
 
+    size_t _lastClearedObjectCount;
+    size_t _peakObjectCount;
+
 #if defined(CC_DEBUG) && (CC_DEBUG > 0)
     /**
      *  The flag for checking whether the pool is doing `clear` operation.
@@ -49,6 +49,8 @@
 
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCFrameProfiler.h"
+#include "base/CCMemoryTracker.h"
 #include "platform/CCPlatformConfig.h"
 #include "base/CCConfiguration.h"
 #include "2d/CCScene.h"
@@ -485,6 +487,8 @@ Console::Console()
     createCommandFileUtils();
     createCommandFps();
     createCommandHelp();
+    createCommandMemory();
+    createCommandProfiler();
     createCommandProjection();
     createCommandResolution();
     createCommandSceneGraph();
@@ -1123,6 +1127,29 @@ void Console::createCommandHelp()
     addCommand({"help", "Print this message. Args: [ ]", CC_CALLBACK_2(Console::commandHelp, this)});
 }
 
+void Console::createCommandMemory()
+{
+    addCommand({"memory", "Print the memory used by the engine subsystems. Args: [-h | help | reset | ]",
+                CC_CALLBACK_2(Console::commandMemory, this)});
+    addSubCommand("memory", {"reset", "Set the peaks to the current sizes.",
+                             CC_CALLBACK_2(Console::commandMemorySubCommandReset, this)});
+}
+
+void Console::createCommandProfiler()
+{
+    addCommand({"profiler",
+                "Record frame zones and save them as a Chrome trace. Args: [-h | help | on | off | save | clear | ]",
+                CC_CALLBACK_2(Console::commandProfiler, this)});
+    addSubCommand("profiler",
+                  {"on", "Start recording zones.", CC_CALLBACK_2(Console::commandProfilerSubCommandOnOff, this)});
+    addSubCommand("profiler",
+                  {"off", "Stop recording zones.", CC_CALLBACK_2(Console::commandProfilerSubCommandOnOff, this)});
+    addSubCommand("profiler", {"save", "profiler save [filename]: save the zones, trace.json in the writable path.",
+                               CC_CALLBACK_2(Console::commandProfilerSubCommandSave, this)});
+    addSubCommand("profiler", {"clear", "Discard the recorded zones.",
+                               CC_CALLBACK_2(Console::commandProfilerSubCommandClear, this)});
+}
+
 void Console::createCommandProjection()
 {
     addCommand({"projection", "Change or print the current projection. Args: [-h | help | 2d | 3d | ]",
@@ -1280,6 +1307,41 @@ void Console::commandHelp(socket_native_type fd, std::string_view /*args*/)
     sendHelp(fd, _commands, "\nAvailable commands:\n");
 }
 
+void Console::commandMemory(socket_native_type fd, std::string_view /*args*/)
+{
+    Console::Utility::mydprintf(fd, "%s", MemoryTracker::getInstance()->dump().c_str());
+}
+
+void Console::commandMemorySubCommandReset(socket_native_type /*fd*/, std::string_view /*args*/)
+{
+    MemoryTracker::getInstance()->resetPeaks();
+}
+
+void Console::commandProfiler(socket_native_type fd, std::string_view /*args*/)
+{
+    Console::Utility::mydprintf(fd, "Profiler is: %s\n", FrameProfiler::isEnabled() ? "on" : "off");
+}
+
+void Console::commandProfilerSubCommandOnOff(socket_native_type /*fd*/, std::string_view args)
+{
+    FrameProfiler::getInstance()->setEnabled(args.compare("on") == 0);
+}
+
+void Console::commandProfilerSubCommandSave(socket_native_type fd, std::string_view args)
+{
+    auto argv        = Console::Utility::split(args, ' ');
+    std::string path = argv.size() > 1 ? argv[1] : "trace.json";
+    if (FrameProfiler::getInstance()->saveChromeTrace(path))
+        Console::Utility::mydprintf(fd, "Trace saved to: %s\n", path.c_str());
+    else
+        Console::Utility::mydprintf(fd, "Failed to save the trace to: %s\n", path.c_str());
+}
+
+void Console::commandProfilerSubCommandClear(socket_native_type /*fd*/, std::string_view /*args*/)
+{
+    FrameProfiler::getInstance()->clear();
+}
+
 void Console::commandProjection(socket_native_type fd, std::string_view /*args*/)
 {
     auto director = Director::getInstance();
@@ -236,6 +236,8 @@ protected:
     void createCommandFileUtils();
     void createCommandFps();
     void createCommandHelp();
+    void createCommandMemory();
+    void createCommandProfiler();
     void createCommandProjection();
     void createCommandResolution();
     void createCommandSceneGraph();
@@ -260,6 +262,12 @@ protected:
     void commandFps(socket_native_type fd, std::string_view args);
     void commandFpsSubCommandOnOff(socket_native_type fd, std::string_view args);
     void commandHelp(socket_native_type fd, std::string_view args);
+    void commandMemory(socket_native_type fd, std::string_view args);
+    void commandMemorySubCommandReset(socket_native_type fd, std::string_view args);
+    void commandProfiler(socket_native_type fd, std::string_view args);
+    void commandProfilerSubCommandOnOff(socket_native_type fd, std::string_view args);
+    void commandProfilerSubCommandSave(socket_native_type fd, std::string_view args);
+    void commandProfilerSubCommandClear(socket_native_type fd, std::string_view args);
     void commandProjection(socket_native_type fd, std::string_view args);
     void commandProjectionSubCommand2d(socket_native_type fd, std::string_view args);
     void commandProjectionSubCommand3d(socket_native_type fd, std::string_view args);
@@ -58,6 +58,10 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCJobSystem.h"
+#include "base/CCFrameProfiler.h"
+#include "base/CCFrameArena.h"
+#include "base/CCMemoryTracker.h"
 #include "base/ObjectFactory.h"
 #include "platform/CCApplication.h"
 #include "audio/AudioEngine.h"
@@ -115,6 +119,8 @@ bool Director::init()
 
     _console = new Console;
 
+    FrameProfiler::getInstance()->setThreadName("Main");
+
     // scheduler
     _scheduler = new Scheduler();
     // action manager
@@ -258,6 +264,8 @@ void Director::setGLDefaultValues()
 // Draw the Scene
 void Director::drawScene()
 {
+    CC_PROFILE_ZONE("Director::drawScene");
+
     _renderer->beginFrame();
 
     // calculate "global" dt
@@ -265,12 +273,14 @@ void Director::drawScene()
 
     if (_openGLView)
     {
+        CC_PROFILE_ZONE("GLView::pollEvents");
         _openGLView->pollEvents();
     }
 
     // tick before glClear: issue #533
     if (!_paused)
     {
+        CC_PROFILE_ZONE("Director::update");
         _eventDispatcher->dispatchEvent(_eventBeforeUpdate);
         _scheduler->update(_deltaTime);
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
@@ -293,14 +303,20 @@ void Director::drawScene()
     if (_runningScene)
     {
 #if (CC_USE_PHYSICS || (CC_USE_3D_PHYSICS && CC_ENABLE_BULLET_INTEGRATION) || CC_USE_NAVMESH)
-        _runningScene->stepPhysicsAndNavigation(_deltaTime);
+        {
+            CC_PROFILE_ZONE("Scene::stepPhysicsAndNavigation");
+            _runningScene->stepPhysicsAndNavigation(_deltaTime);
+        }
 #endif
         // clear draw stats
         _renderer->clearDrawStats();
 
         // render the scene
         if (_openGLView)
+        {
+            CC_PROFILE_ZONE("GLView::renderScene");
             _openGLView->renderScene(_runningScene, _renderer);
+        }
 
         _eventDispatcher->dispatchEvent(_eventAfterVisit);
     }
@@ -331,11 +347,15 @@ void Director::drawScene()
     // swap buffers
     if (_openGLView)
     {
+        CC_PROFILE_ZONE("GLView::swapBuffers");
         _openGLView->swapBuffers();
     }
 
     _renderer->endFrame();
 
+    MemoryTracker::getInstance()->update();
+    FrameProfiler::getInstance()->markFrame(_totalFrames);
+
     if (_statsDisplay)
     {
 #if !CC_STRIP_FPS
@@ -1039,18 +1059,21 @@ void Director::reset()
 
     FontFreeType::shutdownFreeType();
 
+    // joins the loading threads, which decode on the JobSystem and read through FileUtils
+    destroyTextureCache();
+
     // purge all managed caches
     AnimationCache::destroyInstance();
     SpriteFrameCache::destroyInstance();
     FileUtils::destroyInstance();
     AsyncTaskPool::destroyInstance();
+    JobSystem::destroyInstance();
+    FrameArena::destroyInstance();
     backend::ProgramManager::destroyInstance();
 
     // cocos2d-x specific data structures
     UserDefault::destroyInstance();
     resetMatrixStack();
-
-    destroyTextureCache();
 }
 
 void Director::purgeDirector()
@@ -1082,6 +1105,7 @@ void Director::restartDirector()
 
     // release the objects
     PoolManager::getInstance()->getCurrentPool()->clear();
+    FrameArena::getInstance()->reset();
 
     // Restart animation
     startAnimation();
@@ -1500,6 +1524,7 @@ void Director::mainLoop()
 
         // release the objects
         PoolManager::getInstance()->getCurrentPool()->clear();
+        FrameArena::getInstance()->reset();
     }
 }
 
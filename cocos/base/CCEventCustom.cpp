@@ -28,6 +28,8 @@
 
 NS_CC_BEGIN
 
-EventCustom::EventCustom(std::string_view eventName) : Event(Type::CUSTOM), _userData(nullptr), _eventName(eventName) {}
+EventCustom::EventCustom(std::string_view eventName)
+    : Event(Type::CUSTOM), _userData(nullptr), _eventName(eventName), _eventID(-1)
+{}
 
 NS_CC_END
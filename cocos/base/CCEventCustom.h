@@ -70,6 +70,9 @@ public:
 protected:
     void* _userData;  ///< User data
     std::string _eventName;
+    int _eventID;  ///< Interned _eventName, -1 until the event is dispatched
+
+    friend class EventDispatcher;
 };
 
 NS_CC_END
@@ -40,10 +40,14 @@
 #include "2d/CCScene.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
+#include "base/CCTouch.h"
 #include "2d/CCCamera.h"
 
 #define DUMP_LISTENER_ITEM_PRIORITY_INFO 0
 
+// bounds hit tests are widened by this, in points, so rounding never skips a listener its own test would accept
+#define BOUNDS_HIT_TEST_TOLERANCE 1.0f
+
 namespace
 {
 
@@ -62,29 +66,40 @@ private:
 
 NS_CC_BEGIN
 
-static EventListener::ListenerID __getListenerID(Event* event)
+int EventDispatcher::getListenerIndex(Event* event) const
 {
-    EventListener::ListenerID ret;
+    // the IDs of the built-in listeners are interned once, the custom event keeps its own
     switch (event->getType())
     {
     case Event::Type::ACCELERATION:
-        ret = EventListenerAcceleration::LISTENER_ID;
-        break;
+    {
+        static const int index = EventListener::internListenerID(EventListenerAcceleration::LISTENER_ID);
+        return index;
+    }
     case Event::Type::CUSTOM:
     {
         auto customEvent = static_cast<EventCustom*>(event);
-        ret              = customEvent->getEventName();
+        if (customEvent->_eventID < 0)
+        {
+            customEvent->_eventID = findListenerIndex(customEvent->getEventName());
+        }
+        return customEvent->_eventID;
     }
-    break;
     case Event::Type::KEYBOARD:
-        ret = EventListenerKeyboard::LISTENER_ID;
-        break;
+    {
+        static const int index = EventListener::internListenerID(EventListenerKeyboard::LISTENER_ID);
+        return index;
+    }
     case Event::Type::MOUSE:
-        ret = EventListenerMouse::LISTENER_ID;
-        break;
+    {
+        static const int index = EventListener::internListenerID(EventListenerMouse::LISTENER_ID);
+        return index;
+    }
     case Event::Type::FOCUS:
-        ret = EventListenerFocus::LISTENER_ID;
-        break;
+    {
+        static const int index = EventListener::internListenerID(EventListenerFocus::LISTENER_ID);
+        return index;
+    }
     case Event::Type::TOUCH:
         // Touch listener is very special, it contains two kinds of listeners, EventListenerTouchOneByOne and
         // EventListenerTouchAllAtOnce. return UNKNOWN instead.
@@ -94,15 +109,35 @@ static EventListener::ListenerID __getListenerID(Event* event)
      CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX ||   \
      CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
     case Event::Type::GAME_CONTROLLER:
-        ret = EventListenerController::LISTENER_ID;
-        break;
+    {
+        static const int index = EventListener::internListenerID(EventListenerController::LISTENER_ID);
+        return index;
+    }
 #endif
     default:
         CCASSERT(false, "Invalid type!");
         break;
     }
 
-    return ret;
+    return -1;
+}
+
+int EventDispatcher::findListenerIndex(std::string_view listenerID) const
+{
+    auto iter = _listenerIndices.find(listenerID);
+    return iter != _listenerIndices.end() ? iter->second : -1;
+}
+
+void EventDispatcher::deleteListeners(int listenerIndex)
+{
+    auto listeners = _listeners[listenerIndex];
+    _priorityDirtyFlags[listenerIndex] = DirtyFlag::NONE;
+    _listeners[listenerIndex]          = nullptr;
+    delete listeners;
+
+    auto iter = _listenerIndices.find(EventListener::getInternedListenerID(listenerIndex));
+    if (iter != _listenerIndices.end())
+        _listenerIndices.erase(iter);
 }
 
 EventDispatcher::EventListenerVector::EventListenerVector()
@@ -191,7 +226,17 @@ void EventDispatcher::EventListenerVector::clear()
     clearFixedListeners();
 }
 
-EventDispatcher::EventDispatcher() : _inDispatch(0), _isEnabled(false), _nodePriorityIndex(0)
+EventDispatcher::EventDispatcher()
+    : _touchOneByOneListenerIndex(EventListener::internListenerID(EventListenerTouchOneByOne::LISTENER_ID))
+    , _touchAllAtOnceListenerIndex(EventListener::internListenerID(EventListenerTouchAllAtOnce::LISTENER_ID))
+    , _inDispatch(0)
+    , _isEnabled(false)
+    , _nodePriorityIndex(0)
+    , _hitTestTouch(nullptr)
+    , _hitTestCacheTouch(nullptr)
+    , _hitTestCacheCamera(nullptr)
+    , _hitTestCacheParent(nullptr)
+    , _hitTestCacheValid(false)
 {
     _toAddedListeners.reserve(50);
     _toRemovedListeners.reserve(50);
@@ -209,6 +254,11 @@ EventDispatcher::~EventDispatcher()
     // so removeAllEventListeners would clean internal custom listeners.
     _internalCustomListenerIDs.clear();
     removeAllEventListeners();
+
+    for (auto&& event : _customEvents)
+    {
+        delete event;
+    }
 }
 
 void EventDispatcher::visitTarget(Node* node, bool isRootNode)
@@ -451,25 +501,24 @@ void EventDispatcher::addEventListener(EventListener* listener)
 
 void EventDispatcher::forceAddEventListener(EventListener* listener)
 {
-    EventListenerVector* listeners = nullptr;
-    auto listenerID                = listener->getListenerID();
-    auto itr                       = _listenerMap.find(listenerID);
-    if (itr == _listenerMap.end())
+    auto listenerIndex = listener->getListenerIndex();
+    if (static_cast<size_t>(listenerIndex) >= _listeners.size())
     {
-
-        listeners = new EventListenerVector();
-        _listenerMap.emplace(listenerID, listeners);
+        _listeners.resize(listenerIndex + 1, nullptr);
     }
-    else
+
+    EventListenerVector*& listeners = _listeners[listenerIndex];
+    if (listeners == nullptr)
     {
-        listeners = itr->second;
+        listeners = new EventListenerVector();
+        _listenerIndices.emplace(listener->getListenerID(), listenerIndex);
     }
 
     listeners->emplace_back(listener);
 
     if (listener->getFixedPriority() == 0)
     {
-        setDirty(listenerID, DirtyFlag::SCENE_GRAPH_PRIORITY);
+        setDirty(listenerIndex, DirtyFlag::SCENE_GRAPH_PRIORITY);
 
         auto node = listener->getAssociatedNode();
         CCASSERT(node != nullptr, "Invalid scene graph priority!");
@@ -483,7 +532,7 @@ void EventDispatcher::forceAddEventListener(EventListener* listener)
     }
     else
     {
-        setDirty(listenerID, DirtyFlag::FIXED_PRIORITY);
+        setDirty(listenerIndex, DirtyFlag::FIXED_PRIORITY);
     }
 }
 
@@ -507,10 +556,8 @@ void EventDispatcher::addEventListenerWithSceneGraphPriority(EventListener* list
 void EventDispatcher::debugCheckNodeHasNoEventListenersOnDestruction(Node* node)
 {
     // Check the listeners map
-    for (const auto& keyValuePair : _listenerMap)
+    for (const EventListenerVector* eventListenerVector : _listeners)
     {
-        const EventListenerVector* eventListenerVector = keyValuePair.second;
-
         if (eventListenerVector)
         {
             if (eventListenerVector->getSceneGraphPriorityListeners())
@@ -632,9 +679,11 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         }
     };
 
-    for (auto iter = _listenerMap.begin(); iter != _listenerMap.end();)
+    // a listener is only ever in the vectors of its own listener ID
+    auto listenerIndex = listener->getListenerIndex();
+    auto listeners     = getListeners(listenerIndex);
+    if (listeners)
     {
-        auto listeners                   = iter->second;
         auto fixedPriorityListeners      = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
 
@@ -642,14 +691,14 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         if (isFound)
         {
             // fixed #4160: Dirty flag need to be updated after listeners were removed.
-            setDirty(listener->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+            setDirty(listenerIndex, DirtyFlag::SCENE_GRAPH_PRIORITY);
         }
         else
         {
             removeListenerInVector(fixedPriorityListeners);
             if (isFound)
             {
-                setDirty(listener->getListenerID(), DirtyFlag::FIXED_PRIORITY);
+                setDirty(listenerIndex, DirtyFlag::FIXED_PRIORITY);
             }
         }
 
@@ -664,20 +713,10 @@ void EventDispatcher::removeEventListener(EventListener* listener)
                  "Listener should be in no lists after this is done if we're not currently in dispatch mode.");
 #endif
 
-        if (iter->second->empty())
-        {
-            _priorityDirtyFlagMap.erase(listener->getListenerID());
-            auto list = iter->second;
-            iter      = _listenerMap.erase(iter);
-            CC_SAFE_DELETE(list);
-        }
-        else
+        if (listeners->empty())
         {
-            ++iter;
+            deleteListeners(listenerIndex);
         }
-
-        if (isFound)
-            break;
     }
 
     if (isFound)
@@ -704,30 +743,27 @@ void EventDispatcher::setPriority(EventListener* listener, int fixedPriority)
     if (listener == nullptr)
         return;
 
-    for (auto&& iter : _listenerMap)
+    auto listeners              = getListeners(listener->getListenerIndex());
+    auto fixedPriorityListeners = listeners ? listeners->getFixedPriorityListeners() : nullptr;
+    if (fixedPriorityListeners)
     {
-        auto fixedPriorityListeners = iter.second->getFixedPriorityListeners();
-        if (fixedPriorityListeners)
+        auto found = std::find(fixedPriorityListeners->begin(), fixedPriorityListeners->end(), listener);
+        if (found != fixedPriorityListeners->end())
         {
-            auto found = std::find(fixedPriorityListeners->begin(), fixedPriorityListeners->end(), listener);
-            if (found != fixedPriorityListeners->end())
-            {
-                CCASSERT(listener->getAssociatedNode() == nullptr,
-                         "Can't set fixed priority with scene graph based listener.");
+            CCASSERT(listener->getAssociatedNode() == nullptr,
+                     "Can't set fixed priority with scene graph based listener.");
 
-                if (listener->getFixedPriority() != fixedPriority)
-                {
-                    listener->setFixedPriority(fixedPriority);
-                    setDirty(listener->getListenerID(), DirtyFlag::FIXED_PRIORITY);
-                }
-                return;
+            if (listener->getFixedPriority() != fixedPriority)
+            {
+                listener->setFixedPriority(fixedPriority);
+                setDirty(listener->getListenerIndex(), DirtyFlag::FIXED_PRIORITY);
             }
         }
     }
 }
 
-void EventDispatcher::dispatchEventToListeners(EventListenerVector* listeners,
-                                               const std::function<bool(EventListener*)>& onEvent)
+template <typename _OnEvent>
+void EventDispatcher::dispatchEventToListeners(EventListenerVector* listeners, const _OnEvent& onEvent)
 {
     bool shouldStopPropagation       = false;
     auto fixedPriorityListeners      = listeners->getFixedPriorityListeners();
@@ -790,8 +826,8 @@ void EventDispatcher::dispatchEventToListeners(EventListenerVector* listeners,
     }
 }
 
-void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listeners,
-                                                    const std::function<bool(EventListener*)>& onEvent)
+template <typename _OnEvent>
+void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listeners, const _OnEvent& onEvent)
 {
     bool shouldStopPropagation       = false;
     auto fixedPriorityListeners      = listeners->getFixedPriorityListeners();
@@ -825,8 +861,13 @@ void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listene
         {
             // priority == 0, scene graph priority
 
-            // first, get all enabled, unPaused and registered listeners
-            std::vector<EventListener*> sceneListeners;
+            // first, get all enabled, unPaused and registered listeners, into the buffer of this dispatch depth
+            if (_sceneListeners.size() < static_cast<size_t>(_inDispatch))
+            {
+                _sceneListeners.resize(_inDispatch);
+            }
+            auto& sceneListeners = _sceneListeners[_inDispatch - 1];
+            sceneListeners.clear();
             for (auto&& l : *sceneGraphPriorityListeners)
             {
                 if (l->isEnabled() && !l->isPaused() && l->isRegistered())
@@ -855,6 +896,10 @@ void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listene
                     {
                         continue;
                     }
+                    if (_hitTestTouch && isTouchOutsideListenerBounds(l, camera))
+                    {
+                        continue;
+                    }
                     if (onEvent(l))
                     {
                         shouldStopPropagation = true;
@@ -890,6 +935,66 @@ void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listene
     }
 }
 
+bool EventDispatcher::isTouchOutsideListenerBounds(EventListener* listener, const Camera* camera)
+{
+    if (listener->getType() != EventListener::Type::TOUCH_ONE_BY_ONE ||
+        !static_cast<EventListenerTouchOneByOne*>(listener)->_boundsHitTest)
+    {
+        return false;
+    }
+
+    Node* node   = listener->getAssociatedNode();
+    Node* parent = node->getParent();
+    if (nullptr == parent)
+    {
+        return false;
+    }
+
+    // the bounding box is only meaningful for a node lying on the z = 0 plane of its parent
+    const Mat4& transform = node->getNodeToParentTransform();
+    if (transform.m[2] != 0 || transform.m[3] != 0 || transform.m[6] != 0 || transform.m[7] != 0 ||
+        transform.m[8] != 0 || transform.m[9] != 0 || transform.m[11] != 0 || transform.m[14] != 0)
+    {
+        return false;
+    }
+
+    // listeners of siblings are next to each other in scene graph order, so the touch is mostly projected once per
+    // parent, the same way isScreenPointInRect() does it
+    if (parent != _hitTestCacheParent || camera != _hitTestCacheCamera || _hitTestTouch != _hitTestCacheTouch)
+    {
+        _hitTestCacheTouch  = _hitTestTouch;
+        _hitTestCacheCamera = camera;
+        _hitTestCacheParent = parent;
+
+        auto location = _hitTestTouch->getLocation();
+        Vec3 nearPoint(location.x, location.y, -1), farPoint(location.x, location.y, 1);
+        nearPoint = camera->unprojectGL(nearPoint);
+        farPoint  = camera->unprojectGL(farPoint);
+
+        const Mat4& worldToParent = parent->getWorldToNodeTransform();
+        worldToParent.transformPoint(&nearPoint);
+        worldToParent.transformPoint(&farPoint);
+
+        auto direction     = farPoint - nearPoint;
+        _hitTestCacheValid = direction.z != 0;
+        if (_hitTestCacheValid)
+        {
+            float t               = -nearPoint.z / direction.z;
+            _hitTestCacheLocation = Vec2(nearPoint.x + t * direction.x, nearPoint.y + t * direction.y);
+        }
+    }
+
+    if (!_hitTestCacheValid)
+    {
+        return false;
+    }
+
+    auto bounds = node->getBoundingBox();
+    bounds.origin -= Vec2(BOUNDS_HIT_TEST_TOLERANCE, BOUNDS_HIT_TEST_TOLERANCE);
+    bounds.size = bounds.size + Size(2 * BOUNDS_HIT_TEST_TOLERANCE, 2 * BOUNDS_HIT_TEST_TOLERANCE);
+    return !bounds.containsPoint(_hitTestCacheLocation);
+}
+
 void EventDispatcher::dispatchEvent(Event* event)
 {
     if (!_isEnabled)
@@ -905,37 +1010,69 @@ void EventDispatcher::dispatchEvent(Event* event)
         return;
     }
 
-    auto listenerID = __getListenerID(event);
+    auto listenerIndex = getListenerIndex(event);
 
-    sortEventListeners(listenerID);
+    sortEventListeners(listenerIndex);
 
-    auto pfnDispatchEventToListeners = &EventDispatcher::dispatchEventToListeners;
-    if (event->getType() == Event::Type::MOUSE)
+    auto listeners = getListeners(listenerIndex);
+    if (listeners)
     {
-        pfnDispatchEventToListeners = &EventDispatcher::dispatchTouchEventToListeners;
-    }
-    auto iter = _listenerMap.find(listenerID);
-    if (iter != _listenerMap.end())
-    {
-        auto listeners = iter->second;
-
         auto onEvent = [&event](EventListener* listener) -> bool {
             event->setCurrentTarget(listener->getAssociatedNode());
             listener->_onEvent(event);
             return event->isStopped();
         };
 
-        (this->*pfnDispatchEventToListeners)(listeners, onEvent);
+        if (event->getType() == Event::Type::MOUSE)
+        {
+            dispatchTouchEventToListeners(listeners, onEvent);
+        }
+        else
+        {
+            dispatchEventToListeners(listeners, onEvent);
+        }
     }
 
     updateListeners(event);
 }
 
+EventCustom* EventDispatcher::acquireCustomEvent(std::string_view eventName, int eventID)
+{
+    // a listener may dispatch another custom event while handling one, so there is an event per dispatch depth
+    if (_customEvents.size() <= static_cast<size_t>(_inDispatch))
+    {
+        _customEvents.resize(_inDispatch + 1, nullptr);
+    }
+
+    EventCustom* event = _customEvents[_inDispatch];
+    if (event == nullptr)
+    {
+        event                      = new EventCustom(eventName);
+        _customEvents[_inDispatch] = event;
+    }
+    else
+    {
+        event->_eventName.assign(eventName.data(), eventName.size());
+        event->_isStopped     = false;
+        event->_currentTarget = nullptr;
+    }
+    event->_eventID = eventID;
+
+    return event;
+}
+
 void EventDispatcher::dispatchCustomEvent(std::string_view eventName, void* optionalUserData)
 {
-    EventCustom ev(eventName);
-    ev.setUserData(optionalUserData);
-    dispatchEvent(&ev);
+    auto event = acquireCustomEvent(eventName, -1);
+    event->setUserData(optionalUserData);
+    dispatchEvent(event);
+}
+
+void EventDispatcher::dispatchCustomEvent(int eventID, void* optionalUserData)
+{
+    auto event = acquireCustomEvent(EventListener::getInternedListenerID(eventID), eventID);
+    event->setUserData(optionalUserData);
+    dispatchEvent(event);
 }
 
 bool EventDispatcher::hasEventListener(std::string_view listenerID) const
@@ -945,11 +1082,11 @@ bool EventDispatcher::hasEventListener(std::string_view listenerID) const
 
 void EventDispatcher::dispatchTouchEvent(EventTouch* event)
 {
-    sortEventListeners(EventListenerTouchOneByOne::LISTENER_ID);
-    sortEventListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+    sortEventListeners(_touchOneByOneListenerIndex);
+    sortEventListeners(_touchAllAtOnceListenerIndex);
 
-    auto oneByOneListeners  = getListeners(EventListenerTouchOneByOne::LISTENER_ID);
-    auto allAtOnceListeners = getListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+    auto oneByOneListeners  = getListeners(_touchOneByOneListenerIndex);
+    auto allAtOnceListeners = getListeners(_touchAllAtOnceListenerIndex);
 
     // If there aren't any touch listeners, return directly.
     if (nullptr == oneByOneListeners && nullptr == allAtOnceListeners)
@@ -1059,8 +1196,12 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
                 return false;
             };
 
-            //
+            // only a touch which begins can be claimed, so only then listeners are skipped by their bounds
+            auto previousHitTestTouch = _hitTestTouch;
+            _hitTestTouch       = event->getEventCode() == EventTouch::EventCode::BEGAN ? touches : nullptr;
+            _hitTestCacheParent = nullptr;  // touches are reused by later events
             dispatchTouchEventToListeners(oneByOneListeners, onTouchEvent);
+            _hitTestTouch = previousHitTestTouch;
             if (event->isStopped())
             {
                 return;
@@ -1143,13 +1284,11 @@ void EventDispatcher::updateListeners(Event* event)
     if (_inDispatch > 1)
         return;
 
-    auto onUpdateListeners = [this](const EventListener::ListenerID& listenerID) {
-        auto listenersIter = _listenerMap.find(listenerID);
-        if (listenersIter == _listenerMap.end())
+    auto onUpdateListeners = [this](int listenerIndex) {
+        auto listeners = getListeners(listenerIndex);
+        if (listeners == nullptr)
             return;
 
-        auto listeners = listenersIter->second;
-
         auto fixedPriorityListeners      = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
 
@@ -1204,33 +1343,35 @@ void EventDispatcher::updateListeners(Event* event)
         {
             listeners->clearFixedListeners();
         }
+
+        if (listeners->empty())
+        {
+            _emptiedListenerIndices.emplace_back(listenerIndex);
+        }
     };
 
     if (event->getType() == Event::Type::TOUCH)
     {
-        onUpdateListeners(EventListenerTouchOneByOne::LISTENER_ID);
-        onUpdateListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+        onUpdateListeners(_touchOneByOneListenerIndex);
+        onUpdateListeners(_touchAllAtOnceListenerIndex);
     }
     else
     {
-        onUpdateListeners(__getListenerID(event));
+        onUpdateListeners(getListenerIndex(event));
     }
 
     CCASSERT(_inDispatch == 1, "_inDispatch should be 1 here.");
 
-    for (auto iter = _listenerMap.begin(); iter != _listenerMap.end();)
+    // only the listener IDs whose vectors were emptied while dispatching need to be checked
+    for (auto&& listenerIndex : _emptiedListenerIndices)
     {
-        if (iter->second->empty())
-        {
-            _priorityDirtyFlagMap.erase(iter->first);
-            delete iter->second;
-            iter = _listenerMap.erase(iter);
-        }
-        else
+        auto listeners = getListeners(listenerIndex);
+        if (listeners && listeners->empty())
         {
-            ++iter;
+            deleteListeners(listenerIndex);
         }
     }
+    _emptiedListenerIndices.clear();
 
     if (!_toAddedListeners.empty())
     {
@@ -1258,7 +1399,7 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
             {
                 for (auto&& l : *iter->second)
                 {
-                    setDirty(l->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+                    setDirty(l->getListenerIndex(), DirtyFlag::SCENE_GRAPH_PRIORITY);
                 }
             }
         }
@@ -1267,24 +1408,22 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
     }
 }
 
-void EventDispatcher::sortEventListeners(std::string_view listenerID)
+void EventDispatcher::sortEventListeners(int listenerIndex)
 {
-    DirtyFlag dirtyFlag = DirtyFlag::NONE;
+    if (static_cast<size_t>(listenerIndex) >= _priorityDirtyFlags.size())
+        return;
 
-    auto dirtyIter = _priorityDirtyFlagMap.find(listenerID);
-    if (dirtyIter != _priorityDirtyFlagMap.end())
-    {
-        dirtyFlag = dirtyIter->second;
-    }
+    DirtyFlag& dirtyFlagRef = _priorityDirtyFlags[listenerIndex];
+    DirtyFlag dirtyFlag     = dirtyFlagRef;
 
     if (dirtyFlag != DirtyFlag::NONE)
     {
         // Clear the dirty flag first, if `rootNode` is nullptr, then set its dirty flag of scene graph priority
-        dirtyIter->second = DirtyFlag::NONE;
+        dirtyFlagRef = DirtyFlag::NONE;
 
         if ((int)dirtyFlag & (int)DirtyFlag::FIXED_PRIORITY)
         {
-            sortEventListenersOfFixedPriority(listenerID);
+            sortEventListenersOfFixedPriority(listenerIndex);
         }
 
         if ((int)dirtyFlag & (int)DirtyFlag::SCENE_GRAPH_PRIORITY)
@@ -1292,19 +1431,19 @@ void EventDispatcher::sortEventListeners(std::string_view listenerID)
             auto rootNode = Director::getInstance()->getRunningScene();
             if (rootNode)
             {
-                sortEventListenersOfSceneGraphPriority(listenerID, rootNode);
+                sortEventListenersOfSceneGraphPriority(listenerIndex, rootNode);
             }
             else
             {
-                dirtyIter->second = DirtyFlag::SCENE_GRAPH_PRIORITY;
+                dirtyFlagRef = DirtyFlag::SCENE_GRAPH_PRIORITY;
             }
         }
     }
 }
 
-void EventDispatcher::sortEventListenersOfSceneGraphPriority(std::string_view listenerID, Node* rootNode)
+void EventDispatcher::sortEventListenersOfSceneGraphPriority(int listenerIndex, Node* rootNode)
 {
-    auto listeners = getListeners(listenerID);
+    auto listeners = getListeners(listenerIndex);
 
     if (listeners == nullptr)
         return;
@@ -1335,9 +1474,9 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(std::string_view li
 #endif
 }
 
-void EventDispatcher::sortEventListenersOfFixedPriority(std::string_view listenerID)
+void EventDispatcher::sortEventListenersOfFixedPriority(int listenerIndex)
 {
-    auto listeners = getListeners(listenerID);
+    auto listeners = getListeners(listenerIndex);
 
     if (listeners == nullptr)
         return;
@@ -1374,21 +1513,18 @@ void EventDispatcher::sortEventListenersOfFixedPriority(std::string_view listene
 
 EventDispatcher::EventListenerVector* EventDispatcher::getListeners(std::string_view listenerID) const
 {
-    auto iter = _listenerMap.find(listenerID);
-    if (iter != _listenerMap.end())
-    {
-        return iter->second;
-    }
-
-    return nullptr;
+    return getListeners(findListenerIndex(listenerID));
 }
 
 void EventDispatcher::removeEventListenersForListenerID(std::string_view listenerID)
 {
-    auto listenerItemIter = _listenerMap.find(listenerID);
-    if (listenerItemIter != _listenerMap.end())
+    auto listenerIndex = findListenerIndex(listenerID);
+    if (listenerIndex < 0)
+        return;
+
+    auto listeners = getListeners(listenerIndex);
+    if (listeners)
     {
-        auto listeners                   = listenerItemIter->second;
         auto fixedPriorityListeners      = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
 
@@ -1424,19 +1560,17 @@ void EventDispatcher::removeEventListenersForListenerID(std::string_view listene
 
         // Remove the dirty flag according the 'listenerID'.
         // No need to check whether the dispatcher is dispatching event.
-        _priorityDirtyFlagMap.erase(listenerID);
+        _priorityDirtyFlags[listenerIndex] = DirtyFlag::NONE;
 
         if (!_inDispatch)
         {
-            listeners->clear();
-            delete listeners;
-            _listenerMap.erase(listenerItemIter);
+            deleteListeners(listenerIndex);
         }
     }
 
     for (auto iter = _toAddedListeners.begin(); iter != _toAddedListeners.end();)
     {
-        if ((*iter)->getListenerID() == listenerID)
+        if ((*iter)->getListenerIndex() == listenerIndex)
         {
             (*iter)->setRegistered(false);
             releaseListener(*iter);
@@ -1486,17 +1620,21 @@ void EventDispatcher::removeAllEventListeners()
 {
     bool cleanMap = true;
     std::vector<std::string_view> types;
-    types.reserve(_listenerMap.size());
+    types.reserve(_listeners.size());
 
-    for (const auto& e : _listenerMap)
+    for (int listenerIndex = 0, count = static_cast<int>(_listeners.size()); listenerIndex < count; ++listenerIndex)
     {
-        if (_internalCustomListenerIDs.find(e.first) != _internalCustomListenerIDs.end())
+        if (_listeners[listenerIndex] == nullptr)
+            continue;
+
+        auto listenerID = EventListener::getInternedListenerID(listenerIndex);
+        if (_internalCustomListenerIDs.find(std::string{listenerID}) != _internalCustomListenerIDs.end())
         {
             cleanMap = false;
         }
         else
         {
-            types.emplace_back(e.first);
+            types.emplace_back(listenerID);
         }
     }
 
@@ -1507,7 +1645,8 @@ void EventDispatcher::removeAllEventListeners()
 
     if (!_inDispatch && cleanMap)
     {
-        _listenerMap.clear();
+        _listeners.clear();
+        _listenerIndices.clear();
     }
 }
 
@@ -1537,33 +1676,29 @@ void EventDispatcher::setDirtyForNode(Node* node)
     }
 }
 
-void EventDispatcher::setDirty(std::string_view listenerID, DirtyFlag flag)
+void EventDispatcher::setDirty(int listenerIndex, DirtyFlag flag)
 {
-    auto iter = _priorityDirtyFlagMap.find(listenerID);
-    if (iter == _priorityDirtyFlagMap.end())
+    if (static_cast<size_t>(listenerIndex) >= _priorityDirtyFlags.size())
     {
-        _priorityDirtyFlagMap.emplace(listenerID, flag);
-    }
-    else
-    {
-        int ret      = (int)flag | (int)iter->second;
-        iter->second = (DirtyFlag)ret;
+        _priorityDirtyFlags.resize(listenerIndex + 1, DirtyFlag::NONE);
     }
+
+    int ret                            = (int)flag | (int)_priorityDirtyFlags[listenerIndex];
+    _priorityDirtyFlags[listenerIndex] = (DirtyFlag)ret;
 }
 
 void EventDispatcher::cleanToRemovedListeners()
 {
     for (auto&& l : _toRemovedListeners)
     {
-        auto listenersIter = _listenerMap.find(l->getListenerID());
-        if (listenersIter == _listenerMap.end())
+        auto listeners = getListeners(l->getListenerIndex());
+        if (listeners == nullptr)
         {
             releaseListener(l);
             continue;
         }
 
         bool find                        = false;
-        auto listeners                   = listenersIter->second;
         auto fixedPriorityListeners      = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
 
@@ -1600,6 +1735,11 @@ void EventDispatcher::cleanToRemovedListeners()
             {
                 listeners->clearFixedListeners();
             }
+
+            if (listeners->empty())
+            {
+                _emptiedListenerIndices.emplace_back(l->getListenerIndex());
+            }
         }
         else
             CC_SAFE_RELEASE(l);
@@ -27,6 +27,7 @@
 #define __CC_EVENT_DISPATCHER_H__
 
 #include <functional>
+#include <deque>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -37,6 +38,7 @@
 #include "base/CCEvent.h"
 #include "platform/CCStdC.h"
 #include "base/hlookup.h"
+#include "math/Vec2.h"
 
 /**
  * @addtogroup base
@@ -47,6 +49,8 @@ NS_CC_BEGIN
 
 class Event;
 class EventTouch;
+class Touch;
+class Camera;
 class Node;
 class EventCustom;
 class EventListenerCustom;
@@ -180,6 +184,21 @@ public:
      */
     void dispatchCustomEvent(std::string_view eventName, void* optionalUserData = nullptr);
 
+    /** Dispatches a Custom Event with an interned event ID, skipping the lookup of the name.
+     *
+     * @param eventID The ID of the event, returned by getCustomEventID().
+     * @param optionalUserData The optional user data, it's a void*, the default value is nullptr.
+     */
+    void dispatchCustomEvent(int eventID, void* optionalUserData = nullptr);
+
+    /** Interns the name of a custom event, for dispatchCustomEvent(int, void*).
+     *  The ID stays valid for the life of the process.
+     *
+     * @param eventName The name of the event.
+     * @return The ID of the event.
+     */
+    static int getCustomEventID(std::string_view eventName) { return EventListener::internListenerID(eventName); }
+
     /** Query whether the specified event listener id has been added.
      *
      * @param listenerID The listenerID of the event listener id.
@@ -254,6 +273,22 @@ protected:
 
     /** Gets event the listener list for the event listener type. */
     EventListenerVector* getListeners(std::string_view listenerID) const;
+    EventListenerVector* getListeners(int listenerIndex) const
+    {
+        return static_cast<size_t>(listenerIndex) < _listeners.size() ? _listeners[listenerIndex] : nullptr;
+    }
+
+    /** Gets the interned listener ID of a non-touch event, -1 if this dispatcher has no listener for it */
+    int getListenerIndex(Event* event) const;
+
+    /** Gets the interned index of a listener ID this dispatcher has listeners for, -1 otherwise */
+    int findListenerIndex(std::string_view listenerID) const;
+
+    /** Deletes the emptied listener vector of a listener ID */
+    void deleteListeners(int listenerIndex);
+
+    /** Gets the custom event reused for the current dispatch depth, reset to the name */
+    EventCustom* acquireCustomEvent(std::string_view eventName, int eventID);
 
     /** Update dirty flag */
     void updateDirtyFlagForSceneGraph();
@@ -262,13 +297,13 @@ protected:
     void removeEventListenersForListenerID(std::string_view listenerID);
 
     /** Sort event listener */
-    void sortEventListeners(std::string_view listenerID);
+    void sortEventListeners(int listenerIndex);
 
     /** Sorts the listeners of specified type by scene graph priority */
-    void sortEventListenersOfSceneGraphPriority(std::string_view listenerID, Node* rootNode);
+    void sortEventListenersOfSceneGraphPriority(int listenerIndex, Node* rootNode);
 
     /** Sorts the listeners of specified type by fixed priority */
-    void sortEventListenersOfFixedPriority(std::string_view listenerID);
+    void sortEventListenersOfFixedPriority(int listenerIndex);
 
     /** Updates all listeners
      *  1) Removes all listener items that have been marked as 'removed' when dispatching event.
@@ -286,8 +321,12 @@ protected:
     /** Dissociates node with event listener */
     void dissociateNodeAndEventListener(Node* node, EventListener* listener);
 
-    /** Dispatches event to listeners with a specified listener type */
-    void dispatchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent);
+    /** Dispatches event to listeners with a specified listener type.
+     *  onEvent is a functor `bool(EventListener*)` returning true to stop the propagation, templated so that
+     *  dispatching never wraps it in a std::function.
+     */
+    template <typename _OnEvent>
+    void dispatchEventToListeners(EventListenerVector* listeners, const _OnEvent& onEvent);
 
     /** Special version dispatchEventToListeners for touch/mouse event.
      *
@@ -297,11 +336,15 @@ protected:
      *      to 3D world space is different by different camera.
      *  When listener process touch event, can get current camera by Camera::getVisitingCamera().
      */
-    void dispatchTouchEventToListeners(EventListenerVector* listeners,
-                                       const std::function<bool(EventListener*)>& onEvent);
+    template <typename _OnEvent>
+    void dispatchTouchEventToListeners(EventListenerVector* listeners, const _OnEvent& onEvent);
 
     void releaseListener(EventListener* listener);
 
+    /** Whether the touch being dispatched to one by one listeners begins outside the bounds of the node of a listener
+     *  which only claims touches inside them, see EventListenerTouchOneByOne::setBoundsHitTest. */
+    bool isTouchOutsideListenerBounds(EventListener* listener, const Camera* camera);
+
     /// Priority dirty flag
     enum class DirtyFlag
     {
@@ -312,7 +355,7 @@ protected:
     };
 
     /** Sets the dirty flag for a specified listener ID */
-    void setDirty(std::string_view listenerID, DirtyFlag flag);
+    void setDirty(int listenerIndex, DirtyFlag flag);
 
     /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with
      * scene graph priority */
@@ -321,11 +364,28 @@ protected:
     /** Remove all listeners in _toRemoveListeners list and cleanup */
     void cleanToRemovedListeners();
 
-    /** Listeners map */
-    hlookup::string_map<EventListenerVector*> _listenerMap;
+    /** Listeners indexed by the interned listener ID, nullptr when there is none. Sized to the largest index of a
+     *  listener added to this dispatcher, one pointer per listener ID of the process at most. */
+    std::vector<EventListenerVector*> _listeners;
+
+    /** The dirty flags indexed by the interned listener ID */
+    std::vector<DirtyFlag> _priorityDirtyFlags;
+
+    /** The interned index of every listener ID in _listeners, looked up without locking the process-wide table */
+    hlookup::string_map<int> _listenerIndices;
 
-    /** The map of dirty flag */
-    hlookup::string_map<DirtyFlag> _priorityDirtyFlagMap;
+    /** Listener IDs whose listener vectors may have become empty, they are deleted after dispatching */
+    std::vector<int> _emptiedListenerIndices;
+
+    /** Interned IDs of the touch listeners */
+    int _touchOneByOneListenerIndex;
+    int _touchAllAtOnceListenerIndex;
+
+    /** Custom events reused by dispatchCustomEvent, one per dispatch depth */
+    std::vector<EventCustom*> _customEvents;
+
+    /** Scene graph listeners collected by dispatchTouchEventToListeners, one per dispatch depth */
+    std::deque<std::vector<EventListener*>> _sceneListeners;
 
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
@@ -353,6 +413,16 @@ protected:
 
     int _nodePriorityIndex;
 
+    /** The touch which begins while it is dispatched to one by one listeners */
+    Touch* _hitTestTouch;
+
+    /** The touch location in the space of the last parent it was projected on, for a touch and a camera */
+    Touch* _hitTestCacheTouch;
+    const Camera* _hitTestCacheCamera;
+    Node* _hitTestCacheParent;
+    Vec2 _hitTestCacheLocation;
+    bool _hitTestCacheValid;
+
     std::set<std::string> _internalCustomListenerIDs;
 };
 
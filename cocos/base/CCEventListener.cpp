@@ -25,10 +25,70 @@
 
 #include "base/CCEventListener.h"
 #include "base/CCConsole.h"
+#include "base/hlookup.h"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
 
 NS_CC_BEGIN
 
-EventListener::EventListener() {}
+namespace
+{
+// The names are kept in a deque, which never moves them, so the views handed out stay valid.
+// Lookups only take the lock shared, the table is written once per distinct name.
+struct ListenerIDTable
+{
+    std::shared_mutex mutex;
+    hlookup::string_map<int> indices;
+    std::deque<std::string> names;
+};
+
+ListenerIDTable& getListenerIDTable()
+{
+    static ListenerIDTable table;
+    return table;
+}
+}  // namespace
+
+int EventListener::internListenerID(std::string_view listenerID)
+{
+    auto& table = getListenerIDTable();
+    {
+        std::shared_lock<std::shared_mutex> lock(table.mutex);
+        auto iter = table.indices.find(listenerID);
+        if (iter != table.indices.end())
+            return iter->second;
+    }
+
+    std::lock_guard<std::shared_mutex> lock(table.mutex);
+    auto iter = table.indices.find(listenerID);
+    if (iter != table.indices.end())
+        return iter->second;
+
+    int index = static_cast<int>(table.names.size());
+    table.names.emplace_back(listenerID);
+    table.indices.emplace(table.names.back(), index);
+    return index;
+}
+
+int EventListener::findListenerIndex(std::string_view listenerID)
+{
+    auto& table = getListenerIDTable();
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+
+    auto iter = table.indices.find(listenerID);
+    return iter != table.indices.end() ? iter->second : -1;
+}
+
+std::string_view EventListener::getInternedListenerID(int index)
+{
+    auto& table = getListenerIDTable();
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+    return table.names[index];
+}
+
+EventListener::EventListener() : _listenerIndex(-1) {}
 
 EventListener::~EventListener()
 {
@@ -37,12 +97,13 @@ EventListener::~EventListener()
 
 bool EventListener::init(Type t, std::string_view listenerID, const std::function<void(Event*)>& callback)
 {
-    _onEvent      = callback;
-    _type         = t;
-    _listenerID   = listenerID;
-    _isRegistered = false;
-    _paused       = false;
-    _isEnabled    = true;
+    _onEvent       = callback;
+    _type          = t;
+    _listenerID    = listenerID;
+    _listenerIndex = internListenerID(listenerID);
+    _isRegistered  = false;
+    _paused        = false;
+    _isEnabled     = true;
 
     return true;
 }
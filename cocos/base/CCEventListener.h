@@ -112,6 +112,23 @@ public:
      */
     bool isEnabled() const { return _isEnabled; }
 
+    /** Returns a small index unique to a listener ID, or custom event name, for the life of the process.
+     *  EventDispatcher keeps its listeners in an array indexed by it. This function is thread safe.
+     *  The indices are never reused, so the table grows with the distinct IDs listeners are created for and the names
+     *  passed to EventDispatcher::getCustomEventID; dispatching an event by name never adds to it. Avoid building
+     *  unbounded sets of custom event names, such as names embedding an object ID.
+     *
+     * @param listenerID The listener ID, or the custom event name.
+     * @return The index, starting at 0.
+     */
+    static int internListenerID(std::string_view listenerID);
+
+    /** Returns the index of a listener ID which was interned, -1 otherwise. This function is thread safe. */
+    static int findListenerIndex(std::string_view listenerID);
+
+    /** Returns the listener ID interned with the index. This function is thread safe. */
+    static std::string_view getInternedListenerID(int index);
+
 protected:
     /** Sets paused state for the listener
      *  The paused state is only used for scene graph priority listeners.
@@ -144,6 +161,9 @@ protected:
      */
     std::string_view getListenerID() const { return _listenerID; }
 
+    /** Gets the interned index of the listener ID */
+    int getListenerIndex() const { return _listenerIndex; }
+
     /** Sets the fixed priority for this listener
      *  @note This method is only used for `fixed priority listeners`, it needs to access a non-zero value.
      *  0 is reserved for scene graph priority listeners
@@ -170,6 +190,7 @@ protected:
 
     Type _type;              /// Event listener type
     ListenerID _listenerID;  /// Event listener ID
+    int _listenerIndex;      /// Interned index of _listenerID
     bool _isRegistered;      /// Whether the listener has been added to dispatcher.
 
     int _fixedPriority;  // The higher the number, the higher the priority, 0 is for scene graph base priority.
@@ -40,6 +40,7 @@ EventListenerTouchOneByOne::EventListenerTouchOneByOne()
     , onTouchEnded(nullptr)
     , onTouchCancelled(nullptr)
     , _needSwallow(false)
+    , _boundsHitTest(false)
 {}
 
 EventListenerTouchOneByOne::~EventListenerTouchOneByOne()
@@ -67,6 +68,16 @@ bool EventListenerTouchOneByOne::isSwallowTouches()
     return _needSwallow;
 }
 
+void EventListenerTouchOneByOne::setBoundsHitTest(bool boundsHitTest)
+{
+    _boundsHitTest = boundsHitTest;
+}
+
+bool EventListenerTouchOneByOne::isBoundsHitTest()
+{
+    return _boundsHitTest;
+}
+
 EventListenerTouchOneByOne* EventListenerTouchOneByOne::create()
 {
     auto ret = new EventListenerTouchOneByOne();
@@ -108,6 +119,7 @@ EventListenerTouchOneByOne* EventListenerTouchOneByOne::clone()
 
         ret->_claimedTouches = _claimedTouches;
         ret->_needSwallow    = _needSwallow;
+        ret->_boundsHitTest  = _boundsHitTest;
     }
     else
     {
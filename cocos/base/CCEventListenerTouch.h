@@ -69,6 +69,19 @@ public:
      */
     bool isSwallowTouches();
 
+    /** Declares that onTouchBegan only claims touches inside the content box of the associated node.
+     *  The EventDispatcher then skips the listener, without calling onTouchBegan, for the touches which begin outside
+     *  the bounding box of the node in the space of its parent. Only listeners with scene graph priority are skipped.
+     *
+     * @param boundsHitTest True if touches outside the node are never claimed.
+     */
+    void setBoundsHitTest(bool boundsHitTest);
+    /** Whether the listener only claims touches inside its node.
+     *
+     * @return True if touches outside the node are never claimed.
+     */
+    bool isBoundsHitTest();
+
     /// Overrides
     virtual EventListenerTouchOneByOne* clone() override;
     virtual bool checkAvailable() override;
@@ -89,6 +102,7 @@ public:
 private:
     std::vector<Touch*> _claimedTouches;
     bool _needSwallow;
+    bool _boundsHitTest;
 
     friend class EventDispatcher;
 };
@@ -0,0 +1,197 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCFrameArena.h"
+#include <cstdlib>
+#include <typeinfo>
+
+NS_CC_BEGIN
+
+namespace
+{
+constexpr size_t alignToMax(size_t size)
+{
+    return (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+}
+}  // namespace
+
+static FrameArena* s_sharedFrameArena = nullptr;
+
+FrameArena* FrameArena::getInstance()
+{
+    if (!s_sharedFrameArena)
+        s_sharedFrameArena = new FrameArena();
+    return s_sharedFrameArena;
+}
+
+void FrameArena::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedFrameArena);
+}
+
+FrameArena::FrameArena() : _currentChunk(0), _generation(1), _lastFrameObjectCount(0), _escapedObjectCount(0)
+{
+    _objects.reserve(256);
+}
+
+FrameArena::~FrameArena()
+{
+    reset();
+
+    for (auto&& chunk : _chunks)
+    {
+        free(chunk);
+    }
+}
+
+void* FrameArena::allocate(size_t size)
+{
+    static const size_t chunkHeaderSize  = alignToMax(sizeof(Chunk));
+    static const size_t objectHeaderSize = alignToMax(sizeof(ObjectHeader));
+
+    size = objectHeaderSize + alignToMax(size);
+
+    // the chunks before the current one are full, the ones after it are empty
+    Chunk* chunk = nullptr;
+    for (; _currentChunk < _chunks.size(); ++_currentChunk)
+    {
+        auto candidate = _chunks[_currentChunk];
+        if (candidate->capacity - candidate->used >= size)
+        {
+            chunk = candidate;
+            break;
+        }
+    }
+
+    if (chunk == nullptr)
+    {
+        size_t capacity = size > CHUNK_SIZE ? size : CHUNK_SIZE;
+        chunk           = static_cast<Chunk*>(malloc(chunkHeaderSize + capacity));
+        CCASSERT(chunk, "Out of memory");
+        chunk->capacity    = capacity;
+        chunk->used        = 0;
+        chunk->liveObjects = 0;
+        chunk->detached    = false;
+        _chunks.emplace_back(chunk);
+        _currentChunk = _chunks.size() - 1;
+    }
+
+    auto header = reinterpret_cast<ObjectHeader*>(reinterpret_cast<char*>(chunk) + chunkHeaderSize + chunk->used);
+
+    header->chunk  = chunk;
+    header->object = nullptr;
+    header->alive  = false;
+
+    chunk->used += size;
+    ++chunk->liveObjects;
+
+    return reinterpret_cast<char*>(header) + objectHeaderSize;
+}
+
+void FrameArena::track(void* memory, Ref* object)
+{
+    auto header = reinterpret_cast<ObjectHeader*>(static_cast<char*>(memory) - alignToMax(sizeof(ObjectHeader)));
+
+    header->object = object;
+    header->alive  = true;
+    _objects.emplace_back(header);
+}
+
+void FrameArena::onObjectDeleted(void* memory)
+{
+    auto header  = reinterpret_cast<ObjectHeader*>(static_cast<char*>(memory) - alignToMax(sizeof(ObjectHeader)));
+    auto chunk   = header->chunk;
+    header->alive = false;
+
+    if (--chunk->liveObjects == 0 && chunk->detached)
+    {
+        free(chunk);
+    }
+}
+
+void FrameArena::reset()
+{
+    ++_generation;
+    _lastFrameObjectCount = _objects.size();
+
+    // the objects created last are released first, they may retain the ones created before them
+    for (auto iter = _objects.rbegin(); iter != _objects.rend(); ++iter)
+    {
+        auto header = *iter;
+        if (!header->alive)
+        {
+            CCASSERT(false, "An object of the frame arena was released more times than it was retained");
+            continue;
+        }
+
+        auto object = header->object;
+        if (object->getReferenceCount() > 1)
+        {
+            ++_escapedObjectCount;
+            CCLOGWARN("FrameArena: %s escaped its frame, it's still retained %u times", typeid(*object).name(),
+                      object->getReferenceCount() - 1);
+        }
+        object->release();
+    }
+    _objects.clear();
+
+    // the chunks kept by escaped objects are given up, the others are reused from the beginning
+    size_t kept = 0;
+    for (auto&& chunk : _chunks)
+    {
+        if (chunk->liveObjects > 0)
+        {
+            chunk->detached = true;
+        }
+        else
+        {
+            chunk->used     = 0;
+            _chunks[kept++] = chunk;
+        }
+    }
+    _chunks.resize(kept);
+    _currentChunk = 0;
+}
+
+size_t FrameArena::getUsedSize() const
+{
+    size_t used = 0;
+    for (auto&& chunk : _chunks)
+    {
+        used += chunk->used;
+    }
+    return used;
+}
+
+size_t FrameArena::getCapacity() const
+{
+    size_t capacity = 0;
+    for (auto&& chunk : _chunks)
+    {
+        capacity += chunk->capacity;
+    }
+    return capacity;
+}
+
+NS_CC_END
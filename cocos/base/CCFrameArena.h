@@ -0,0 +1,189 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/CCRef.h"
+#include "base/ccMacros.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class FrameArena
+ * @brief Opt-in allocator for short-lived Ref objects, such as instant actions or custom events, which live for the
+ * current frame only.
+ * Objects are placed into large chunks instead of being allocated one by one, and instead of being autoreleased they
+ * are released all at once by Director at the end of the frame, after the autorelease pool. An object still retained
+ * by something else at that time escapes: it stays valid until it is released, but its chunk can't be reused until
+ * then, and a warning is logged in debug builds.
+ * Never call autorelease() on an object of the arena, nor release it more times than it was retained.
+ * The arena is only used from the cocos thread.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL FrameArena
+{
+    template <typename T>
+    class Object;
+
+public:
+    /** Size of the chunks objects are placed into, a larger object gets a chunk of its own. */
+    static const size_t CHUNK_SIZE = 64 * 1024;
+
+    /**
+     * Refers to an object of the arena, and detects uses after the frame of the object.
+     * get() returns nullptr once the arena was reset, even if the object escaped.
+     */
+    template <typename T>
+    class Handle
+    {
+    public:
+        Handle() : _object(nullptr), _generation(0) {}
+
+        T* get() const
+        {
+            return _object && _generation == FrameArena::getInstance()->getGeneration() ? _object : nullptr;
+        }
+        T* operator->() const
+        {
+            auto object = get();
+            CCASSERT(object, "The handle was used after the frame of its object");
+            return object;
+        }
+        explicit operator bool() const { return get() != nullptr; }
+
+    private:
+        friend class FrameArena;
+        Handle(T* object, uint32_t generation) : _object(object), _generation(generation) {}
+
+        T* _object;
+        uint32_t _generation;
+    };
+
+    static FrameArena* getInstance();
+    static void destroyInstance();
+
+    /**
+     * Creates an object of the arena with a reference count of 1, owned by the arena until the end of the frame.
+     * The arguments are forwarded to the constructor of T, which may be protected.
+     */
+    template <typename T, typename... _Args>
+    T* create(_Args&&... args)
+    {
+        static_assert(std::is_base_of<Ref, T>::value, "Only Ref objects can be created in the frame arena");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "The object is over aligned");
+
+        void* memory = allocate(sizeof(Object<T>));
+        auto object  = ::new (memory) Object<T>(std::forward<_Args>(args)...);
+        track(memory, static_cast<Ref*>(object));
+        return object;
+    }
+
+    /** Returns a handle to an object created by this arena in the current frame. */
+    template <typename T>
+    Handle<T> getHandle(T* object) const
+    {
+        return Handle<T>(object, _generation);
+    }
+
+    /** Releases the objects of the frame and reuses their chunks, called by Director at the end of every frame. */
+    void reset();
+
+    /** Incremented by every reset(), handles of older generations are invalid. */
+    uint32_t getGeneration() const { return _generation; }
+
+    /** Returns the number of objects created in the current frame. */
+    size_t getObjectCount() const { return _objects.size(); }
+
+    /** Returns the number of objects created in the previous frame. */
+    size_t getLastFrameObjectCount() const { return _lastFrameObjectCount; }
+
+    /** Returns the number of bytes used by the objects of the current frame. */
+    size_t getUsedSize() const;
+
+    /** Returns the number of bytes of the chunks owned by the arena, without the chunks kept by escaped objects. */
+    size_t getCapacity() const;
+
+    /** Returns the number of objects which escaped since the arena was created. */
+    size_t getEscapedObjectCount() const { return _escapedObjectCount; }
+
+protected:
+    struct Chunk
+    {
+        size_t capacity;
+        size_t used;
+        size_t liveObjects;
+        bool detached;  // dropped by the arena with escaped objects, freed with its last object
+    };
+
+    struct ObjectHeader
+    {
+        Chunk* chunk;
+        Ref* object;
+        bool alive;
+    };
+
+    FrameArena();
+    ~FrameArena();
+
+    void* allocate(size_t size);
+    void track(void* memory, Ref* object);
+    static void onObjectDeleted(void* memory);
+
+    std::vector<Chunk*> _chunks;
+    size_t _currentChunk;
+    std::vector<ObjectHeader*> _objects;
+    uint32_t _generation;
+    size_t _lastFrameObjectCount;
+    size_t _escapedObjectCount;
+};
+
+/**
+ * The most derived type of an object of the arena, which destroys it in place when Ref::release() deletes it: the
+ * memory belongs to the chunk.
+ */
+template <typename T>
+class FrameArena::Object final : public T
+{
+public:
+    template <typename... _Args>
+    explicit Object(_Args&&... args) : T(std::forward<_Args>(args)...)
+    {}
+
+    static void operator delete(void* memory) { FrameArena::onObjectDeleted(memory); }
+};
+
+NS_CC_END
+// end group
+/// @}
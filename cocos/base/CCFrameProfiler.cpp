@@ -0,0 +1,224 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCFrameProfiler.h"
+#include "platform/CCFileUtils.h"
+#include "base/ccUTF8.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+NS_CC_BEGIN
+
+std::atomic<bool> FrameProfiler::s_enabled{false};
+
+thread_local FrameProfiler::ThreadBuffer* FrameProfiler::s_threadBuffer = nullptr;
+
+static void appendJsonString(std::string& out, const char* str)
+{
+    out += '"';
+    for (; *str; ++str)
+    {
+        const char c = *str;
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if ((unsigned char)c < 0x20)
+            out += ' ';
+        else
+            out += c;
+    }
+    out += '"';
+}
+
+FrameProfiler* FrameProfiler::getInstance()
+{
+    // zones may be recorded by any thread, a function local static is initialized once
+    static FrameProfiler instance;
+    return &instance;
+}
+
+void FrameProfiler::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+int64_t FrameProfiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+FrameProfiler::ThreadBuffer* FrameProfiler::getThreadBuffer()
+{
+    if (!s_threadBuffer)
+    {
+        // buffers outlive their thread, so that the zones of finished tasks can still be exported
+        std::lock_guard<std::mutex> lock(_buffersMutex);
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->events.resize(EVENTS_PER_THREAD);
+        buffer->tid    = (int)_buffers.size();
+        s_threadBuffer = buffer.get();
+        _buffers.push_back(std::move(buffer));
+    }
+    return s_threadBuffer;
+}
+
+void FrameProfiler::setThreadName(std::string_view name)
+{
+    auto buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    buffer->name = name;
+}
+
+void FrameProfiler::record(const Event& event)
+{
+    // only contended while exporting
+    auto buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    buffer->events[buffer->next] = event;
+    if (++buffer->next == buffer->events.size())
+    {
+        buffer->next    = 0;
+        buffer->wrapped = true;
+    }
+}
+
+void FrameProfiler::addZone(const char* name, int64_t start, int64_t end)
+{
+    record({name, start, end - start});
+}
+
+void FrameProfiler::addCounter(const char* name, int64_t value)
+{
+    if (isEnabled())
+        record({name, now(), value, true});
+}
+
+void FrameProfiler::markFrame(unsigned int frame)
+{
+    if (isEnabled())
+        record({nullptr, now(), (int64_t)frame});
+}
+
+void FrameProfiler::clear()
+{
+    std::lock_guard<std::mutex> lock(_buffersMutex);
+    for (auto& buffer : _buffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->next    = 0;
+        buffer->wrapped = false;
+    }
+}
+
+std::string FrameProfiler::toChromeTrace()
+{
+    struct ThreadEvents
+    {
+        int tid;
+        std::string name;
+        std::vector<Event> events;
+    };
+    std::vector<ThreadEvents> threads;
+    {
+        std::lock_guard<std::mutex> lock(_buffersMutex);
+        for (auto& buffer : _buffers)
+        {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            ThreadEvents thread{buffer->tid, buffer->name, {}};
+            if (buffer->wrapped)
+                thread.events.assign(buffer->events.begin() + buffer->next, buffer->events.end());
+            thread.events.insert(thread.events.end(), buffer->events.begin(), buffer->events.begin() + buffer->next);
+            threads.push_back(std::move(thread));
+        }
+    }
+
+    // timestamps are exported in microseconds from the oldest event
+    int64_t origin = std::numeric_limits<int64_t>::max();
+    for (auto& thread : threads)
+        for (auto& e : thread.events)
+            origin = std::min(origin, e.start);
+
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first      = true;
+    char buf[160];
+    for (auto& thread : threads)
+    {
+        if (!first)
+            out += ',';
+        first = false;
+        snprintf(buf, sizeof(buf), "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                 thread.tid);
+        out += buf;
+        if (thread.name.empty())
+            thread.name = StringUtils::format("Thread %d", thread.tid);
+        appendJsonString(out, thread.name.c_str());
+        out += "}}";
+
+        for (auto& e : thread.events)
+        {
+            const double ts = (e.start - origin) / 1000.0;
+            if (e.counter)
+            {
+                out += ",{\"ph\":\"C\",\"name\":";
+                appendJsonString(out, e.name);
+                snprintf(buf, sizeof(buf), ",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"value\":%lld}}", thread.tid,
+                         ts, (long long)e.duration);
+            }
+            else if (e.name)
+            {
+                out += ",{\"ph\":\"X\",\"name\":";
+                appendJsonString(out, e.name);
+                snprintf(buf, sizeof(buf), ",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", thread.tid, ts,
+                         e.duration / 1000.0);
+            }
+            else
+            {
+                snprintf(buf, sizeof(buf),
+                         ",{\"ph\":\"i\",\"s\":\"g\",\"name\":\"Frame\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,"
+                         "\"args\":{\"frame\":%lld}}",
+                         thread.tid, ts, (long long)e.duration);
+            }
+            out += buf;
+        }
+    }
+    out += "]}";
+    return out;
+}
+
+bool FrameProfiler::saveChromeTrace(std::string_view path)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string fullPath{path};
+    if (!fileUtils->isAbsolutePath(path))
+        fullPath = fileUtils->getWritablePath() + fullPath;
+    return fileUtils->writeStringToFile(toChromeTrace(), fullPath);
+}
+
+NS_CC_END
@@ -0,0 +1,147 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "platform/CCPlatformMacros.h"
+#include "base/ccConfig.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class FrameProfiler
+ * @brief Records timed zones per thread into ring buffers, with frame markers and counters, and exports them in the
+ * Chrome trace event format (chrome://tracing, Perfetto).
+ * Zones are recorded with `CC_PROFILE_ZONE`, which costs a relaxed atomic load while the profiler is disabled.
+ * Zone names are stored as pointers, so they must be string literals or outlive the profiler.
+ * @js NA
+ */
+class CC_DLL FrameProfiler
+{
+public:
+    /** Number of zones kept per thread, the oldest ones are overwritten. */
+    static const size_t EVENTS_PER_THREAD = 65536;
+
+    static FrameProfiler* getInstance();
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    /** Starts or stops recording, recorded zones are kept. Disabled by default. */
+    void setEnabled(bool enabled);
+
+    /** Returns the time used by the zones, in nanoseconds. */
+    static int64_t now();
+
+    /** Names the calling thread in the exported trace. */
+    void setThreadName(std::string_view name);
+
+    /** Records a zone of the calling thread, times are from `now()`. */
+    void addZone(const char* name, int64_t start, int64_t end);
+
+    /** Records the value of a counter, such as a memory size, shown as a graph by the trace viewers. */
+    void addCounter(const char* name, int64_t value);
+
+    /** Marks the end of a frame, called by Director. */
+    void markFrame(unsigned int frame);
+
+    /** Discards all recorded zones. */
+    void clear();
+
+    /** Returns the recorded zones as Chrome trace event JSON. */
+    std::string toChromeTrace();
+
+    /**
+     * Saves the recorded zones as Chrome trace event JSON.
+     * @param path A full path, or a path relative to the writable path.
+     */
+    bool saveChromeTrace(std::string_view path);
+
+protected:
+    struct Event
+    {
+        const char* name;  // nullptr for a frame marker
+        int64_t start;
+        int64_t duration;  // the frame number for a frame marker, the value for a counter
+        bool counter = false;
+    };
+    struct ThreadBuffer
+    {
+        std::mutex mutex;
+        std::vector<Event> events;
+        size_t next  = 0;
+        bool wrapped = false;
+        int tid      = 0;
+        std::string name;
+    };
+
+    ThreadBuffer* getThreadBuffer();
+    void record(const Event& event);
+
+    static std::atomic<bool> s_enabled;
+    static thread_local ThreadBuffer* s_threadBuffer;
+
+    std::mutex _buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> _buffers;
+};
+
+/** Records the lifetime of a scope as a zone of the calling thread. */
+class FrameProfilerZone
+{
+public:
+    explicit FrameProfilerZone(const char* name)
+        : _name(name), _start(FrameProfiler::isEnabled() ? FrameProfiler::now() : -1)
+    {}
+    ~FrameProfilerZone()
+    {
+        if (_start >= 0)
+            FrameProfiler::getInstance()->addZone(_name, _start, FrameProfiler::now());
+    }
+
+private:
+    const char* _name;
+    int64_t _start;
+};
+
+NS_CC_END
+// end of base group
+/// @}
+
+#if CC_ENABLE_FRAME_PROFILER
+    #define CC_PROFILE_ZONE_CONCAT_(a, b) a##b
+    #define CC_PROFILE_ZONE_CONCAT(a, b) CC_PROFILE_ZONE_CONCAT_(a, b)
+    #define CC_PROFILE_ZONE(__name__) \
+        NS_CC::FrameProfilerZone CC_PROFILE_ZONE_CONCAT(__frameProfilerZone, __LINE__)(__name__)
+#else
+    #define CC_PROFILE_ZONE(__name__)
+#endif
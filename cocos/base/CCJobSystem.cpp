@@ -0,0 +1,339 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCJobSystem.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "base/CCFrameProfiler.h"
+#include "base/ccMacros.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+NS_CC_BEGIN
+
+static const int PRIORITY_COUNT = 3;
+
+// the queue owned by the current thread if it is a worker, jobs it schedules go there first
+static thread_local JobSystem* t_jobSystem = nullptr;
+static thread_local int t_workerIndex      = -1;
+
+struct JobSystem::Job
+{
+    std::function<void()> function;
+    std::shared_ptr<std::atomic<bool>> canceled;
+    int priority;
+    bool mainThread;
+    // unfinished dependencies, plus one held by createJob until they are all registered
+    std::atomic<int> pendingDependencies{1};
+    std::atomic<bool> done{false};
+    // guards dependents against the job finishing while they are added
+    std::mutex mutex;
+    std::vector<std::shared_ptr<Job>> dependents;
+};
+
+bool JobSystem::JobHandle::isDone() const
+{
+    return !_job || _job->done.load(std::memory_order_acquire);
+}
+
+JobSystem* JobSystem::s_jobSystem = nullptr;
+
+// texture decoders get it from loading threads
+static std::mutex s_instanceMutex;
+
+JobSystem* JobSystem::getInstance()
+{
+    std::lock_guard<std::mutex> lck(s_instanceMutex);
+    if (s_jobSystem == nullptr)
+    {
+        s_jobSystem = new JobSystem();
+    }
+    return s_jobSystem;
+}
+
+void JobSystem::destroyInstance()
+{
+    JobSystem* jobSystem = nullptr;
+    {
+        std::lock_guard<std::mutex> lck(s_instanceMutex);
+        std::swap(jobSystem, s_jobSystem);
+    }
+    // deleted unlocked, the jobs it waits for may look the instance up
+    delete jobSystem;
+}
+
+JobSystem::JobSystem(int numThreads)
+{
+    if (numThreads < 0)
+        numThreads = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1);
+
+    // a pool without workers still needs one queue, the jobs are then run by the threads which wait for them
+    for (int i = 0; i < std::max(numThreads, 1); ++i)
+        _queues.emplace_back(new WorkQueue());
+    for (int i = 0; i < numThreads; ++i)
+        _threads.emplace_back(&JobSystem::run, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lck(_sleepMutex);
+        _stop = true;
+    }
+    _sleepCondition.notify_all();
+    for (auto&& t : _threads)
+        t.join();
+    _threads.clear();
+}
+
+JobSystem::JobHandle JobSystem::schedule(std::function<void()> job, Priority priority)
+{
+    return createJob(std::move(job), {}, priority, nullptr, false);
+}
+
+JobSystem::JobHandle JobSystem::schedule(std::function<void()> job,
+                                         const std::vector<JobHandle>& dependencies,
+                                         Priority priority,
+                                         const CancellationToken* token)
+{
+    return createJob(std::move(job), dependencies, priority, token, false);
+}
+
+JobSystem::JobHandle JobSystem::scheduleOnMainThread(std::function<void()> job,
+                                                     const std::vector<JobHandle>& dependencies,
+                                                     const CancellationToken* token)
+{
+    return createJob(std::move(job), dependencies, Priority::HIGH, token, true);
+}
+
+JobSystem::JobHandle JobSystem::createJob(std::function<void()> function,
+                                          const std::vector<JobHandle>& dependencies,
+                                          Priority priority,
+                                          const CancellationToken* token,
+                                          bool mainThread)
+{
+    auto job        = std::make_shared<Job>();
+    job->function   = std::move(function);
+    job->canceled   = token ? token->_canceled : nullptr;
+    job->priority   = static_cast<int>(priority);
+    job->mainThread = mainThread;
+
+    for (auto&& dependency : dependencies)
+    {
+        if (!dependency._job)
+            continue;
+
+        std::lock_guard<std::mutex> lck(dependency._job->mutex);
+        if (!dependency._job->done.load(std::memory_order_relaxed))
+        {
+            job->pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+            dependency._job->dependents.emplace_back(job);
+        }
+    }
+
+    if (job->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        submit(job);
+
+    return JobHandle(job);
+}
+
+void JobSystem::submit(const std::shared_ptr<Job>& job)
+{
+    if (job->mainThread)
+    {
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([this, job]() { execute(job); });
+        return;
+    }
+
+    int index = t_jobSystem == this ? t_workerIndex
+                                    : static_cast<int>(_nextQueue.fetch_add(1, std::memory_order_relaxed) %
+                                                       _queues.size());
+    {
+        auto& queue = *_queues[index];
+        std::lock_guard<std::mutex> lck(queue.mutex);
+        queue.jobs[job->priority].emplace_back(job);
+    }
+
+    // pairs with the check of _queuedJobs in run(), a worker either sees the job or is notified
+    _queuedJobs.fetch_add(1);
+    if (_sleepingWorkers.load() > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lck(_sleepMutex);
+        }
+        _sleepCondition.notify_one();
+    }
+    if (_waitingThreads.load() > 0)
+        _doneCondition.notify_all();
+}
+
+std::shared_ptr<JobSystem::Job> JobSystem::findJob(int queueIndex)
+{
+    const int count = static_cast<int>(_queues.size());
+    for (int priority = 0; priority < PRIORITY_COUNT; ++priority)
+    {
+        // newest job of the own queue first while it is still in cache, then the oldest jobs of the others
+        for (int i = 0; i < count; ++i)
+        {
+            auto& queue = *_queues[(queueIndex + i) % count];
+            std::lock_guard<std::mutex> lck(queue.mutex);
+            auto& jobs = queue.jobs[priority];
+            if (jobs.empty())
+                continue;
+
+            std::shared_ptr<Job> job;
+            if (i == 0 && t_jobSystem == this)
+            {
+                job = std::move(jobs.back());
+                jobs.pop_back();
+            }
+            else
+            {
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            _queuedJobs.fetch_sub(1);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(const std::shared_ptr<Job>& job)
+{
+    if (!job->canceled || !job->canceled->load(std::memory_order_relaxed))
+    {
+        job->function();
+    }
+    // release what the function captured before the dependents run
+    job->function = nullptr;
+    finish(job);
+}
+
+void JobSystem::finish(const std::shared_ptr<Job>& job)
+{
+    std::vector<std::shared_ptr<Job>> dependents;
+    {
+        std::lock_guard<std::mutex> lck(job->mutex);
+        job->done.store(true, std::memory_order_release);
+        dependents.swap(job->dependents);
+    }
+
+    for (auto&& dependent : dependents)
+    {
+        if (dependent->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            submit(dependent);
+    }
+
+    if (_waitingThreads.load() > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lck(_doneMutex);
+        }
+        _doneCondition.notify_all();
+    }
+}
+
+void JobSystem::wait(const JobHandle& handle)
+{
+    int queueIndex = t_jobSystem == this ? t_workerIndex : 0;
+    while (!handle.isDone())
+    {
+        if (auto job = findJob(queueIndex))
+        {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lck(_doneMutex);
+        _waitingThreads.fetch_add(1);
+        // the timeout covers jobs submitted without a notification while this thread was searching
+        _doneCondition.wait_for(lck, std::chrono::milliseconds(1),
+                                [&] { return handle.isDone() || _queuedJobs.load() > 0; });
+        _waitingThreads.fetch_sub(1);
+    }
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, const RangeFunc& func, Priority priority)
+{
+    if (count == 0)
+        return;
+
+    grain = std::max<size_t>(grain, 1);
+    const size_t ranges = (count + grain - 1) / grain;
+    if (_threads.empty() || ranges == 1)
+    {
+        func(0, count);
+        return;
+    }
+
+    // every job drains ranges from a shared cursor, so late jobs find nothing left and return at once
+    std::atomic<size_t> nextIndex{0};
+    auto drain = [&]() {
+        for (;;)
+        {
+            const size_t begin = nextIndex.fetch_add(grain, std::memory_order_relaxed);
+            if (begin >= count)
+                break;
+            func(begin, std::min(begin + grain, count));
+        }
+    };
+
+    const size_t helpers = std::min(ranges - 1, _threads.size());
+    std::vector<JobHandle> handles;
+    handles.reserve(helpers);
+    for (size_t i = 0; i < helpers; ++i)
+        handles.emplace_back(schedule(drain, priority));
+
+    drain();
+
+    for (auto&& handle : handles)
+        wait(handle);
+}
+
+void JobSystem::run(int index)
+{
+    t_jobSystem   = this;
+    t_workerIndex = index;
+    FrameProfiler::getInstance()->setThreadName("Job " + std::to_string(index));
+
+    for (;;)
+    {
+        if (auto job = findJob(index))
+        {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lck(_sleepMutex);
+        _sleepingWorkers.fetch_add(1);
+        _sleepCondition.wait(lck, [this] { return _stop || _queuedJobs.load() > 0; });
+        _sleepingWorkers.fetch_sub(1);
+        if (_stop)
+            return;
+    }
+}
+
+NS_CC_END
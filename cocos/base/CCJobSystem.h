@@ -0,0 +1,178 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "platform/CCPlatformMacros.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class JobSystem
+ * @brief A pool of worker threads sized to the hardware concurrency which run short jobs.
+ * Every worker owns a queue per priority and steals from the other workers once its own queues are empty. A job may
+ * depend on other jobs, be canceled before it starts, or run on the cocos thread as a continuation of worker jobs.
+ * @js NA
+ */
+class CC_DLL JobSystem
+{
+    struct Job;
+
+public:
+    enum class Priority
+    {
+        HIGH,
+        NORMAL,
+        LOW,
+    };
+
+    /**
+     * Shared cancellation flag, copies refer to the same flag.
+     * Jobs which haven't started when the token is canceled are skipped, their dependents still run.
+     */
+    class CC_DLL CancellationToken
+    {
+    public:
+        CancellationToken() : _canceled(std::make_shared<std::atomic<bool>>(false)) {}
+
+        void cancel() { _canceled->store(true, std::memory_order_relaxed); }
+        bool isCanceled() const { return _canceled->load(std::memory_order_relaxed); }
+
+    private:
+        friend class JobSystem;
+        std::shared_ptr<std::atomic<bool>> _canceled;
+    };
+
+    /** Refers to a scheduled job, used to wait for it or to make other jobs depend on it. */
+    class CC_DLL JobHandle
+    {
+    public:
+        JobHandle() {}
+
+        bool isValid() const { return _job != nullptr; }
+        /** Returns true once the job ran or was skipped, an invalid handle is always done. */
+        bool isDone() const;
+
+    private:
+        friend class JobSystem;
+        explicit JobHandle(std::shared_ptr<Job> job) : _job(std::move(job)) {}
+        std::shared_ptr<Job> _job;
+    };
+
+    typedef std::function<void(size_t begin, size_t end)> RangeFunc;
+
+    /** Returns the shared job system. */
+    static JobSystem* getInstance();
+
+    /** Destroys the shared job system, jobs which haven't started are dropped. */
+    static void destroyInstance();
+
+    /**
+     * @param numThreads Number of worker threads, a negative value uses one less than the hardware concurrency.
+     */
+    explicit JobSystem(int numThreads = -1);
+    ~JobSystem();
+
+    /** Schedules a job on the worker threads. */
+    JobHandle schedule(std::function<void()> job, Priority priority = Priority::NORMAL);
+
+    /**
+     * Schedules a job on the worker threads once all the dependencies are done.
+     * @param token The job is skipped if the token is canceled before it starts.
+     */
+    JobHandle schedule(std::function<void()> job,
+                       const std::vector<JobHandle>& dependencies,
+                       Priority priority = Priority::NORMAL,
+                       const CancellationToken* token = nullptr);
+
+    /**
+     * Schedules a job on the cocos thread once all the dependencies are done, the job is run by the scheduler of the
+     * director. Don't wait for such a job from the cocos thread.
+     */
+    JobHandle scheduleOnMainThread(std::function<void()> job,
+                                   const std::vector<JobHandle>& dependencies,
+                                   const CancellationToken* token = nullptr);
+
+    /** Waits for a job, the calling thread runs other jobs meanwhile. */
+    void wait(const JobHandle& handle);
+
+    /**
+     * Splits [0, count) into ranges of `grain` items, runs them on the workers and the calling thread and returns
+     * once every range is done.
+     */
+    void parallelFor(size_t count, size_t grain, const RangeFunc& func, Priority priority = Priority::HIGH);
+
+    /** Returns the number of worker threads. */
+    int getWorkerCount() const { return static_cast<int>(_threads.size()); }
+
+protected:
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<Job>> jobs[3];
+    };
+
+    JobHandle createJob(std::function<void()> job,
+                        const std::vector<JobHandle>& dependencies,
+                        Priority priority,
+                        const CancellationToken* token,
+                        bool mainThread);
+    void submit(const std::shared_ptr<Job>& job);
+    std::shared_ptr<Job> findJob(int queueIndex);
+    void execute(const std::shared_ptr<Job>& job);
+    void finish(const std::shared_ptr<Job>& job);
+    void run(int index);
+
+    std::vector<std::thread> _threads;
+    std::vector<std::unique_ptr<WorkQueue>> _queues;
+
+    std::atomic<unsigned int> _nextQueue{0};
+    std::atomic<int> _queuedJobs{0};
+    std::atomic<int> _sleepingWorkers{0};
+    std::atomic<int> _waitingThreads{0};
+
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+    std::mutex _doneMutex;
+    std::condition_variable _doneCondition;
+    bool _stop = false;
+
+    static JobSystem* s_jobSystem;
+};
+
+NS_CC_END
+// end group
+/// @}
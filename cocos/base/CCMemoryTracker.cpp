@@ -0,0 +1,243 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCMemoryTracker.h"
+#include "base/CCFrameProfiler.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+static void updatePeak(std::atomic<int64_t>& peak, int64_t bytes)
+{
+    int64_t old = peak.load(std::memory_order_relaxed);
+    while (bytes > old && !peak.compare_exchange_weak(old, bytes, std::memory_order_relaxed))
+    {
+    }
+}
+
+static void appendSize(std::string& out, int64_t bytes)
+{
+    char buf[32];
+    if (bytes < 1024 * 1024)
+        snprintf(buf, sizeof(buf), "%12.2f KB", bytes / 1024.0);
+    else
+        snprintf(buf, sizeof(buf), "%12.2f MB", bytes / (1024.0 * 1024.0));
+    out += buf;
+}
+
+MemoryTracker* MemoryTracker::getInstance()
+{
+    // counters may be updated by any thread, a function local static is initialized once
+    static MemoryTracker instance;
+    return &instance;
+}
+
+MemoryTracker::MemoryTracker()
+{
+    addTag("Texture");
+    addTag("VertexData");
+    addTag("FontAtlas");
+    addTag("Audio");
+    addTag("SpriteFrame");
+    addTag("Script");
+}
+
+int MemoryTracker::addTag(std::string_view name)
+{
+    const int tag = _tagCount.load(std::memory_order_relaxed);
+    if (tag >= MAX_TAGS)
+        return -1;
+
+    _tags[tag].name = name;
+    // publishes the name to the threads which read the tag count
+    _tagCount.store(tag + 1, std::memory_order_release);
+    return tag;
+}
+
+int MemoryTracker::registerTag(std::string_view name)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const int tag = findTag(name);
+    return tag >= 0 ? tag : addTag(name);
+}
+
+int MemoryTracker::findTag(std::string_view name) const
+{
+    const int count = getTagCount();
+    for (int tag = 0; tag < count; ++tag)
+    {
+        if (_tags[tag].name == name)
+            return tag;
+    }
+    return -1;
+}
+
+const char* MemoryTracker::getTagName(int tag) const
+{
+    return tag >= 0 && tag < getTagCount() ? _tags[tag].name.c_str() : "";
+}
+
+void MemoryTracker::allocate(int tag, int64_t bytes)
+{
+    CCASSERT(tag >= 0 && tag < MAX_TAGS, "MemoryTracker: invalid tag");
+    auto& info = _tags[tag];
+    updatePeak(info.peak, info.current.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+void MemoryTracker::release(int tag, int64_t bytes)
+{
+    CCASSERT(tag >= 0 && tag < MAX_TAGS, "MemoryTracker: invalid tag");
+    _tags[tag].current.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+int64_t MemoryTracker::getCurrentBytes(int tag) const
+{
+    return tag >= 0 && tag < MAX_TAGS ? _tags[tag].current.load(std::memory_order_relaxed) : 0;
+}
+
+int64_t MemoryTracker::getPeakBytes(int tag) const
+{
+    return tag >= 0 && tag < MAX_TAGS ? _tags[tag].peak.load(std::memory_order_relaxed) : 0;
+}
+
+int64_t MemoryTracker::getTotalBytes() const
+{
+    int64_t total   = 0;
+    const int count = getTagCount();
+    for (int tag = 0; tag < count; ++tag)
+        total += getCurrentBytes(tag);
+    return total;
+}
+
+void MemoryTracker::resetPeaks()
+{
+    for (auto& info : _tags)
+        info.peak.store(info.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void MemoryTracker::setSampler(int tag, Sampler sampler)
+{
+    CCASSERT(tag >= 0 && tag < MAX_TAGS, "MemoryTracker: invalid tag");
+    std::lock_guard<std::mutex> lock(_mutex);
+    _tags[tag].sampler = std::move(sampler);
+}
+
+void MemoryTracker::setBudget(int tag, int64_t bytes, BudgetCallback onExceeded)
+{
+    CCASSERT(tag >= 0 && tag < MAX_TAGS, "MemoryTracker: invalid tag");
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto& info        = _tags[tag];
+    info.budget       = bytes;
+    info.lastExceeded = 0;
+    info.onExceeded   = bytes > 0 ? std::move(onExceeded) : nullptr;
+}
+
+int64_t MemoryTracker::getBudget(int tag) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return tag >= 0 && tag < MAX_TAGS ? _tags[tag].budget : 0;
+}
+
+void MemoryTracker::update()
+{
+    const int count = getTagCount();
+
+    // the budget callbacks run without the lock, they may release memory or change the budgets
+    int exceeded[MAX_TAGS];
+    int exceededCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (int tag = 0; tag < count; ++tag)
+        {
+            auto& info = _tags[tag];
+            if (info.sampler)
+            {
+                const int64_t bytes = info.sampler();
+                info.current.store(bytes, std::memory_order_relaxed);
+                updatePeak(info.peak, bytes);
+            }
+
+            const int64_t bytes = info.current.load(std::memory_order_relaxed);
+            if (info.budget <= 0 || bytes <= info.budget)
+                info.lastExceeded = 0;
+            else if (bytes > info.lastExceeded && info.onExceeded)
+                exceeded[exceededCount++] = tag;
+        }
+    }
+
+    for (int i = 0; i < exceededCount; ++i)
+    {
+        const int tag = exceeded[i];
+        BudgetCallback onExceeded;
+        int64_t budget = 0;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            onExceeded = _tags[tag].onExceeded;
+            budget     = _tags[tag].budget;
+        }
+        if (onExceeded)
+            onExceeded(tag, getCurrentBytes(tag), budget);
+
+        // called again only if the tag grows over what the callback couldn't evict
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tags[tag].lastExceeded = getCurrentBytes(tag);
+    }
+
+    if (FrameProfiler::isEnabled())
+    {
+        for (int tag = 0; tag < count; ++tag)
+            FrameProfiler::getInstance()->addCounter(_tags[tag].name.c_str(), getCurrentBytes(tag));
+    }
+}
+
+std::string MemoryTracker::dump() const
+{
+    std::string out;
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%-16s%15s%15s%15s\n", "Tag", "Current", "Peak", "Budget");
+    out += buf;
+
+    const int count = getTagCount();
+    for (int tag = 0; tag < count; ++tag)
+    {
+        snprintf(buf, sizeof(buf), "%-16s", _tags[tag].name.c_str());
+        out += buf;
+        appendSize(out, getCurrentBytes(tag));
+        appendSize(out, getPeakBytes(tag));
+        const int64_t budget = getBudget(tag);
+        if (budget > 0)
+            appendSize(out, budget);
+        else
+            out += "              -";
+        out += '\n';
+    }
+
+    snprintf(buf, sizeof(buf), "%-16s", "Total");
+    out += buf;
+    appendSize(out, getTotalBytes());
+    out += '\n';
+    return out;
+}
+
+NS_CC_END
@@ -0,0 +1,140 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "platform/CCPlatformMacros.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class MemoryTracker
+ * @brief Accounts the memory of the engine subsystems under named tags, with current and peak byte counters.
+ * Counters are updated with allocate() and release() from any thread, or sampled once per frame for subsystems which
+ * own their memory elsewhere, such as the Lua heap. Director calls update() at the end of every frame, which samples
+ * the counters, checks the soft budgets and exports the counters to the FrameProfiler while it is recording.
+ * Budgets don't limit anything, their callback is meant to evict caches, for example:
+ * @code
+ * MemoryTracker::getInstance()->setBudget(MemoryTracker::TAG_TEXTURE, 256 * 1024 * 1024, [](int, int64_t, int64_t) {
+ *     Director::getInstance()->getTextureCache()->removeUnusedTextures();
+ * });
+ * @endcode
+ * @js NA
+ */
+class CC_DLL MemoryTracker
+{
+public:
+    /** Tags of the engine, games register their own ones with registerTag(). */
+    enum Tag
+    {
+        TAG_TEXTURE,
+        TAG_VERTEX_DATA,
+        TAG_FONT_ATLAS,
+        TAG_AUDIO,
+        TAG_SPRITE_FRAME,
+        TAG_SCRIPT,
+        TAG_BUILTIN_COUNT
+    };
+
+    static const int MAX_TAGS = 32;
+
+    /** Called with the tag, its current bytes and its budget. */
+    typedef std::function<void(int tag, int64_t bytes, int64_t budget)> BudgetCallback;
+    /** Returns the current bytes of a sampled tag. */
+    typedef std::function<int64_t()> Sampler;
+
+    static MemoryTracker* getInstance();
+
+    /** Returns the tag with that name, it is created if needed. Returns -1 when all the tags are used. */
+    int registerTag(std::string_view name);
+    /** Returns the tag with that name, or -1. */
+    int findTag(std::string_view name) const;
+    int getTagCount() const { return _tagCount.load(std::memory_order_acquire); }
+    const char* getTagName(int tag) const;
+
+    /** Adds bytes to a tag, thread safe. */
+    void allocate(int tag, int64_t bytes);
+    /** Removes bytes from a tag, thread safe. */
+    void release(int tag, int64_t bytes);
+
+    int64_t getCurrentBytes(int tag) const;
+    int64_t getPeakBytes(int tag) const;
+    /** Returns the sum of the current bytes of all the tags. */
+    int64_t getTotalBytes() const;
+    /** Sets the peaks to the current bytes. */
+    void resetPeaks();
+
+    /**
+     * Sets the counter of a tag from a sampler on every update() instead of allocate() and release(). The sampler is
+     * called on the cocos thread, pass nullptr to remove it.
+     */
+    void setSampler(int tag, Sampler sampler);
+
+    /**
+     * Sets a soft budget, 0 removes it. The callback runs from update() when the tag is over budget, and again on
+     * later frames only if the tag grew since the last call.
+     */
+    void setBudget(int tag, int64_t bytes, BudgetCallback onExceeded);
+    int64_t getBudget(int tag) const;
+
+    /** Samples the counters, checks the budgets and exports the counters to the profiler, called by Director. */
+    void update();
+
+    /** Returns a table of the tags with their current, peak and budget sizes. */
+    std::string dump() const;
+
+protected:
+    struct TagInfo
+    {
+        std::string name;
+        std::atomic<int64_t> current{0};
+        std::atomic<int64_t> peak{0};
+        int64_t budget       = 0;
+        int64_t lastExceeded = 0;
+        BudgetCallback onExceeded;
+        Sampler sampler;
+    };
+
+    MemoryTracker();
+    int addTag(std::string_view name);
+
+    TagInfo _tags[MAX_TAGS];
+    std::atomic<int> _tagCount{0};
+    // guards the tag names, samplers and budgets
+    mutable std::mutex _mutex;
+};
+
+NS_CC_END
+// end of base group
+/// @}
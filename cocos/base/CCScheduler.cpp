@@ -29,12 +29,20 @@ THE SOFTWARE.
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
+#include "base/CCFrameProfiler.h"
 #include "uthash/utlist.h"
 #include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
 
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
 NS_CC_BEGIN
 
+// slots in the lock-free ring used by performFunctionInCocosThread, a full ring spills into a locked vector
+static const size_t PERFORM_QUEUE_CAPACITY = 1024;
+
 // data structures
 
 // A list double-linked list used for "updates with priority"
@@ -80,6 +88,8 @@ Timer::Timer()
     , _delay(0.0f)
     , _interval(0.0f)
     , _aborted(false)
+    , _queueTime(0.0)
+    , _queueIndex(QUEUE_NONE)
 {}
 
 void Timer::setupTimerWithInterval(float seconds, unsigned int repeat, float delay)
@@ -259,12 +269,21 @@ Scheduler::Scheduler()
     , _currentTarget(nullptr)
     , _currentTargetSalvaged(false)
     , _updateHashLocked(false)
+    , _timerQueueEnabled(false)
+    , _timerClock(0.0)
+    , _timerQueueOrder(0)
 #if CC_ENABLE_SCRIPT_BINDING
     , _scriptHandlerEntries(20)
 #endif
+    , _functionsToPerform(PERFORM_QUEUE_CAPACITY)
+    , _overflowFunctionCount(0)
+    , _pendingFunctionCount(0)
+    , _performGeneration(0)
+    , _performBudget(0)
+    , _deferredFunctionCount(0)
 {
     // I don't expect to have more than 30 functions to all per frame
-    _actionsToPerform.reserve(30);
+    _functionsRunning.reserve(30);
 }
 
 Scheduler::~Scheduler()
@@ -332,6 +351,11 @@ void Scheduler::schedule(const ccSchedulerFunc& callback,
                 CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval,
                       repeat, delay);
                 timer->setupTimerWithInterval(interval, repeat, delay);
+                if (timer->_queueIndex >= 0)
+                {
+                    dequeueTimer(timer);
+                    queueTimer(timer, element);
+                }
                 return;
             }
         }
@@ -342,6 +366,11 @@ void Scheduler::schedule(const ccSchedulerFunc& callback,
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
     ccArrayAppendObject(element->timers, timer);
     timer->release();
+
+    if (_timerQueueEnabled && !element->paused)
+    {
+        queueTimer(timer, element);
+    }
 }
 
 void Scheduler::unschedule(std::string_view key, void* target)
@@ -372,6 +401,7 @@ void Scheduler::unschedule(std::string_view key, void* target)
                     timer->setAborted();
                 }
 
+                dequeueTimer(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
 
                 // update timerIndex in case we are in tick:, looping over the actions
@@ -647,6 +677,13 @@ void Scheduler::unscheduleAllForTarget(void* target)
             element->currentTimer->retain();
             element->currentTimer->setAborted();
         }
+        if (_timerQueueEnabled)
+        {
+            for (int i = 0; i < element->timers->num; ++i)
+            {
+                dequeueTimer((Timer*)element->timers->arr[i]);
+            }
+        }
         ccArrayRemoveAllObjects(element->timers);
 
         if (_currentTarget == element)
@@ -695,7 +732,7 @@ void Scheduler::resumeTarget(void* target)
     HASH_FIND_PTR(_hashForTimers, &target, element);
     if (element)
     {
-        element->paused = false;
+        setTargetTimersPaused(element, false);
     }
 
     // update selector
@@ -717,7 +754,7 @@ void Scheduler::pauseTarget(void* target)
     HASH_FIND_PTR(_hashForTimers, &target, element);
     if (element)
     {
-        element->paused = true;
+        setTargetTimersPaused(element, true);
     }
 
     // update selector
@@ -765,7 +802,7 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     // Custom Selectors
     for (tHashTimerEntry* element = _hashForTimers; element != nullptr; element = (tHashTimerEntry*)element->hh.next)
     {
-        element->paused = true;
+        setTargetTimersPaused(element, true);
         idsWithSelectors.insert(element->target);
     }
 
@@ -814,19 +851,330 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
 
 void Scheduler::performFunctionInCocosThread(std::function<void()> action)
 {
+    // counted first so the main thread never sees fewer pending functions than it can pop
+    _pendingFunctionCount.fetch_add(1, std::memory_order_relaxed);
+
+    // once something spilled over, keep using the overflow until it is drained so the functions of one thread still
+    // run in the order they were queued
+    if (_overflowFunctionCount.load(std::memory_order_acquire) == 0 &&
+        _functionsToPerform.try_emplace(std::move(action)))
+    {
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(_performMutex);
-    _actionsToPerform.emplace_back(std::move(action));
+    _functionsOverflow.emplace_back(std::move(action));
+    _overflowFunctionCount.fetch_add(1, std::memory_order_release);
 }
 
 void Scheduler::removeAllPendingActions()
 {
     std::unique_lock<std::mutex> lock(_performMutex);
-    _actionsToPerform.clear();
+
+    size_t removed = _functionsDeferred.size() + _functionsOverflow.size();
+    std::function<void()> function;
+    while (_functionsToPerform.try_pop(function))
+    {
+        ++removed;
+    }
+    _functionsDeferred.clear();
+    _functionsOverflow.clear();
+    _overflowFunctionCount.store(0, std::memory_order_release);
+    // functions the main thread is running right now but hasn't reached yet are dropped too
+    _performGeneration.fetch_add(1, std::memory_order_release);
+
+    _pendingFunctionCount.fetch_sub(removed, std::memory_order_relaxed);
+}
+
+void Scheduler::performFunctions()
+{
+    unsigned int generation;
+    {
+        std::lock_guard<std::mutex> lock(_performMutex);
+
+        // fixed #4123: the functions must be invoked after '_performMutex' is unlocked, otherwise if new functions are
+        // added in a callback, it will cause thread deadlock.
+        _functionsRunning.swap(_functionsDeferred);
+        for (size_t count = _functionsToPerform.capacity(); count > 0; --count)
+        {
+            _functionsRunning.emplace_back();
+            if (!_functionsToPerform.try_pop(_functionsRunning.back()))
+            {
+                _functionsRunning.pop_back();
+                break;
+            }
+        }
+        // the overflow only follows once every slot claimed before it was popped, otherwise it waits a frame
+        if (!_functionsOverflow.empty() && _functionsToPerform.size_approx() == 0)
+        {
+            std::move(_functionsOverflow.begin(), _functionsOverflow.end(), std::back_inserter(_functionsRunning));
+            _functionsOverflow.clear();
+            _overflowFunctionCount.store(0, std::memory_order_release);
+        }
+        generation = _performGeneration.load(std::memory_order_relaxed);
+    }
+
+    auto start   = std::chrono::steady_clock::now();
+    size_t count = _functionsRunning.size();
+    size_t index = 0;
+    while (index < count)
+    {
+        _functionsRunning[index++]();
+
+        // a function, or another thread, called removeAllPendingActions(), the rest of the batch is dropped below
+        if (_performGeneration.load(std::memory_order_acquire) != generation)
+            break;
+
+        if (_performBudget > 0 &&
+            std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() >= _performBudget)
+        {
+            break;
+        }
+    }
+    _pendingFunctionCount.fetch_sub(index, std::memory_order_relaxed);
+
+    _deferredFunctionCount = count - index;
+    if (_deferredFunctionCount > 0)
+    {
+        std::lock_guard<std::mutex> lock(_performMutex);
+        if (generation == _performGeneration.load(std::memory_order_relaxed))
+        {
+            std::move(_functionsRunning.begin() + index, _functionsRunning.end(),
+                      std::back_inserter(_functionsDeferred));
+        }
+        else
+        {
+            // removeAllPendingActions() was called meanwhile, drop the rest as well
+            _pendingFunctionCount.fetch_sub(_deferredFunctionCount, std::memory_order_relaxed);
+            _deferredFunctionCount = 0;
+        }
+    }
+    _functionsRunning.clear();
+}
+
+void Scheduler::setTimerQueueEnabled(bool enabled)
+{
+    CCASSERT(!_updateHashLocked, "The timer queue can't be switched while the timers are updated");
+
+    if (_timerQueueEnabled == enabled)
+    {
+        return;
+    }
+
+    _timerQueueEnabled = enabled;
+    for (tHashTimerEntry* element = _hashForTimers; element != nullptr; element = (tHashTimerEntry*)element->hh.next)
+    {
+        if (!enabled)
+        {
+            dequeueTargetTimers(element);
+        }
+        else if (!element->paused)
+        {
+            queueTargetTimers(element);
+        }
+    }
+}
+
+void Scheduler::setTargetTimersPaused(tHashTimerEntry* element, bool paused)
+{
+    if (element->paused == paused)
+    {
+        return;
+    }
+
+    element->paused = paused;
+    if (_timerQueueEnabled)
+    {
+        // paused timers leave the queue, so that the paused time isn't counted
+        if (paused)
+            dequeueTargetTimers(element);
+        else
+            queueTargetTimers(element);
+    }
+}
+
+void Scheduler::queueTargetTimers(tHashTimerEntry* element)
+{
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer* timer = (Timer*)element->timers->arr[i];
+        if (timer->_queueIndex == Timer::QUEUE_NONE)
+        {
+            queueTimer(timer, element);
+        }
+    }
+}
+
+void Scheduler::dequeueTargetTimers(tHashTimerEntry* element)
+{
+    // pending timers are skipped, they are queued again depending on the pause state of their target
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer* timer = (Timer*)element->timers->arr[i];
+        if (timer->_queueIndex >= 0)
+        {
+            dequeueTimer(timer);
+        }
+    }
+}
+
+void Scheduler::queueTimer(Timer* timer, tHashTimerEntry* element)
+{
+    // the due time follows Timer::update(), whose first call only starts the timer
+    double remaining = 0.0;
+    if (timer->_elapsed != -1)
+    {
+        if (timer->_useDelay)
+            remaining = timer->_delay - timer->_elapsed;
+        else if (timer->_interval > 0)
+            remaining = timer->_interval - timer->_elapsed;
+    }
+
+    int index          = (int)_timerQueue.size();
+    timer->_queueTime  = _timerClock;
+    timer->_queueIndex = index;
+    _timerQueue.push_back({_timerClock + std::max(remaining, 0.0), _timerQueueOrder++, timer, element});
+    siftTimerUp(index);
+}
+
+void Scheduler::dequeueTimer(Timer* timer)
+{
+    if (timer->_queueIndex >= 0)
+    {
+        // catch up with the time spent in the queue, the timer wasn't due yet
+        if (timer->_elapsed != -1)
+        {
+            timer->_elapsed += (float)(_timerClock - timer->_queueTime);
+        }
+        eraseTimerQueueEntry(timer->_queueIndex);
+    }
+    timer->_queueIndex = Timer::QUEUE_NONE;
+}
+
+void Scheduler::eraseTimerQueueEntry(int index)
+{
+    int last = (int)_timerQueue.size() - 1;
+    if (index != last)
+    {
+        _timerQueue[index]                    = _timerQueue[last];
+        _timerQueue[index].timer->_queueIndex = index;
+    }
+    _timerQueue.pop_back();
+
+    if (index < last)
+    {
+        siftTimerDown(index);
+        siftTimerUp(index);
+    }
+}
+
+void Scheduler::siftTimerUp(int index)
+{
+    auto entry = _timerQueue[index];
+    while (index > 0)
+    {
+        int parent = (index - 1) / 2;
+        if (!(entry < _timerQueue[parent]))
+        {
+            break;
+        }
+        _timerQueue[index]                    = _timerQueue[parent];
+        _timerQueue[index].timer->_queueIndex = index;
+        index                                 = parent;
+    }
+    _timerQueue[index]       = entry;
+    entry.timer->_queueIndex = index;
+}
+
+void Scheduler::siftTimerDown(int index)
+{
+    int size   = (int)_timerQueue.size();
+    auto entry = _timerQueue[index];
+    for (;;)
+    {
+        int child = index * 2 + 1;
+        if (child >= size)
+        {
+            break;
+        }
+        if (child + 1 < size && _timerQueue[child + 1] < _timerQueue[child])
+        {
+            ++child;
+        }
+        if (!(_timerQueue[child] < entry))
+        {
+            break;
+        }
+        _timerQueue[index]                    = _timerQueue[child];
+        _timerQueue[index].timer->_queueIndex = index;
+        index                                 = child;
+    }
+    _timerQueue[index]       = entry;
+    entry.timer->_queueIndex = index;
+}
+
+void Scheduler::updateTimerQueue(float dt)
+{
+    _timerClock += dt;
+
+    while (!_timerQueue.empty() && _timerQueue.front().due <= _timerClock)
+    {
+        auto entry = _timerQueue.front();
+        eraseTimerQueueEntry(0);
+
+        Timer* timer       = entry.timer;
+        timer->_queueIndex = Timer::QUEUE_PENDING;
+
+        _currentTarget         = entry.element;
+        _currentTargetSalvaged = false;
+
+        _currentTarget->currentTimer = timer;
+        CCASSERT(!timer->isAborted(), "An aborted timer should not be updated");
+
+        timer->update((float)(_timerClock - timer->_queueTime));
+        timer->_queueTime = _timerClock;
+
+        if (timer->isAborted())
+        {
+            // unscheduled during its step, it was retained like in the target walk
+            timer->release();
+        }
+        else if (timer->_queueIndex == Timer::QUEUE_PENDING)
+        {
+            timer->retain();
+            _timersToRequeue.emplace_back(entry);
+        }
+
+        _currentTarget->currentTimer = nullptr;
+        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
+        {
+            removeHashElement(_currentTarget);
+        }
+        _currentTarget = nullptr;
+    }
+
+    // triggered timers are queued again afterwards, so that a timer is updated at most once per frame
+    for (auto&& entry : _timersToRequeue)
+    {
+        Timer* timer = entry.timer;
+        if (timer->_queueIndex == Timer::QUEUE_PENDING)
+        {
+            timer->_queueIndex = Timer::QUEUE_NONE;
+            if (!entry.element->paused)
+            {
+                queueTimer(timer, entry.element);
+            }
+        }
+        timer->release();
+    }
+    _timersToRequeue.clear();
 }
 
 // main loop
 void Scheduler::update(float dt)
 {
+    CC_PROFILE_ZONE("Scheduler::update");
+
     _updateHashLocked = true;
 
     if (_timeScale != 1.0f)
@@ -868,42 +1216,49 @@ void Scheduler::update(float dt)
         }
     }
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry* elt = _hashForTimers; elt != nullptr;)
+    // Iterate over all the custom selectors, only the due ones when they are queued
+    if (_timerQueueEnabled)
     {
-        _currentTarget         = elt;
-        _currentTargetSalvaged = false;
-
-        if (!_currentTarget->paused)
+        updateTimerQueue(dt);
+    }
+    else
+    {
+        for (tHashTimerEntry* elt = _hashForTimers; elt != nullptr;)
         {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
+            _currentTarget         = elt;
+            _currentTargetSalvaged = false;
+
+            if (!_currentTarget->paused)
             {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                CCASSERT(!elt->currentTimer->isAborted(), "An aborted timer should not be updated");
+                // The 'timers' array may change while inside this loop
+                for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
+                {
+                    elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
+                    CCASSERT(!elt->currentTimer->isAborted(), "An aborted timer should not be updated");
 
-                elt->currentTimer->update(dt);
+                    elt->currentTimer->update(dt);
 
-                if (elt->currentTimer->isAborted())
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
+                    if (elt->currentTimer->isAborted())
+                    {
+                        // The currentTimer told the remove itself. To prevent the timer from
+                        // accidentally deallocating itself before finishing its step, we retained
+                        // it. Now that step is done, it's safe to release it.
+                        elt->currentTimer->release();
+                    }
 
-                elt->currentTimer = nullptr;
+                    elt->currentTimer = nullptr;
+                }
             }
-        }
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry*)elt->hh.next;
+            // elt, at this moment, is still valid
+            // so it is safe to ask this here (issue #490)
+            elt = (tHashTimerEntry*)elt->hh.next;
 
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
-        {
-            removeHashElement(_currentTarget);
+            // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
+            if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
+            {
+                removeHashElement(_currentTarget);
+            }
         }
     }
 
@@ -942,20 +1297,12 @@ void Scheduler::update(float dt)
     // Functions allocated from another thread
     //
 
-    // Testing size is faster than locking / unlocking.
+    // Testing the counter is faster than locking / unlocking.
     // And almost never there will be functions scheduled to be called.
-    if (!_actionsToPerform.empty())
+    if (_pendingFunctionCount.load(std::memory_order_relaxed) > 0)
     {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if
-        // new functions are added in callback, it will cause thread deadlock.
-        auto temp = std::move(_actionsToPerform);
-        _performMutex.unlock();
-
-        for (const auto& function : temp)
-        {
-            function();
-        }
+        CC_PROFILE_ZONE("Scheduler::performFunctions");
+        performFunctions();
     }
 }
 
@@ -1001,6 +1348,11 @@ void Scheduler::schedule(SEL_SCHEDULE selector,
                 CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval,
                       repeat, delay);
                 timer->setupTimerWithInterval(interval, repeat, delay);
+                if (timer->_queueIndex >= 0)
+                {
+                    dequeueTimer(timer);
+                    queueTimer(timer, element);
+                }
                 return;
             }
         }
@@ -1011,6 +1363,11 @@ void Scheduler::schedule(SEL_SCHEDULE selector,
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
     ccArrayAppendObject(element->timers, timer);
     timer->release();
+
+    if (_timerQueueEnabled && !element->paused)
+    {
+        queueTimer(timer, element);
+    }
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref* target, float interval, bool paused)
@@ -1074,6 +1431,7 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref* target)
                     timer->setAborted();
                 }
 
+                dequeueTimer(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
 
                 // update timerIndex in case we are in tick:, looping over the actions
@@ -29,12 +29,14 @@ THE SOFTWARE.
 #ifndef __CCSCHEDULER_H__
 #define __CCSCHEDULER_H__
 
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <set>
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
+#include "base/MPSCQueue.h"
 #include "uthash/uthash.h"
 
 NS_CC_BEGIN
@@ -73,6 +75,16 @@ protected:
     float _delay;
     float _interval;
     bool _aborted;
+
+    // timer queue state, see Scheduler::setTimerQueueEnabled()
+    friend class Scheduler;
+    enum
+    {
+        QUEUE_NONE    = -1,  // not in the queue
+        QUEUE_PENDING = -2,  // popped by Scheduler::update(), queued again once it has been triggered
+    };
+    double _queueTime;  // scheduler clock at which _elapsed was last brought up to date
+    int _queueIndex;    // index in the queue, or one of the states above
 };
 
 class CC_DLL TimerTargetSelector : public Timer
@@ -218,6 +230,17 @@ public:
     */
     void setTimeScale(float timeScale) { _timeScale = timeScale; }
 
+    /** Moves the interval timers into a queue ordered by their next trigger time, so that update() only touches the
+     * timers that are due instead of walking every timer of every target.
+     * Timers that are due in the same frame are triggered in time order rather than grouped by target.
+     * Worth enabling with thousands of timers. Disabled by default.
+     * @param enabled Whether the timer queue is used, it can be switched at any time outside of update().
+     */
+    void setTimerQueueEnabled(bool enabled);
+
+    /** Whether the interval timers are kept in a queue ordered by their next trigger time. */
+    bool isTimerQueueEnabled() const { return _timerQueueEnabled; }
+
     /** 'update' the scheduler.
      * You should NEVER call this method, unless you know what you are doing.
      * @lua NA
@@ -461,6 +484,29 @@ public:
     void removeAllPendingActions();
     CC_DEPRECATED_ATTRIBUTE void removeAllFunctionsToBePerformedInCocosThread() { removeAllPendingActions(); }
 
+    /**
+     * Limits the time spent each frame running the functions queued with performFunctionInCocosThread.
+     * Functions left over when the budget is used up run first in the next frame, at least one function runs per
+     * frame.
+     * @param seconds Time budget in seconds, 0 (the default) runs every queued function.
+     * @js NA
+     */
+    void setPerformFunctionsBudget(float seconds) { _performBudget = seconds; }
+    float getPerformFunctionsBudget() const { return _performBudget; }
+
+    /**
+     * Returns the number of functions queued with performFunctionInCocosThread which haven't run yet.
+     * This function is thread safe.
+     * @js NA
+     */
+    size_t getPendingFunctionCount() const { return _pendingFunctionCount.load(std::memory_order_relaxed); }
+
+    /**
+     * Returns the number of functions the last frame pushed to the next one because of the time budget.
+     * @js NA
+     */
+    size_t getDeferredFunctionCount() const { return _deferredFunctionCount; }
+
 protected:
     /** Schedules the 'callback' function for a given target with a given priority.
      The 'callback' selector will be called every frame.
@@ -479,6 +525,33 @@ protected:
     void priorityIn(struct _listEntry** list, const ccSchedulerFunc& callback, void* target, int priority, bool paused);
     void appendIn(struct _listEntry** list, const ccSchedulerFunc& callback, void* target, bool paused);
 
+    // timer queue specific
+
+    struct TimerQueueEntry
+    {
+        double due;
+        uint64_t order;  // keeps timers due at the same time in scheduling order
+        Timer* timer;
+        struct _hashSelectorEntry* element;
+
+        bool operator<(const TimerQueueEntry& other) const
+        {
+            return due < other.due || (due == other.due && order < other.order);
+        }
+    };
+
+    void updateTimerQueue(float dt);
+    void queueTimer(Timer* timer, struct _hashSelectorEntry* element);
+    void dequeueTimer(Timer* timer);
+    void queueTargetTimers(struct _hashSelectorEntry* element);
+    void dequeueTargetTimers(struct _hashSelectorEntry* element);
+    void setTargetTimersPaused(struct _hashSelectorEntry* element, bool paused);
+    void eraseTimerQueueEntry(int index);
+    void siftTimerUp(int index);
+    void siftTimerDown(int index);
+
+    void performFunctions();
+
     float _timeScale;
 
     //
@@ -498,12 +571,29 @@ protected:
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _updateHashLocked;
 
+    // Used for the timer queue, a binary min heap on the due time
+    bool _timerQueueEnabled;
+    double _timerClock;
+    uint64_t _timerQueueOrder;
+    std::vector<TimerQueueEntry> _timerQueue;
+    std::vector<TimerQueueEntry> _timersToRequeue;
+
 #if CC_ENABLE_SCRIPT_BINDING
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
 #endif
 
     // Used for "perform action"
-    std::vector<std::function<void()>> _actionsToPerform;
+    // Producers push into the lock-free ring and only take _performMutex once it is full. Under _performMutex the main
+    // thread collects the functions deferred by the budget, then the ring, then the overflow.
+    MPSCQueue<std::function<void()>> _functionsToPerform;
+    std::vector<std::function<void()>> _functionsOverflow;
+    std::vector<std::function<void()>> _functionsDeferred;
+    std::vector<std::function<void()>> _functionsRunning;
+    std::atomic<size_t> _overflowFunctionCount;
+    std::atomic<size_t> _pendingFunctionCount;
+    std::atomic<unsigned int> _performGeneration;  // bumped by removeAllPendingActions()
+    float _performBudget;
+    size_t _deferredFunctionCount;
     std::mutex _performMutex;
 };
 
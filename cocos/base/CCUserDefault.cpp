@@ -51,6 +51,7 @@ THE SOFTWARE.
 #include "platform/CCFileUtils.h"
 #include "pugixml/pugixml.hpp"
 #include "base/ccUtils.h"
+#include "xxhash.h"
 
 #include "CCPosixFileStream.h"
 
@@ -64,6 +65,11 @@ THE SOFTWARE.
 
 typedef int32_t udflen_t;
 
+// log record: [udflen_t payload size][uint32_t XXH32 of payload][payload: op, key, value]
+#define UD_LOG_HEADER_SIZE (sizeof(udflen_t) + sizeof(uint32_t))
+#define UD_LOG_SET 1
+#define UD_LOG_DELETE 2
+
 NS_CC_BEGIN
 
 /**
@@ -94,6 +100,88 @@ static void ud_write_v_s(UserDefault* ud, yasio::obstream& obs, const cxx17::str
         ud->encrypt(obs.data() + value_offset, value.length(), AES_ENCRYPT);
 }
 
+static std::string ud_make_xml(const hlookup::string_map<std::string>& values)
+{
+    pugi::xml_document doc;
+    doc.load_string(R"(<?xml version="1.0" ?>
+<r />)");
+    auto r = doc.document_element();
+    for (auto&& kv : values)
+        r.append_child(kv.first.c_str()).append_child(pugi::xml_node_type::node_pcdata).set_value(kv.second.c_str());
+
+    std::stringstream ss;
+    doc.save(ss, "  ");
+    return ss.str();
+}
+
+// FileUtils may be destroyed while the compaction thread runs, so these don't use it
+static bool ud_rename_file(const std::string& oldPath, const std::string& newPath)
+{
+#if defined(_WIN32)
+    return !!::MoveFileExW(ntcvt::from_chars(oldPath).c_str(), ntcvt::from_chars(newPath).c_str(),
+                           MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    return ::rename(oldPath.c_str(), newPath.c_str()) == 0;
+#endif
+}
+
+static void ud_remove_file(const std::string& path)
+{
+#if defined(_WIN32)
+    ::_wremove(ntcvt::from_chars(path).c_str());
+#else
+    ::remove(path.c_str());
+#endif
+}
+
+static bool ud_sync_file(int fd)
+{
+#if defined(_WIN32)
+    return ::_commit(fd) == 0;
+#else
+    #if defined(__APPLE__)
+    // fsync doesn't flush the drive cache on apple platforms
+    if (::fcntl(fd, F_FULLFSYNC) == 0)
+        return true;
+    #endif
+    return ::fsync(fd) == 0;
+#endif
+}
+
+// Makes a rename in the directory of path durable, MoveFileEx writes through on windows
+static bool ud_sync_directory(const std::string& path)
+{
+#if defined(_WIN32)
+    return true;
+#else
+    auto slash   = path.find_last_of('/');
+    auto dirPath = slash == std::string::npos ? std::string{"."} : path.substr(0, slash + 1);
+    int fd       = ::open(dirPath.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+#endif
+}
+
+// Writes a temporary file then renames it over path, so path always holds a complete file. The file is on disk when
+// this returns true, the logs it replaces can be removed.
+static bool ud_replace_file(std::string_view content, const std::string& path)
+{
+    auto tmpPath = path + ".tmp";
+    int fd       = posix_open(tmpPath.c_str(), O_WRITE_FLAGS);
+    if (fd == -1)
+        return false;
+
+    bool ok = posix_write(fd, content.data(), static_cast<unsigned int>(content.size())) ==
+              static_cast<int>(content.size());
+    // a rename can reach the disk before the content of the file it renames
+    ok = ok && ud_sync_file(fd);
+    posix_close(fd);
+    return ok && ud_rename_file(tmpPath, path) && ud_sync_directory(path);
+}
+
 void UserDefault::setEncryptEnabled(bool enabled, cxx17::string_view key, cxx17::string_view iv)
 {
     _encryptEnabled = enabled;
@@ -125,8 +213,21 @@ void UserDefault::encrypt(char* inout, size_t size, int enc)
     }
 }
 
+void UserDefault::setLogModeEnabled(bool enabled, size_t compactThreshold)
+{
+    CCASSERT(!_initialized, "UserDefault: the log mode must be set before the first access");
+#if USER_DEFAULT_PLAIN_MODE
+    _logModeEnabled      = enabled;
+    _logCompactThreshold = compactThreshold;
+#else
+    // the file mapping storage already appends the updated values in place
+    log("[Warnning] UserDefault: the log mode is only supported by the xml storage");
+#endif
+}
+
 UserDefault::~UserDefault()
 {
+    closeLog();
     closeFileMapping();
 }
 
@@ -333,7 +434,10 @@ void UserDefault::setStringForKey(const char* pKey, std::string_view value)
         }
     }
 #else
-    flush();
+    if (_logFd != -1)
+        appendLog(UD_LOG_SET, pKey, value);
+    else
+        flush();
 #endif
 }
 
@@ -454,6 +558,8 @@ void UserDefault::lazyInit()
         }
     }
 
+    // the logs written in log mode by a previous run are replayed in any case
+    openLog();
 #endif
 
     _initialized = true;
@@ -505,23 +611,203 @@ void UserDefault::flush()
         }
     }
 #else
-    pugi::xml_document doc;
-    doc.load_string(R"(<?xml version="1.0" ?>
-<r />)");
-    auto r = doc.document_element();
-    for (auto&& kv : _values)
-        r.append_child(kv.first.c_str()).append_child(pugi::xml_node_type::node_pcdata).set_value(kv.second.c_str());
+    // every update is already in the log, flushing only makes it durable
+    if (_logFd != -1)
+    {
+        ud_sync_file(_logFd);
+        return;
+    }
 
-    std::stringstream ss;
-    doc.save(ss, "  ");
-    FileUtils::getInstance()->writeStringToFile(ss.str(), _filePath);
+    FileUtils::getInstance()->writeStringToFile(ud_make_xml(_values), _filePath);
 #endif
 }
 
 void UserDefault::deleteValueForKey(const char* key)
 {
+    lazyInit();
+
     if (this->_values.erase(key) > 0)
-        flush();
+    {
+        if (_logFd != -1)
+            appendLog(UD_LOG_DELETE, key, {});
+        else
+            flush();
+    }
+}
+
+void UserDefault::openLog()
+{
+    auto logPath    = _filePath + ".log";
+    auto oldLogPath = logPath + ".old";
+
+    // the old log is left by a compaction which didn't finish, its records come before the ones of the log
+    replayLog(oldLogPath);
+    size_t validSize = replayLog(logPath);
+
+    if (!_logModeEnabled)
+    {
+        auto fileUtils = FileUtils::getInstance();
+        if (fileUtils->isFileExist(logPath) || fileUtils->isFileExist(oldLogPath))
+            abandonLog();
+        return;
+    }
+
+    _logFd = posix_open(logPath.c_str(), O_APPEND_FLAGS);
+    if (_logFd == -1)
+    {
+        log("[Warnning] UserDefault::init open log file '%s' failed!", logPath.c_str());
+        return;
+    }
+
+    // drop the torn tail of an interrupted write, so new records follow the last valid one
+    if (static_cast<size_t>(posix_lseek64(_logFd, 0, SEEK_END)) != validSize)
+        posix_ftruncate(_logFd, validSize);
+    _logSize = validSize;
+}
+
+size_t UserDefault::replayLog(const std::string& path)
+{
+    if (!FileUtils::getInstance()->isFileExist(path))
+        return 0;
+
+    auto data     = FileUtils::getInstance()->getDataFromFile(path);
+    auto bytes    = reinterpret_cast<const char*>(data.getBytes());
+    size_t size   = static_cast<size_t>(data.getSize());
+    size_t offset = 0;
+
+    while (size - offset >= UD_LOG_HEADER_SIZE)
+    {
+        yasio::ibstream_view header(bytes + offset, UD_LOG_HEADER_SIZE);
+        auto payloadSize = header.read<udflen_t>();
+        auto checksum    = header.read<uint32_t>();
+        if (payloadSize <= 0 || static_cast<size_t>(payloadSize) > size - offset - UD_LOG_HEADER_SIZE)
+            break;
+
+        auto payload = bytes + offset + UD_LOG_HEADER_SIZE;
+        if (static_cast<uint32_t>(XXH32(payload, payloadSize, 0)) != checksum)
+            break;
+
+        yasio::ibstream_view ibs(payload, payloadSize);
+        auto op = ibs.read<uint8_t>();
+        std::string key(ibs.read_v());
+        if (_encryptEnabled)
+            this->encrypt(key, AES_DECRYPT);
+
+        if (op == UD_LOG_SET)
+        {
+            std::string value(ibs.read_v());
+            if (_encryptEnabled)
+                this->encrypt(value, AES_DECRYPT);
+            updateValueForKey(key, value);
+        }
+        else
+        {
+            _values.erase(key);
+        }
+
+        offset += UD_LOG_HEADER_SIZE + payloadSize;
+    }
+
+    if (offset != size)
+        log("[Warnning] UserDefault: dropped %d bytes of the log file '%s'", static_cast<int>(size - offset),
+            path.c_str());
+    return offset;
+}
+
+void UserDefault::appendLog(uint8_t op, std::string_view key, std::string_view value)
+{
+    yasio::obstream obs;
+    obs.write<udflen_t>(0);
+    obs.write<uint32_t>(0);
+    obs.write<uint8_t>(op);
+    if (_encryptEnabled)
+    {
+        ud_write_v_s(this, obs, key);
+        if (op == UD_LOG_SET)
+            ud_write_v_s(this, obs, value);
+    }
+    else
+    {
+        obs.write_v(key);
+        if (op == UD_LOG_SET)
+            obs.write_v(value);
+    }
+
+    auto payloadSize = obs.length() - UD_LOG_HEADER_SIZE;
+    yasio::obstream::swrite(obs.data(), static_cast<udflen_t>(payloadSize));
+    yasio::obstream::swrite(obs.data() + sizeof(udflen_t),
+                            static_cast<uint32_t>(XXH32(obs.data() + UD_LOG_HEADER_SIZE, payloadSize, 0)));
+
+    if (posix_write(_logFd, obs.data(), static_cast<unsigned int>(obs.length())) != static_cast<int>(obs.length()))
+    {
+        log("[Warnning] UserDefault: write log file failed, fall back to rewriting '%s'", _filePath.c_str());
+        abandonLog();
+        return;
+    }
+
+    _logSize += obs.length();
+    if (_logSize >= _logCompactThreshold)
+        compactLog();
+}
+
+void UserDefault::compactLog()
+{
+    // the log keeps growing until the running compaction is done
+    if (_compacting.load(std::memory_order_acquire))
+        return;
+    if (_compactThread.joinable())
+        _compactThread.join();
+
+    auto logPath    = _filePath + ".log";
+    auto oldLogPath = logPath + ".old";
+
+    // Later records go to a new log while the file is rewritten. An old log left by a failed compaction isn't
+    // overwritten, nor is a log which couldn't be renamed removed: replaying it over the rewritten file yields the
+    // same values.
+    if (!FileUtils::getInstance()->isFileExist(oldLogPath))
+    {
+        posix_close(_logFd);
+        ud_rename_file(logPath, oldLogPath);
+        _logFd = posix_open(logPath.c_str(), O_APPEND_FLAGS);
+        if (_logFd == -1)
+        {
+            abandonLog();
+            return;
+        }
+    }
+    _logSize = 0;
+
+    _compacting.store(true, std::memory_order_relaxed);
+    _compactThread = std::thread([this, values = _values, filePath = _filePath, oldLogPath]() {
+        if (ud_replace_file(ud_make_xml(values), filePath))
+            ud_remove_file(oldLogPath);
+        _compacting.store(false, std::memory_order_release);
+    });
+}
+
+void UserDefault::closeLog()
+{
+    if (_compactThread.joinable())
+        _compactThread.join();
+
+    if (_logFd != -1)
+    {
+        posix_close(_logFd);
+        _logFd = -1;
+    }
+}
+
+void UserDefault::abandonLog()
+{
+    closeLog();
+
+    // the logs would be replayed over newer values of the file
+    auto logPath = _filePath + ".log";
+    if (ud_replace_file(ud_make_xml(_values), _filePath))
+    {
+        ud_remove_file(logPath);
+        ud_remove_file(logPath + ".old");
+    }
 }
 
 NS_CC_END
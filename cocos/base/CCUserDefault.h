@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include <string>
 
 #include <unordered_map>
+#include <thread>
+#include <atomic>
 #include "mio/mio.hpp"
 #include "yasio/stl/string_view.hpp"
 
@@ -207,7 +209,8 @@ public:
 
     /**
      * Since we reimplement UserDefault with file mapping io,
-     * you don't needs call this function manually
+     * you don't needs call this function manually.
+     * When the updates are appended to a log, it syncs the log to the disk.
      * @js NA
      */
     virtual void flush();
@@ -256,6 +259,20 @@ public:
 
     void encrypt(std::string& inout, int enc);
 
+    /**
+     * Enables the append-only log mode, it must be called before the first access to a value.
+     * In this mode set*ForKey and deleteValueForKey append a record to `UserDefault.xml.log` instead of rewriting
+     * the whole file, and a background thread folds the log into the file once it grows over compactThreshold
+     * bytes. The log is replayed at startup, the records of an interrupted write are dropped.
+     * @js NA
+     */
+    void setLogModeEnabled(bool enabled, size_t compactThreshold = 64 * 1024);
+
+    /**
+     * @js NA
+     */
+    bool isLogModeEnabled() const { return _logModeEnabled; }
+
 protected:
     UserDefault();
     virtual ~UserDefault();
@@ -264,6 +281,14 @@ protected:
 
     void closeFileMapping();
 
+    void openLog();
+    size_t replayLog(const std::string& path);
+    void appendLog(uint8_t op, std::string_view key, std::string_view value);
+    void compactLog();
+    void closeLog();
+    // Leaves the log mode after a write error, the whole file is rewritten by flush() from now on
+    void abandonLog();
+
     // The low level API of all getXXXForKey
     const std::string* getValueForKey(std::string_view key);
 
@@ -288,6 +313,14 @@ protected:
     bool _encryptEnabled = false;
     std::string _key;
     std::string _iv;
+
+    // append-only log
+    bool _logModeEnabled        = false;
+    size_t _logCompactThreshold = 64 * 1024;
+    int _logFd                  = -1;
+    size_t _logSize             = 0;
+    std::thread _compactThread;
+    std::atomic<bool> _compacting{false};
 };
 
 NS_CC_END
@@ -0,0 +1,667 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCValueSnapshot.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+NS_CC_BEGIN
+
+namespace
+{
+/*
+ * All offsets are from the beginning of the snapshot, in little endian.
+ *
+ * Header   : magic, version, source hash, size, reserved, root slot
+ * Slot     : Value::Type, then the value for 32 bits types and booleans, an offset otherwise
+ * String   : length, characters, NUL
+ * 64 bits  : 8 bytes aligned int64_t, uint64_t or double
+ * Vector   : count, slots
+ * Map      : count, entries of a string offset and a slot, sorted by key
+ * IntKeyMap: count, entries of an int and a slot, sorted by key
+ */
+const uint32_t SNAPSHOT_MAGIC = 0x53564343;  // "CCVS"
+
+struct Slot
+{
+    uint32_t type;
+    uint32_t payload;
+};
+
+struct MapEntry
+{
+    uint32_t key;
+    Slot value;
+};
+
+struct IntKeyMapEntry
+{
+    int32_t key;
+    Slot value;
+};
+
+struct SnapshotHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    uint32_t size;
+    uint32_t reserved;
+    Slot root;
+};
+
+static_assert(sizeof(SnapshotHeader) == 32, "The header of a snapshot must be packed");
+
+bool is64Bit(uint32_t type)
+{
+    return (type & (uint32_t)Value::Type::MASK_64BIT) != 0;
+}
+
+bool isUnsigned(uint32_t type)
+{
+    return (type & (uint32_t)Value::Type::MASK_UNSIGNED) != 0;
+}
+
+class SnapshotEncoder
+{
+public:
+    explicit SnapshotEncoder(std::string* output) : _output(output) {}
+
+    bool encode(const Value& root, uint64_t sourceHash)
+    {
+        _output->assign(sizeof(SnapshotHeader), '\0');
+
+        SnapshotHeader header;
+        header.root = write(root);
+        if (_output->size() > std::numeric_limits<uint32_t>::max())
+        {
+            _output->clear();
+            return false;
+        }
+
+        header.magic      = SNAPSHOT_MAGIC;
+        header.version    = ValueSnapshot::VERSION;
+        header.sourceHash = sourceHash;
+        header.size       = static_cast<uint32_t>(_output->size());
+        header.reserved   = 0;
+        store(0, header);
+        return true;
+    }
+
+private:
+    size_t reserve(size_t size, size_t alignment)
+    {
+        size_t offset = (_output->size() + alignment - 1) & ~(alignment - 1);
+        _output->resize(offset + size);
+        return offset;
+    }
+
+    template <typename T>
+    void store(size_t offset, const T& value)
+    {
+        memcpy(&(*_output)[offset], &value, sizeof(T));
+    }
+
+    uint32_t writeString(std::string_view str)
+    {
+        // keys are repeated in every dict of a sprite sheet, so strings are written once
+        auto iter = _strings.find(str);
+        if (iter != _strings.end())
+            return iter->second;
+
+        size_t offset = reserve(sizeof(uint32_t) + str.size() + 1, alignof(uint32_t));
+        store(offset, static_cast<uint32_t>(str.size()));
+        memcpy(&(*_output)[offset + sizeof(uint32_t)], str.data(), str.size());
+
+        _strings.emplace(str, static_cast<uint32_t>(offset));
+        return static_cast<uint32_t>(offset);
+    }
+
+    template <typename T>
+    uint32_t write64(T value)
+    {
+        size_t offset = reserve(sizeof(T), 8);
+        store(offset, value);
+        return static_cast<uint32_t>(offset);
+    }
+
+    Slot write(const Value& value)
+    {
+        Slot slot{static_cast<uint32_t>(value.getType()), 0};
+        switch (value.getType())
+        {
+        case Value::Type::INT_I32:
+            slot.payload = static_cast<uint32_t>(value.asInt());
+            break;
+        case Value::Type::INT_UI32:
+            slot.payload = value.asUint();
+            break;
+        case Value::Type::INT_I64:
+            slot.payload = write64(value.asInt64());
+            break;
+        case Value::Type::INT_UI64:
+            slot.payload = write64(value.asUint64());
+            break;
+        case Value::Type::FLOAT:
+        {
+            float floatValue = value.asFloat();
+            memcpy(&slot.payload, &floatValue, sizeof(float));
+        }
+        break;
+        case Value::Type::DOUBLE:
+            slot.payload = write64(value.asDouble());
+            break;
+        case Value::Type::BOOLEAN:
+            slot.payload = value.asBool() ? 1 : 0;
+            break;
+        case Value::Type::STRING:
+            slot.payload = writeString(value.asStringRef());
+            break;
+        case Value::Type::VECTOR:
+        {
+            auto& vector  = value.asValueVector();
+            size_t offset = reserve(sizeof(uint32_t) + sizeof(Slot) * vector.size(), alignof(uint32_t));
+            store(offset, static_cast<uint32_t>(vector.size()));
+            for (size_t i = 0; i < vector.size(); ++i)
+            {
+                // the elements are written after the vector, which may grow the output
+                Slot element = write(vector[i]);
+                store(offset + sizeof(uint32_t) + sizeof(Slot) * i, element);
+            }
+            slot.payload = static_cast<uint32_t>(offset);
+        }
+        break;
+        case Value::Type::MAP:
+        {
+            auto& map = value.asValueMap();
+            std::vector<const ValueMap::value_type*> entries;
+            entries.reserve(map.size());
+            for (auto&& entry : map)
+            {
+                entries.emplace_back(&entry);
+            }
+            std::sort(entries.begin(), entries.end(),
+                      [](const ValueMap::value_type* a, const ValueMap::value_type* b) { return a->first < b->first; });
+
+            size_t offset = reserve(sizeof(uint32_t) + sizeof(MapEntry) * entries.size(), alignof(uint32_t));
+            store(offset, static_cast<uint32_t>(entries.size()));
+            for (size_t i = 0; i < entries.size(); ++i)
+            {
+                MapEntry entry;
+                entry.key   = writeString(entries[i]->first);
+                entry.value = write(entries[i]->second);
+                store(offset + sizeof(uint32_t) + sizeof(MapEntry) * i, entry);
+            }
+            slot.payload = static_cast<uint32_t>(offset);
+        }
+        break;
+        case Value::Type::INT_KEY_MAP:
+        {
+            auto& map = value.asIntKeyMap();
+            std::vector<const ValueMapIntKey::value_type*> entries;
+            entries.reserve(map.size());
+            for (auto&& entry : map)
+            {
+                entries.emplace_back(&entry);
+            }
+            std::sort(entries.begin(), entries.end(),
+                      [](const ValueMapIntKey::value_type* a, const ValueMapIntKey::value_type* b) {
+                          return a->first < b->first;
+                      });
+
+            size_t offset = reserve(sizeof(uint32_t) + sizeof(IntKeyMapEntry) * entries.size(), alignof(uint32_t));
+            store(offset, static_cast<uint32_t>(entries.size()));
+            for (size_t i = 0; i < entries.size(); ++i)
+            {
+                IntKeyMapEntry entry;
+                entry.key   = entries[i]->first;
+                entry.value = write(entries[i]->second);
+                store(offset + sizeof(uint32_t) + sizeof(IntKeyMapEntry) * i, entry);
+            }
+            slot.payload = static_cast<uint32_t>(offset);
+        }
+        break;
+        default:
+            slot.type = static_cast<uint32_t>(Value::Type::NONE);
+            break;
+        }
+        return slot;
+    }
+
+    std::string* _output;
+    std::unordered_map<std::string_view, uint32_t> _strings;
+};
+}  // namespace
+
+//
+// ValueSnapshot::View
+//
+
+template <typename T>
+const T* ValueSnapshot::View::get(uint32_t offset, uint32_t count) const
+{
+    // snapshots may come from anywhere, so every offset is checked
+    if (_base == nullptr || offset > _size || (uint64_t)count * sizeof(T) > (uint64_t)(_size - offset))
+        return nullptr;
+    return reinterpret_cast<const T*>(_base + offset);
+}
+
+ValueSnapshot::View ValueSnapshot::View::slot(uint32_t offset) const
+{
+    auto slot = get<Slot>(offset);
+    return slot ? View(_base, _size, slot->type, slot->payload) : View();
+}
+
+uint32_t ValueSnapshot::View::count() const
+{
+    auto count = get<uint32_t>(_payload);
+    return count ? *count : 0;
+}
+
+int64_t ValueSnapshot::View::asInt64(int64_t defaultValue) const
+{
+    switch (getTypeFamily())
+    {
+    case Value::Type::INTEGER:
+        if (is64Bit(_type))
+        {
+            auto bytes    = get<uint8_t>(_payload, sizeof(int64_t));
+            int64_t value = defaultValue;
+            if (bytes)
+                memcpy(&value, bytes, sizeof(int64_t));
+            return value;
+        }
+        return isUnsigned(_type) ? static_cast<int64_t>(_payload) : static_cast<int32_t>(_payload);
+    case Value::Type::FLOAT:
+    case Value::Type::DOUBLE:
+        return static_cast<int64_t>(asDouble());
+    case Value::Type::BOOLEAN:
+        return _payload;
+    case Value::Type::STRING:
+        return strtoll(asStringRef().data(), nullptr, 10);
+    default:
+        return defaultValue;
+    }
+}
+
+uint64_t ValueSnapshot::View::asUint64(uint64_t defaultValue) const
+{
+    if (getTypeFamily() == Value::Type::STRING)
+        return strtoull(asStringRef().data(), nullptr, 10);
+    return static_cast<uint64_t>(asInt64(static_cast<int64_t>(defaultValue)));
+}
+
+double ValueSnapshot::View::asDouble(double defaultValue) const
+{
+    switch (getTypeFamily())
+    {
+    case Value::Type::INTEGER:
+        return is64Bit(_type) && isUnsigned(_type) ? static_cast<double>(asUint64())
+                                                   : static_cast<double>(asInt64());
+    case Value::Type::FLOAT:
+    {
+        float value;
+        memcpy(&value, &_payload, sizeof(float));
+        return value;
+    }
+    case Value::Type::DOUBLE:
+    {
+        auto bytes   = get<uint8_t>(_payload, sizeof(double));
+        double value = defaultValue;
+        if (bytes)
+            memcpy(&value, bytes, sizeof(double));
+        return value;
+    }
+    case Value::Type::BOOLEAN:
+        return _payload ? 1.0 : 0.0;
+    case Value::Type::STRING:
+        return atof(asStringRef().data());
+    default:
+        return defaultValue;
+    }
+}
+
+bool ValueSnapshot::View::asBool(bool defaultValue) const
+{
+    switch (getTypeFamily())
+    {
+    case Value::Type::BOOLEAN:
+        return _payload != 0;
+    case Value::Type::STRING:
+    {
+        auto str = asStringRef();
+        return !(str == "0"sv || str == "false"sv);
+    }
+    case Value::Type::INTEGER:
+        return asInt64() != 0;
+    case Value::Type::FLOAT:
+    case Value::Type::DOUBLE:
+        return asDouble() != 0.0;
+    default:
+        return defaultValue;
+    }
+}
+
+std::string_view ValueSnapshot::View::asStringRef() const
+{
+    if (getType() != Value::Type::STRING)
+        return ""sv;
+
+    auto length = get<uint32_t>(_payload);
+    if (length == nullptr)
+        return ""sv;
+
+    auto chars = get<char>(_payload + sizeof(uint32_t), *length + 1);
+    if (chars == nullptr || chars[*length] != '\0')
+        return ""sv;
+    return std::string_view(chars, *length);
+}
+
+size_t ValueSnapshot::View::size() const
+{
+    switch (getType())
+    {
+    case Value::Type::VECTOR:
+    case Value::Type::MAP:
+    case Value::Type::INT_KEY_MAP:
+        return count();
+    default:
+        return 0;
+    }
+}
+
+ValueSnapshot::View ValueSnapshot::View::at(size_t index) const
+{
+    if (getType() != Value::Type::VECTOR || index >= count())
+        return View();
+    return slot(_payload + sizeof(uint32_t) + static_cast<uint32_t>(sizeof(Slot) * index));
+}
+
+ValueSnapshot::View ValueSnapshot::View::find(std::string_view key) const
+{
+    if (getType() != Value::Type::MAP)
+        return View();
+
+    auto entries = get<MapEntry>(_payload + sizeof(uint32_t), count());
+    if (entries == nullptr)
+        return View();
+
+    size_t low = 0, high = count();
+    while (low < high)
+    {
+        size_t middle  = (low + high) / 2;
+        auto middleKey = keyAt(middle);
+        if (middleKey < key)
+            low = middle + 1;
+        else if (key < middleKey)
+            high = middle;
+        else
+            return View(_base, _size, entries[middle].value.type, entries[middle].value.payload);
+    }
+    return View();
+}
+
+ValueSnapshot::View ValueSnapshot::View::find(int key) const
+{
+    if (getType() != Value::Type::INT_KEY_MAP)
+        return View();
+
+    auto entries = get<IntKeyMapEntry>(_payload + sizeof(uint32_t), count());
+    if (entries == nullptr)
+        return View();
+
+    auto end  = entries + count();
+    auto iter = std::lower_bound(entries, end, key,
+                                 [](const IntKeyMapEntry& entry, int key) { return entry.key < key; });
+    if (iter == end || iter->key != key)
+        return View();
+    return View(_base, _size, iter->value.type, iter->value.payload);
+}
+
+std::string_view ValueSnapshot::View::keyAt(size_t index) const
+{
+    if (getType() != Value::Type::MAP || index >= count())
+        return ""sv;
+
+    auto entry = get<MapEntry>(_payload + sizeof(uint32_t) + static_cast<uint32_t>(sizeof(MapEntry) * index));
+    if (entry == nullptr)
+        return ""sv;
+    return View(_base, _size, static_cast<uint32_t>(Value::Type::STRING), entry->key).asStringRef();
+}
+
+ValueSnapshot::View ValueSnapshot::View::valueAt(size_t index) const
+{
+    switch (getType())
+    {
+    case Value::Type::MAP:
+        if (index < count())
+            return slot(_payload + sizeof(uint32_t) + static_cast<uint32_t>(sizeof(MapEntry) * index) +
+                        offsetof(MapEntry, value));
+        break;
+    case Value::Type::INT_KEY_MAP:
+        if (index < count())
+            return slot(_payload + sizeof(uint32_t) + static_cast<uint32_t>(sizeof(IntKeyMapEntry) * index) +
+                        offsetof(IntKeyMapEntry, value));
+        break;
+    default:
+        break;
+    }
+    return View();
+}
+
+Value ValueSnapshot::View::toValue() const
+{
+    size_t budget = _size / sizeof(Slot) + 1;
+    return toValue(0, budget);
+}
+
+ValueMap ValueSnapshot::View::toValueMap() const
+{
+    size_t budget = _size / sizeof(Slot) + 1;
+    return toValueMap(0, budget);
+}
+
+ValueVector ValueSnapshot::View::toValueVector() const
+{
+    size_t budget = _size / sizeof(Slot) + 1;
+    return toValueVector(0, budget);
+}
+
+ValueSnapshot::View ValueSnapshot::View::child(uint32_t type, uint32_t payload) const
+{
+    // the encoder writes children after their container, anything else would be a cycle
+    switch (static_cast<Value::Type>(type))
+    {
+    case Value::Type::VECTOR:
+    case Value::Type::MAP:
+    case Value::Type::INT_KEY_MAP:
+        if (payload <= _payload)
+            return View();
+        break;
+    default:
+        break;
+    }
+    return View(_base, _size, type, payload);
+}
+
+Value ValueSnapshot::View::toValue(uint32_t depth, size_t& budget) const
+{
+    if (budget == 0)
+        return Value::Null;
+    --budget;
+
+    switch (getType())
+    {
+    case Value::Type::INT_I32:
+        return Value(static_cast<int>(_payload));
+    case Value::Type::INT_UI32:
+        return Value(static_cast<unsigned int>(_payload));
+    case Value::Type::INT_I64:
+        return Value(asInt64());
+    case Value::Type::INT_UI64:
+        return Value(asUint64());
+    case Value::Type::FLOAT:
+        return Value(asFloat());
+    case Value::Type::DOUBLE:
+        return Value(asDouble());
+    case Value::Type::BOOLEAN:
+        return Value(asBool());
+    case Value::Type::STRING:
+        return Value(asStringRef());
+    case Value::Type::VECTOR:
+        return Value(toValueVector(depth, budget));
+    case Value::Type::MAP:
+        return Value(toValueMap(depth, budget));
+    case Value::Type::INT_KEY_MAP:
+    {
+        ValueMapIntKey map;
+        const uint32_t n = count();
+        auto entries     = get<IntKeyMapEntry>(_payload + sizeof(uint32_t), n);
+        if (entries == nullptr || depth >= MAX_DEPTH)
+            return Value(std::move(map));
+
+        map.reserve(n);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            map.emplace(entries[i].key,
+                        child(entries[i].value.type, entries[i].value.payload).toValue(depth + 1, budget));
+        }
+        return Value(std::move(map));
+    }
+    default:
+        return Value::Null;
+    }
+}
+
+ValueMap ValueSnapshot::View::toValueMap(uint32_t depth, size_t& budget) const
+{
+    ValueMap map;
+    if (getType() != Value::Type::MAP || depth >= MAX_DEPTH)
+        return map;
+
+    const uint32_t n = count();
+    auto entries     = get<MapEntry>(_payload + sizeof(uint32_t), n);
+    if (entries == nullptr)
+        return map;
+
+    map.reserve(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        map.emplace(keyAt(i), child(entries[i].value.type, entries[i].value.payload).toValue(depth + 1, budget));
+    }
+    return map;
+}
+
+ValueVector ValueSnapshot::View::toValueVector(uint32_t depth, size_t& budget) const
+{
+    ValueVector vector;
+    if (getType() != Value::Type::VECTOR || depth >= MAX_DEPTH)
+        return vector;
+
+    // the count is checked against the size of the snapshot before anything is allocated
+    const uint32_t n = count();
+    auto slots       = get<Slot>(_payload + sizeof(uint32_t), n);
+    if (slots == nullptr)
+        return vector;
+
+    vector.reserve(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        vector.emplace_back(child(slots[i].type, slots[i].payload).toValue(depth + 1, budget));
+    }
+    return vector;
+}
+
+//
+// ValueSnapshot
+//
+
+bool ValueSnapshot::encode(const Value& root, uint64_t sourceHash, std::string* output)
+{
+    SnapshotEncoder encoder(output);
+    return encoder.encode(root, sourceHash);
+}
+
+bool ValueSnapshot::openFile(std::string_view fullPath)
+{
+    _data.clear();
+    _bytes = nullptr;
+
+    std::error_code error;
+    _mapping.map(std::string{fullPath}, error);
+    if (error)
+        return false;
+
+    return validate(reinterpret_cast<const uint8_t*>(_mapping.data()), _mapping.size());
+}
+
+bool ValueSnapshot::openData(Data data)
+{
+    _mapping.unmap();
+    _bytes = nullptr;
+
+    _data = std::move(data);
+    return validate(_data.getBytes(), static_cast<size_t>(_data.getSize()));
+}
+
+bool ValueSnapshot::validate(const uint8_t* bytes, size_t size)
+{
+    SnapshotHeader header;
+    if (bytes == nullptr || size < sizeof(header))
+        return false;
+
+    memcpy(&header, bytes, sizeof(header));
+    if (header.magic != SNAPSHOT_MAGIC || header.version != VERSION || header.size != size)
+        return false;
+
+    _bytes = bytes;
+    _size  = header.size;
+    return true;
+}
+
+uint64_t ValueSnapshot::getSourceHash() const
+{
+    if (!isValid())
+        return 0;
+
+    SnapshotHeader header;
+    memcpy(&header, _bytes, sizeof(header));
+    return header.sourceHash;
+}
+
+ValueSnapshot::View ValueSnapshot::getRoot() const
+{
+    if (!isValid())
+        return View();
+
+    SnapshotHeader header;
+    memcpy(&header, _bytes, sizeof(header));
+    return View(_bytes, _size, header.root.type, header.root.payload);
+}
+
+NS_CC_END
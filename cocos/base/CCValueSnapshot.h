@@ -0,0 +1,165 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/CCValue.h"
+#include "base/CCData.h"
+#include "mio/mio.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class ValueSnapshot
+ * @brief A compact binary encoding of a Value tree, which is memory mapped and read lazily.
+ * Strings are stored once, NUL terminated, and read in place; map entries are sorted by key so that a lookup is a
+ * binary search. Nothing is materialized until View::toValue() is called, and a View only stays valid while its
+ * snapshot lives.
+ * FileUtils compiles plists into snapshots, see FileUtils::getValueSnapshotFromFile.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL ValueSnapshot
+{
+public:
+    /** Incremented whenever the encoding changes, snapshots of another version are invalid. */
+    static const uint32_t VERSION = 1;
+
+    /** The deepest nesting of vectors and maps View::toValue() materializes. */
+    static const uint32_t MAX_DEPTH = 256;
+
+    /** Reads a value of a snapshot. A view of a missing value, or of an invalid snapshot, is null. */
+    class CC_DLL View
+    {
+    public:
+        View() : _base(nullptr), _size(0), _type(0), _payload(0) {}
+
+        Value::Type getType() const { return static_cast<Value::Type>(_type); }
+        Value::Type getTypeFamily() const { return static_cast<Value::Type>(_type & 0xFFFFu); }
+        bool isNull() const { return getType() == Value::Type::NONE; }
+
+        int asInt(int defaultValue = 0) const { return static_cast<int>(asInt64(defaultValue)); }
+        unsigned int asUint(unsigned int defaultValue = 0) const
+        {
+            return static_cast<unsigned int>(asUint64(defaultValue));
+        }
+        int64_t asInt64(int64_t defaultValue = 0) const;
+        uint64_t asUint64(uint64_t defaultValue = 0) const;
+        float asFloat(float defaultValue = 0.0f) const { return static_cast<float>(asDouble(defaultValue)); }
+        double asDouble(double defaultValue = 0.0) const;
+        bool asBool(bool defaultValue = false) const;
+
+        /** Gets a string in place, ""sv if the value isn't a string. The view is NUL terminated. */
+        std::string_view asStringRef() const;
+
+        /** Gets the number of elements of a vector, or of entries of a map. */
+        size_t size() const;
+
+        /** Gets an element of a vector. */
+        View at(size_t index) const;
+
+        /** Gets the value of a key of a map, a null view if there is none. */
+        View find(std::string_view key) const;
+
+        /** Gets the value of a key of an int key map, a null view if there is none. */
+        View find(int key) const;
+
+        /** Gets the key of the entry of a map at index, entries are sorted by key. */
+        std::string_view keyAt(size_t index) const;
+
+        /** Gets the value of the entry of a map at index. */
+        View valueAt(size_t index) const;
+
+        /**
+         * Materializes the value and all its descendants.
+         * Values nested deeper than MAX_DEPTH, and the values of a corrupted snapshot, are materialized as null.
+         */
+        Value toValue() const;
+        ValueMap toValueMap() const;
+        ValueVector toValueVector() const;
+
+    private:
+        friend class ValueSnapshot;
+        View(const uint8_t* base, uint32_t size, uint32_t type, uint32_t payload)
+            : _base(base), _size(size), _type(type), _payload(payload)
+        {}
+
+        template <typename T>
+        const T* get(uint32_t offset, uint32_t count = 1) const;
+        // the budget is the number of values a valid snapshot of this size can hold at most
+        Value toValue(uint32_t depth, size_t& budget) const;
+        ValueMap toValueMap(uint32_t depth, size_t& budget) const;
+        ValueVector toValueVector(uint32_t depth, size_t& budget) const;
+        View child(uint32_t type, uint32_t payload) const;
+        View slot(uint32_t offset) const;
+        uint32_t count() const;
+
+        const uint8_t* _base;
+        uint32_t _size;
+        uint32_t _type;
+        uint32_t _payload;
+    };
+
+    /**
+     * Encodes a Value tree.
+     * @param root The value to encode.
+     * @param sourceHash A hash of the file the value was parsed from, stored to detect stale snapshots.
+     * @param output The encoded snapshot.
+     * @return false if the encoded snapshot would exceed 4GB.
+     */
+    static bool encode(const Value& root, uint64_t sourceHash, std::string* output);
+
+    /** Memory maps a snapshot file, the path must be a real path of the file system. */
+    bool openFile(std::string_view fullPath);
+
+    /** Uses a snapshot loaded into memory. */
+    bool openData(Data data);
+
+    bool isValid() const { return _bytes != nullptr; }
+
+    /** Gets the hash passed to encode(). */
+    uint64_t getSourceHash() const;
+
+    /** Gets the root value, a null view if the snapshot is invalid. */
+    View getRoot() const;
+
+private:
+    bool validate(const uint8_t* bytes, size_t size);
+
+    mio::mmap_source _mapping;
+    Data _data;
+    const uint8_t* _bytes = nullptr;
+    uint32_t _size        = 0;
+};
+
+NS_CC_END
+// end group
+/// @}
@@ -0,0 +1,120 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "base/CCWorkerPool.h"
+
+#include <algorithm>
+
+NS_CC_BEGIN
+
+WorkerPool::WorkerPool(int numThreads)
+{
+    for (int i = 0; i < numThreads; ++i)
+        _threads.emplace_back(&WorkerPool::run, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lck(_mutex);
+        _stop = true;
+    }
+    _wakeCondition.notify_all();
+    for (auto&& t : _threads)
+        t.join();
+    _threads.clear();
+}
+
+void WorkerPool::parallelFor(size_t count, size_t grain, const RangeFunc& func)
+{
+    if (count == 0)
+        return;
+
+    grain = std::max<size_t>(grain, 1);
+    if (_threads.empty() || count <= grain)
+    {
+        func(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lck(_mutex);
+        _func  = &func;
+        _count = count;
+        _grain = grain;
+        _nextIndex.store(0, std::memory_order_relaxed);
+        ++_jobId;
+        _jobOpen = true;
+    }
+    _wakeCondition.notify_all();
+
+    drain(func, count, grain);
+
+    // late workers must not pick up this job once we stop waiting for it
+    std::unique_lock<std::mutex> lck(_mutex);
+    _jobOpen = false;
+    _doneCondition.wait(lck, [this] { return _activeWorkers == 0; });
+    _func = nullptr;
+}
+
+void WorkerPool::drain(const RangeFunc& func, size_t count, size_t grain)
+{
+    for (;;)
+    {
+        const size_t begin = _nextIndex.fetch_add(grain, std::memory_order_relaxed);
+        if (begin >= count)
+            break;
+        func(begin, std::min(begin + grain, count));
+    }
+}
+
+void WorkerPool::run()
+{
+    unsigned int lastJobId = 0;
+    for (;;)
+    {
+        const RangeFunc* func = nullptr;
+        size_t count = 0, grain = 1;
+        {
+            std::unique_lock<std::mutex> lck(_mutex);
+            _wakeCondition.wait(lck, [&] { return _stop || (_jobOpen && _jobId != lastJobId); });
+            if (_stop)
+                return;
+            lastJobId = _jobId;
+            func      = _func;
+            count     = _count;
+            grain     = _grain;
+            ++_activeWorkers;
+        }
+
+        drain(*func, count, grain);
+
+        {
+            std::lock_guard<std::mutex> lck(_mutex);
+            --_activeWorkers;
+        }
+        _doneCondition.notify_one();
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,91 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include "platform/CCPlatformMacros.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class WorkerPool
+ * @brief A fixed set of worker threads used to split a data-parallel loop into disjoint ranges.
+ * The calling thread takes part in the work and `parallelFor` only returns when every range is done,
+ * so the callback may safely write into caller-owned buffers.
+ * @js NA
+ */
+class CC_DLL WorkerPool
+{
+public:
+    typedef std::function<void(size_t begin, size_t end)> RangeFunc;
+
+    /**
+     * @param numThreads Number of extra worker threads, 0 means run everything on the calling thread.
+     */
+    explicit WorkerPool(int numThreads);
+    ~WorkerPool();
+
+    /** Returns the number of threads which will run a job, including the calling thread. */
+    int getConcurrency() const { return static_cast<int>(_threads.size()) + 1; }
+
+    /**
+     * Run func over [0, count) split into ranges of at least `grain` items.
+     * Not reentrant, must be called from one thread at a time.
+     */
+    void parallelFor(size_t count, size_t grain, const RangeFunc& func);
+
+protected:
+    void run();
+    void drain(const RangeFunc& func, size_t count, size_t grain);
+
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _wakeCondition;
+    std::condition_variable _doneCondition;
+
+    // current job, guarded by _mutex
+    const RangeFunc* _func = nullptr;
+    size_t _count          = 0;
+    size_t _grain          = 1;
+    unsigned int _jobId    = 0;
+    int _activeWorkers     = 0;
+    bool _jobOpen          = false;
+    bool _stop             = false;
+
+    std::atomic<size_t> _nextIndex{0};
+};
+
+NS_CC_END
+// end group
+/// @}
@@ -13,19 +13,17 @@
 
 #include "base/astc.h"
 
-#include <thread>
-#include <mutex>
 #include <memory>
-#include <vector>
-#include <deque>
 #include "astc/astcenc.h"
 #include "astc/astcenc_internal_entry.h"
+#include "base/texture_decode_pool.h"
 #include "yasio/detail/utils.hpp"
 
 #define ASTCDEC_NO_CONTEXT 1
 #define ASTCDEC_PRINT_BENCHMARK 0
 
-typedef std::mutex astc_decompress_mutex_t;
+// blocks handed to a decode thread at once
+#define ASTCDEC_BLOCKS_PER_CHUNK 128
 
 struct astc_decompress_task
 {
@@ -41,21 +39,11 @@ struct astc_decompress_task
 #endif
     }
 
-    void wait_done()
-    {
-#if ASTCDEC_NO_CONTEXT
-        _decompress_pm.wait();
-#else
-        _context->manage_decompress.wait();
-#endif
-    }
-
     const uint8_t* _in_texels = nullptr;
     void* _out_texels[1]{};
     unsigned int _xblocks, _yblocks;
-#if ASTCDEC_NO_CONTEXT
     unsigned int _block_x, _block_y;
-    ParallelManager _decompress_pm{};
+#if ASTCDEC_NO_CONTEXT
     block_size_descriptor* _bsd = nullptr;
 #else
     astcenc_config _config{};
@@ -64,201 +52,90 @@ struct astc_decompress_task
     astcenc_image _image_out{};
 };
 
-class astc_decompress_job_manager
+static std::unique_ptr<astc_decompress_task> astc_make_task(const uint8_t* in,
+                                                            unsigned int inlen,
+                                                            uint8_t* out,
+                                                            unsigned int dim_x,
+                                                            unsigned int dim_y,
+                                                            int block_x,
+                                                            int block_y)
 {
-public:
-    static astc_decompress_job_manager* get_instance()
-    {
-        static astc_decompress_job_manager s_instance;
-        return &s_instance;
-    }
-    astc_decompress_job_manager()
-    {
-        int thread_count = std::thread::hardware_concurrency();
-        for (int i = 0; i < thread_count; ++i)
-        {
-            _threads.emplace_back(std::thread{&astc_decompress_job_manager::run, this});
-        }
-    }
-
-    ~astc_decompress_job_manager()
-    {
-        _stopped = true;
-
-        _task_queue_mtx.lock();
-        _task_queue.clear();
-        _task_queue_cv.notify_all();
-        _task_queue_mtx.unlock();
-
-        for (auto&& t : _threads)
-        {
-            if (t.joinable())
-                t.join();
-        }
-        _threads.clear();
-    }
-
-    int decompress_parallel_sync(const uint8_t* in,
-                                 uint32_t inlen,
-                                 uint8_t* out,
-                                 unsigned int dim_x,
-                                 unsigned int dim_y,
-                                 int block_x,
-                                 int block_y)
-    {
-
-        auto task = make_task(in, inlen, out, dim_x, dim_y, block_x, block_y);
-        if (!task)
-            return ASTCENC_ERR_OUT_OF_MEM;
-
-        _task_queue_mtx.lock();
-        _task_queue.emplace_back(task);
-        _task_queue_mtx.unlock();
-        _task_queue_cv.notify_all();  // notify all thread to process the single decompress task parallel
-
-        task->wait_done();
-
-        _task_queue_mtx.lock();
-        assert(!_task_queue.empty());
-        auto t = _task_queue.front();
-        assert(t.get() == task.get());
-        _task_queue.pop_front();
-        _task_queue_mtx.unlock();
-
-        return ASTCENC_SUCCESS;
-    }
-
-private:
-    std::shared_ptr<astc_decompress_task> make_task(const uint8_t* in,
-                                                    unsigned int inlen,
-                                                    uint8_t* out,
-                                                    unsigned int dim_x,
-                                                    unsigned int dim_y,
-                                                    int block_x,
-                                                    int block_y)
-    {
-        unsigned int xblocks = (dim_x + block_x - 1) / block_x;
-        unsigned int yblocks = (dim_y + block_y - 1) / block_y;
-        unsigned int zblocks = 1;  // (dim_z + block_z - 1) / block_z;
-
-        // Check we have enough output space (16 bytes per block)
-        auto total_blocks  = xblocks * yblocks * zblocks;
-        size_t size_needed = total_blocks * 16;
-        if (inlen < size_needed)
-            return nullptr;
-
-        auto task            = std::make_shared<astc_decompress_task>();
-        task->_in_texels     = in;
-        task->_out_texels[0] = out;
-        task->_image_out     = {dim_x, dim_y, 1, ASTCENC_TYPE_U8, task->_out_texels};
-
-        task->_xblocks = xblocks;
-        task->_yblocks = yblocks;
+    unsigned int xblocks = (dim_x + block_x - 1) / block_x;
+    unsigned int yblocks = (dim_y + block_y - 1) / block_y;
+    unsigned int zblocks = 1;  // (dim_z + block_z - 1) / block_z;
+
+    // Check we have enough output space (16 bytes per block)
+    auto total_blocks  = xblocks * yblocks * zblocks;
+    size_t size_needed = total_blocks * 16;
+    if (inlen < size_needed)
+        return nullptr;
+
+    auto task            = std::make_unique<astc_decompress_task>();
+    task->_in_texels     = in;
+    task->_out_texels[0] = out;
+    task->_image_out     = {dim_x, dim_y, 1, ASTCENC_TYPE_U8, task->_out_texels};
+
+    task->_xblocks = xblocks;
+    task->_yblocks = yblocks;
+    task->_block_x = block_x;
+    task->_block_y = block_y;
 #if ASTCDEC_NO_CONTEXT
-        // since astcenc-3.3, doesn't required
-        // static std::once_flag once_flag;
-        // std::call_once(once_flag, init_quant_mode_table);
+    // since astcenc-3.3, doesn't required
+    // static std::once_flag once_flag;
+    // std::call_once(once_flag, init_quant_mode_table);
 
-        task->_block_x = block_x;
-        task->_block_y = block_y;
-        task->_bsd     = aligned_malloc<block_size_descriptor>(sizeof(block_size_descriptor), ASTCENC_VECALIGN);
-        init_block_size_descriptor(block_x, block_y, 1, false, 0 /*unused for decompress*/, 0, *task->_bsd);
-        task->_decompress_pm.init(total_blocks);
+    task->_bsd = aligned_malloc<block_size_descriptor>(sizeof(block_size_descriptor), ASTCENC_VECALIGN);
+    init_block_size_descriptor(block_x, block_y, 1, false, 0 /*unused for decompress*/, 0, *task->_bsd);
 #else
-        (void)astcenc_config_init(ASTCENC_PRF_LDR, block_x, block_y, 1, 0, ASTCENC_FLG_DECOMPRESS_ONLY, &task->_config);
-        (void)astcenc_context_alloc(&task->_config, (unsigned int)_threads.size(), &task->_context);
-        task->_context->manage_decompress.init(total_blocks);
+    (void)astcenc_config_init(ASTCENC_PRF_LDR, block_x, block_y, 1, 0, ASTCENC_FLG_DECOMPRESS_ONLY, &task->_config);
+    (void)astcenc_context_alloc(&task->_config, 1, &task->_context);
 #endif
-        return task;
-    }
-    void run()
-    {
-        const astcenc_swizzle swz_decode{ASTCENC_SWZ_R, ASTCENC_SWZ_G, ASTCENC_SWZ_B, ASTCENC_SWZ_A};
-
-        bool no_task_count = false;
-
-        for (;;)
-        {
-            std::unique_lock<astc_decompress_mutex_t> lck(_task_queue_mtx);
-            if (!_stopped && (_task_queue.empty() || no_task_count))
-                _task_queue_cv.wait(lck);
-
-            if (_stopped)
-                break;
+    return task;
+}
 
-            if (_task_queue.empty())
-                continue;
-            auto task = _task_queue.front();
-            lck.unlock();  // unlock make sure other thread can work for the task
+// decode the blocks [first, last) of the task
+static void astc_decompress_blocks(astc_decompress_task& task, unsigned int first, unsigned int last)
+{
+    const astcenc_swizzle swz_decode{ASTCENC_SWZ_R, ASTCENC_SWZ_G, ASTCENC_SWZ_B, ASTCENC_SWZ_A};
 
-            auto& image_out = task->_image_out;
+    auto& image_out = task._image_out;
 
+    unsigned int block_x = task._block_x;
+    unsigned int block_y = task._block_y;
+    unsigned int block_z = 1;  // task._block_z;
 #if ASTCDEC_NO_CONTEXT
-            unsigned int block_x = task->_block_x;
-            unsigned int block_y = task->_block_y;
-            unsigned int block_z = 1;  // task->block_z;
-            auto& bsd            = *task->_bsd;
-            auto& decompress_pm  = task->_decompress_pm;
+    auto& bsd = *task._bsd;
 #else
-            unsigned int block_x = task->_config.block_x;
-            unsigned int block_y = task->_config.block_y;
-            unsigned int block_z = 1;  // task->_config.block_z;
-            auto& bsd = *task->_context->bsd;
-            auto& decompress_pm = task->_context->manage_decompress;
+    auto& bsd = *task._context->bsd;
 #endif
-            unsigned int xblocks = task->_xblocks;
-            unsigned int yblocks = task->_yblocks;
-            unsigned int zblocks = 1;  // (image_out.dim_z + block_z - 1) / block_z;
-
-            int row_blocks   = xblocks;
-            int plane_blocks = xblocks * yblocks;
-
-            image_block blk;
-            auto data = task->_in_texels;
-            for (;;)
-            {  // process the task
-                unsigned int count = 0;
-                unsigned int base  = decompress_pm.get_task_assignment(128, count);
+    unsigned int xblocks = task._xblocks;
+    unsigned int yblocks = task._yblocks;
 
-                no_task_count = !count;
-                if (no_task_count)
-                {  // this thread will going to suspend until new task added
-                    break;
-                }
+    int row_blocks   = xblocks;
+    int plane_blocks = xblocks * yblocks;
 
-                for (unsigned int i = base; i < base + count; i++)
-                {
-                    // Decode i into x, y, z block indices
-                    int z            = i / plane_blocks;
-                    unsigned int rem = i - (z * plane_blocks);
-                    int y            = rem / row_blocks;
-                    int x            = rem - (y * row_blocks);
-
-                    unsigned int offset           = (((z * yblocks + y) * xblocks) + x) * 16;
-                    const uint8_t* bp             = data + offset;
-                    physical_compressed_block pcb = *(const physical_compressed_block*)bp;
-                    symbolic_compressed_block scb;
+    image_block blk;
+    auto data = task._in_texels;
+    for (unsigned int i = first; i < last; i++)
+    {
+        // Decode i into x, y, z block indices
+        int z            = i / plane_blocks;
+        unsigned int rem = i - (z * plane_blocks);
+        int y            = rem / row_blocks;
+        int x            = rem - (y * row_blocks);
 
-                    physical_to_symbolic(bsd, pcb, scb);
+        unsigned int offset           = (((z * yblocks + y) * xblocks) + x) * 16;
+        const uint8_t* bp             = data + offset;
+        physical_compressed_block pcb = *(const physical_compressed_block*)bp;
+        symbolic_compressed_block scb;
 
-                    decompress_symbolic_block(ASTCENC_PRF_LDR, bsd, x * block_x, y * block_y, z * block_z, scb, blk);
+        physical_to_symbolic(bsd, pcb, scb);
 
-                    store_image_block(image_out, blk, bsd, x * block_x, y * block_y, z * block_z, swz_decode);
-                }
+        decompress_symbolic_block(ASTCENC_PRF_LDR, bsd, x * block_x, y * block_y, z * block_z, scb, blk);
 
-                decompress_pm.complete_task_assignment(count);
-            }
-        }
+        store_image_block(image_out, blk, bsd, x * block_x, y * block_y, z * block_z, swz_decode);
     }
-
-    std::vector<std::thread> _threads;
-
-    std::deque<std::shared_ptr<astc_decompress_task>> _task_queue;
-    astc_decompress_mutex_t _task_queue_mtx;
-    std::condition_variable_any _task_queue_cv;
-
-    bool _stopped = false;
-};
+}
 
 int astc_decompress_image(const uint8_t* in,
                           uint32_t inlen,
@@ -282,6 +159,11 @@ int astc_decompress_image(const uint8_t* in,
     };
     benchmark_printer __printer("decompress astc image (%dx%d) cost: %.3lf(ms)", dim_x, dim_y, (float)std::milli::den);
 #endif
-    return astc_decompress_job_manager::get_instance()->decompress_parallel_sync(in, inlen, out, dim_x, dim_y, block_x,
-                                                                                 block_y);
+    auto task = astc_make_task(in, inlen, out, dim_x, dim_y, block_x, block_y);
+    if (!task)
+        return ASTCENC_ERR_OUT_OF_MEM;
+
+    texture_decode_parallel(task->_xblocks * task->_yblocks, ASTCDEC_BLOCKS_PER_CHUNK,
+                            [&task](size_t first, size_t last) { astc_decompress_blocks(*task, first, last); });
+    return ASTCENC_SUCCESS;
 }
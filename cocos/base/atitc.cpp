@@ -24,6 +24,9 @@
  ****************************************************************************/
 
 #include "base/atitc.h"
+#include "base/texture_decode_pool.h"
+
+#include <algorithm>
 
 // Decode ATITC encode block to 4x4 RGB32 pixels
 static void atitc_decode_block(uint8_t** blockData,
@@ -150,17 +153,22 @@ static void atitc_decode_block(uint8_t** blockData,
     }
 }
 
-// Decode ATITC encode data to RGB32
-void atitc_decode(uint8_t* encodeData,  // in_data
-                  uint8_t* decodeData,  // out_data
-                  const int pixelsWidth,
-                  const int pixelsHeight,
-                  ATITCDecodeFlag decodeFlag)
+// Decode the block rows [firstRow, lastRow)
+static void atitc_decode_rows(uint8_t* encodeData,
+                              uint8_t* decodeData,
+                              const int pixelsWidth,
+                              size_t firstRow,
+                              size_t lastRow,
+                              ATITCDecodeFlag decodeFlag)
 {
-    uint32_t* decodeBlockData = (uint32_t*)decodeData;
-
-    for (int block_y = 0; block_y < pixelsHeight / 4; ++block_y, decodeBlockData += 3 * pixelsWidth)  // stride =
-                                                                                                      // 3*width
+    // each row decodes width/4 blocks, then skips the 3 remaining pixel lines of the block
+    const size_t encodeRowSize = (size_t)(pixelsWidth / 4) * (decodeFlag == ATITCDecodeFlag::ATC_RGB ? 8 : 16);
+    const size_t decodeRowSize = (size_t)(pixelsWidth / 4) * 4 + 3 * (size_t)pixelsWidth;
+    encodeData += firstRow * encodeRowSize;
+    uint32_t* decodeBlockData = (uint32_t*)decodeData + firstRow * decodeRowSize;
+
+    // stride = 3*width
+    for (size_t block_y = firstRow; block_y < lastRow; ++block_y, decodeBlockData += 3 * pixelsWidth)
     {
         for (int block_x = 0; block_x < pixelsWidth / 4; ++block_x, decodeBlockData += 4)  // skip 4 pixels
         {
@@ -195,3 +203,17 @@ void atitc_decode(uint8_t* encodeData,  // in_data
         }      // for block_x
     }          // for block_y
 }
+
+// Decode ATITC encode data to RGB32
+void atitc_decode(uint8_t* encodeData,  // in_data
+                  uint8_t* decodeData,  // out_data
+                  const int pixelsWidth,
+                  const int pixelsHeight,
+                  ATITCDecodeFlag decodeFlag)
+{
+    const uint32_t blockRows    = pixelsHeight / 4;
+    const uint32_t rowsPerChunk = (std::max)(1, 1024 / (std::max)(pixelsWidth / 4, 1));  // ~1024 blocks per chunk
+    texture_decode_parallel(blockRows, rowsPerChunk, [=](size_t first, size_t last) {
+        atitc_decode_rows(encodeData, decodeData, pixelsWidth, first, last, decodeFlag);
+    });
+}
@@ -246,6 +246,15 @@ THE SOFTWARE.
     #define CC_ENABLE_PROFILERS 0
 #endif
 
+/** @def CC_ENABLE_FRAME_PROFILER
+ * If enabled, CC_PROFILE_ZONE records timed zones into the FrameProfiler, which can be exported as a Chrome trace.
+ * Recording is still off at runtime until FrameProfiler::setEnabled(true) or the console command `profiler on`.
+ * To strip the zones from the build set it to 0. Enabled by default.
+ */
+#ifndef CC_ENABLE_FRAME_PROFILER
+    #define CC_ENABLE_FRAME_PROFILER 1
+#endif
+
 /** Enable Lua engine debug log. */
 #ifndef CC_LUA_ENGINE_DEBUG
     #define CC_LUA_ENGINE_DEBUG 0
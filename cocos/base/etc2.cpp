@@ -33,6 +33,7 @@
  ****************************************************************************/
 
 #include "base/etc2.h"
+#include "base/texture_decode_pool.h"
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
@@ -993,7 +994,17 @@ int etc2_decode_image(int format, const etc2_byte* input, etc2_byte* output, etc
     if (loadTexture) {
         size_t inputRowPitch = ComputeETC2RowPitch(width, 4 /*blockWidth*/, bytesPerPixel);
         size_t inputDepthPitch = ComputeETC2DepthPitch(height, 4 /*blockHeight*/, inputRowPitch);
-        loadTexture(width, height, 1, input, inputRowPitch, inputDepthPitch, output, outputRowPitch, outputDepthPitch);
+
+        // decode slices of block rows in parallel, ~1024 blocks per slice
+        etc2_uint32 blocksPerRow = (width + 3) / 4;
+        etc2_uint32 blockRows = (height + 3) / 4;
+        etc2_uint32 rowsPerChunk = (std::max)(1u, 1024u / (std::max)(blocksPerRow, 1u));
+        texture_decode_parallel(blockRows, rowsPerChunk, [&](size_t first, size_t last) {
+            size_t y = (size_t)first * 4;
+            size_t rows = (std::min)((size_t)last * 4, (size_t)height) - y;
+            loadTexture(width, rows, 1, input + first * inputRowPitch, inputRowPitch, inputDepthPitch,
+                        output + y * outputRowPitch, outputRowPitch, outputDepthPitch);
+        });
         return 0;
     }
 
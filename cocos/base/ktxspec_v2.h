@@ -0,0 +1,116 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include <stdint.h>
+
+#define KTX_V2_HEADER_SIZE 80
+
+#define KTX_V2_MAGIC "KTX 20"
+
+// ktxv2 header, refer to: https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html
+struct KTXv2Header
+{
+    // the vkFormat values we can upload or decode, VK_FORMAT_UNDEFINED means a Basis Universal payload
+    struct VkFormat
+    {
+        enum
+        {
+            UNDEFINED = 0,
+            // RGBA8
+            R8G8B8A8_UNORM = 37,
+            R8G8B8A8_SRGB  = 43,
+            // S3TC
+            BC1_RGB_UNORM  = 131,
+            BC1_RGB_SRGB   = 132,
+            BC1_RGBA_UNORM = 133,
+            BC1_RGBA_SRGB  = 134,
+            BC2_UNORM      = 135,
+            BC2_SRGB       = 136,
+            BC3_UNORM      = 137,
+            BC3_SRGB       = 138,
+            // ETC2
+            ETC2_R8G8B8_UNORM   = 147,
+            ETC2_R8G8B8_SRGB    = 148,
+            ETC2_R8G8B8A8_UNORM = 151,
+            ETC2_R8G8B8A8_SRGB  = 152,
+            // ASTC
+            ASTC_4x4_UNORM  = 157,
+            ASTC_4x4_SRGB   = 158,
+            ASTC_5x5_UNORM  = 161,
+            ASTC_5x5_SRGB   = 162,
+            ASTC_6x6_UNORM  = 165,
+            ASTC_6x6_SRGB   = 166,
+            ASTC_8x5_UNORM  = 167,
+            ASTC_8x5_SRGB   = 168,
+            ASTC_8x6_UNORM  = 169,
+            ASTC_8x6_SRGB   = 170,
+            ASTC_8x8_UNORM  = 171,
+            ASTC_8x8_SRGB   = 172,
+            ASTC_10x5_UNORM = 173,
+            ASTC_10x5_SRGB  = 174,
+        };
+    };
+
+    struct SupercompressionScheme
+    {
+        enum
+        {
+            NONE     = 0,
+            BASIS_LZ = 1,
+            ZSTD     = 2,
+            ZLIB     = 3,
+        };
+    };
+
+    uint8_t identifier[12];
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+};
+
+// follows the header, one per mip level, level 0 is the base image
+struct KTXv2LevelIndex
+{
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+};
+
+// Data Format Descriptor, basic block: totalSize(4), vendorId/descriptorType(4), version(2), blockSize(2),
+// colorModel(1), colorPrimaries(1), transferFunction(1), flags(1)
+#define KTX_V2_DFD_FLAGS_OFFSET 15
+#define KTX_V2_DFD_FLAG_ALPHA_PREMULTIPLIED 0x1
@@ -0,0 +1,39 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __TEXTURE_DECODE_POOL_H__
+#define __TEXTURE_DECODE_POOL_H__
+/// @cond DO_NOT_SHOW
+
+#include "base/CCJobSystem.h"
+
+/**
+ * Runs func over [0, count) on the shared JobSystem for the software texture decoders (ASTC, ETC2, S3TC, ATITC)
+ * and returns once every range is done. Each decoder splits its image into blocks or block rows, so ranges write
+ * disjoint output. Several loading threads may decode at once, the calling thread works on its own ranges meanwhile.
+ */
+void texture_decode_parallel(size_t count, size_t grain, const cocos2d::JobSystem::RangeFunc& func);
+
+/// @endcond
+#endif  // __TEXTURE_DECODE_POOL_H__
@@ -40,6 +40,7 @@ THE SOFTWARE.
 
 // base
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCJobSystem.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCConsole.h"
@@ -50,12 +51,16 @@ THE SOFTWARE.
 #include "base/CCMap.h"
 #include "base/CCNS.h"
 #include "base/CCProfiling.h"
+#include "base/CCFrameProfiler.h"
+#include "base/CCFrameArena.h"
+#include "base/CCMemoryTracker.h"
 #include "base/CCProperties.h"
 #include "base/CCRef.h"
 #include "base/CCRefPtr.h"
 #include "base/CCScheduler.h"
 #include "base/CCUserDefault.h"
 #include "base/CCValue.h"
+#include "base/CCValueSnapshot.h"
 #include "base/CCVector.h"
 #include "base/ZipUtils.h"
 #include "base/base64.h"
@@ -105,6 +110,7 @@ THE SOFTWARE.
 #include "2d/CCActionInstant.h"
 #include "2d/CCActionInterval.h"
 #include "2d/CCActionManager.h"
+#include "2d/CCActionBatch.h"
 #include "2d/CCActionPageTurn3D.h"
 #include "2d/CCActionProgressTimer.h"
 #include "2d/CCActionTiledGrid.h"
@@ -134,6 +140,8 @@ THE SOFTWARE.
 #include "2d/CCProtectedNode.h"
 #include "2d/CCRenderTexture.h"
 #include "2d/CCScene.h"
+#include "2d/CCSpatialIndex.h"
+#include "2d/CCTransformSystem.h"
 #include "2d/CCTransition.h"
 #include "2d/CCTransitionPageTurn.h"
 #include "2d/CCTransitionProgress.h"
@@ -173,6 +181,7 @@ THE SOFTWARE.
 #include "physics/CCPhysicsWorld.h"
 
 // platform
+#include "platform/CCAssetArchive.h"
 #include "platform/CCCommon.h"
 #include "platform/CCDevice.h"
 #include "platform/CCFileUtils.h"
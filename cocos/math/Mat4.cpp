@@ -1054,6 +1054,16 @@ void Mat4::transformVector(float x, float y, float z, float w, Vec3* dst) const
     MathUtil::transformVec4(m, x, y, z, w, (float*)dst);
 }
 
+void Mat4::transformPoints(Vec3* points, size_t count, size_t stride) const
+{
+    GP_ASSERT(points || count == 0);
+#ifdef __SSE__
+    MathUtil::transformPoints(col, (float*)points, count, stride);
+#else
+    MathUtil::transformPoints(m, (float*)points, count, stride);
+#endif
+}
+
 void Mat4::transformVector(Vec4* vector) const
 {
     GP_ASSERT(vector);
@@ -826,6 +826,18 @@ public:
         transformVector(point.x, point.y, point.z, 1.0f, dst);
     }
 
+    /**
+     * Transforms count points by this matrix in place.
+     *
+     * Consecutive points are stride bytes apart, so the positions of interleaved
+     * vertex data such as V3F_C4B_T2F can be transformed without copying.
+     *
+     * @param points The first point to transform.
+     * @param count The number of points.
+     * @param stride The distance in bytes between two consecutive points.
+     */
+    void transformPoints(Vec3* points, size_t count, size_t stride = sizeof(Vec3)) const;
+
     /**
      * Transforms the specified vector by this matrix by
      * treating the fourth (w) coordinate as zero.
@@ -41,6 +41,8 @@ public:
     
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
+    inline static void transformPoints(const float* m, float* points, size_t count, size_t stride);
+    
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
 };
 
@@ -204,6 +206,21 @@ inline void MathUtilC::transformVec4(const float* m, const float* v, float* dst)
     dst[3] = w;
 }
 
+inline void MathUtilC::transformPoints(const float* m, float* points, size_t count, size_t stride)
+{
+    auto p = reinterpret_cast<unsigned char*>(points);
+    for (size_t i = 0; i < count; ++i, p += stride)
+    {
+        auto v = reinterpret_cast<float*>(p);
+        float x = v[0];
+        float y = v[1];
+        float z = v[2];
+        v[0] = x * m[0] + y * m[4] + z * m[8] + m[12];
+        v[1] = x * m[1] + y * m[5] + z * m[9] + m[13];
+        v[2] = x * m[2] + y * m[6] + z * m[10] + m[14];
+    }
+}
+
 inline void MathUtilC::crossVec3(const float* v1, const float* v2, float* dst)
 {
     float x = (v1[1] * v2[2]) - (v1[2] * v2[1]);
@@ -40,6 +40,8 @@ public:
     
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
+    inline static void transformPoints(const float* m, float* points, size_t count, size_t stride);
+    
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
 };
 
@@ -243,6 +245,36 @@ inline void MathUtilNeon::transformVec4(const float* m, const float* v, float* d
      );
 }
 
+inline void MathUtilNeon::transformPoints(const float* m, float* points, size_t count, size_t stride)
+{
+    if (count == 0)
+        return;
+
+    asm volatile
+    (
+     "vld1.32    {d18 - d21}, [%2]! \n\t"   // M[m0-m7]
+     "vld1.32    {d22 - d25}, [%2]  \n\t"   // M[m8-m15]
+     "1:                            \n\t"
+     "add        r12, %0, #8        \n\t"
+     "vld1.32    {d0}, [%0]         \n\t"   // V[x, y]
+     "vld1.32    {d1[0]}, [r12]     \n\t"   // V[z]
+
+     "vmov.f32   q13, q12           \n\t"   // DST->V = M[m12-m15] * 1
+     "vmla.f32   q13, q9, d0[0]     \n\t"   // DST->V += M[m0-m3] * V[x]
+     "vmla.f32   q13, q10, d0[1]    \n\t"   // DST->V += M[m4-m7] * V[y]
+     "vmla.f32   q13, q11, d1[0]    \n\t"   // DST->V += M[m8-m11] * V[z]
+
+     "vst1.32    {d26}, [%0]        \n\t"   // DST->V[x, y]
+     "vst1.32    {d27[0]}, [r12]    \n\t"   // DST->V[z]
+     "add        %0, %0, %3         \n\t"   // next point
+     "subs       %1, %1, #1         \n\t"
+     "bne        1b                 \n\t"
+     : "+r"(points), "+r"(count), "+r"(m)
+     : "r"(stride)
+     : "r12", "q0", "q9", "q10", "q11", "q12", "q13", "cc", "memory"
+     );
+}
+
 inline void MathUtilNeon::crossVec3(const float* v1, const float* v2, float* dst)
 {
     asm volatile(
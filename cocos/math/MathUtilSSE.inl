@@ -151,6 +151,21 @@ void MathUtil::transformVec4(const __m128 m[4], const __m128& v, __m128& dst)
                      );
 }
 
+void MathUtil::transformPoints(const __m128 m[4], float* points, size_t count, size_t stride)
+{
+    auto p = reinterpret_cast<unsigned char*>(points);
+    for (size_t i = 0; i < count; ++i, p += stride)
+    {
+        auto v = reinterpret_cast<float*>(p);
+        __m128 dst = _mm_add_ps(
+                     _mm_add_ps(_mm_mul_ps(m[0], _mm_set1_ps(v[0])), _mm_mul_ps(m[1], _mm_set1_ps(v[1]))),
+                     _mm_add_ps(_mm_mul_ps(m[2], _mm_set1_ps(v[2])), m[3])
+                     );
+        _mm_storel_pi(reinterpret_cast<__m64*>(v), dst);   // DST->V[x, y]
+        _mm_store_ss(v + 2, _mm_movehl_ps(dst, dst));      // DST->V[z]
+    }
+}
+
 #endif
 
 
@@ -0,0 +1,308 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCAssetArchive.h"
+#include "base/ccMacros.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+
+NS_CC_BEGIN
+
+namespace
+{
+/*
+ * All offsets are from the beginning of the archive, in little endian.
+ *
+ * Header   : magic, version, entry count, bucket count, index offset, index size, archive size
+ * Data     : the entries, stored ones aligned to AssetArchive::STORED_ALIGNMENT
+ * Index    : uint32 bucket starts [bucket count + 1], padded to 8 bytes
+ *            AssetArchive::Entry [entry count], grouped by bucket (path hash & (bucket count - 1))
+ *            paths, NUL terminated
+ */
+struct ArchiveHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t bucketCount;
+    uint64_t indexOffset;
+    uint64_t indexSize;
+    uint64_t archiveSize;
+};
+
+const uint32_t ARCHIVE_MAGIC = 0x4B504343;  // "CCPK"
+
+static_assert(sizeof(ArchiveHeader) == 40, "the header layout is part of the archive format");
+static_assert(sizeof(AssetArchive::Entry) == 32, "the entry layout is part of the archive format");
+
+inline uint8_t normalizePathChar(char c)
+{
+    return c == '\\' ? '/' : static_cast<uint8_t>(c);
+}
+}  // namespace
+
+uint64_t AssetArchive::hashPath(std::string_view path)
+{
+    // FNV-1a, simple enough for the packer to compute without dependencies
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (auto c : path)
+    {
+        hash ^= normalizePathChar(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool AssetArchive::openFile(std::string_view fullPath)
+{
+    _data.clear();
+    _bytes = nullptr;
+
+    std::error_code error;
+    _mapping.map(std::string{fullPath}, error);
+    if (error)
+        return false;
+
+    return validate(reinterpret_cast<const uint8_t*>(_mapping.data()), _mapping.size());
+}
+
+bool AssetArchive::openData(Data data)
+{
+    _mapping.unmap();
+    _bytes = nullptr;
+
+    _data = std::move(data);
+    return validate(_data.getBytes(), static_cast<size_t>(_data.getSize()));
+}
+
+bool AssetArchive::validate(const uint8_t* bytes, size_t size)
+{
+    ArchiveHeader header;
+    if (bytes == nullptr || size < sizeof(header))
+        return false;
+
+    memcpy(&header, bytes, sizeof(header));
+    if (header.magic != ARCHIVE_MAGIC || header.version != VERSION || header.archiveSize != size)
+        return false;
+
+    // the index is read in place, it must be aligned for the entries
+    const uint64_t bucketsSize = (static_cast<uint64_t>(header.bucketCount) + 1) * sizeof(uint32_t);
+    const uint64_t entriesOffset = (bucketsSize + 7) & ~7ULL;
+    const uint64_t entriesSize   = static_cast<uint64_t>(header.entryCount) * sizeof(Entry);
+    if (header.bucketCount == 0 || (header.bucketCount & (header.bucketCount - 1)) != 0 ||
+        header.indexOffset % 8 != 0 || header.indexOffset < sizeof(header) || header.indexOffset > size ||
+        header.indexSize > size - header.indexOffset || entriesOffset + entriesSize > header.indexSize)
+        return false;
+
+    const uint8_t* index = bytes + header.indexOffset;
+    auto buckets         = reinterpret_cast<const uint32_t*>(index);
+    if (buckets[0] != 0 || buckets[header.bucketCount] != header.entryCount)
+    {
+        CCLOG("cocos2d: AssetArchive: corrupted index");
+        return false;
+    }
+
+    _bytes      = bytes;
+    _size       = size;
+    _buckets    = buckets;
+    _bucketMask = header.bucketCount - 1;
+    _entries    = reinterpret_cast<const Entry*>(index + entriesOffset);
+    _entryCount = header.entryCount;
+    _paths      = reinterpret_cast<const char*>(index + entriesOffset + entriesSize);
+    _pathsSize  = static_cast<size_t>(header.indexSize - entriesOffset - entriesSize);
+    return true;
+}
+
+const AssetArchive::Entry* AssetArchive::find(std::string_view path) const
+{
+    if (!_bytes)
+        return nullptr;
+
+    const uint64_t hash = hashPath(path);
+    const auto bucket   = static_cast<uint32_t>(hash) & _bucketMask;
+    const uint32_t last = std::min(_buckets[bucket + 1], _entryCount);
+    for (uint32_t i = _buckets[bucket]; i < last; ++i)
+    {
+        const Entry* entry = _entries + i;
+        if (entry->pathHash != hash || entry->pathLength != path.size())
+            continue;
+
+        auto entryPath = getEntryPath(entry);
+        if (entryPath.size() != path.size())
+            continue;
+
+        size_t k = 0;
+        while (k < path.size() && static_cast<uint8_t>(entryPath[k]) == normalizePathChar(path[k]))
+            ++k;
+        if (k == path.size())
+            return entry;
+    }
+    return nullptr;
+}
+
+std::string_view AssetArchive::getEntryPath(const Entry* entry) const
+{
+    if (entry->pathOffset > _pathsSize || entry->pathLength > _pathsSize - entry->pathOffset)
+        return std::string_view{};
+    return std::string_view{_paths + entry->pathOffset, entry->pathLength};
+}
+
+std::string_view AssetArchive::getStoredData(const Entry* entry) const
+{
+    if (entry->method != Method::STORED || entry->offset > _size || entry->size > _size - entry->offset)
+        return std::string_view{};
+    return std::string_view{reinterpret_cast<const char*>(_bytes) + entry->offset, entry->size};
+}
+
+bool AssetArchive::read(const Entry* entry, void* buffer) const
+{
+    if (entry->offset > _size || entry->compressedSize > _size - entry->offset)
+        return false;
+
+    const uint8_t* source = _bytes + entry->offset;
+    switch (entry->method)
+    {
+    case Method::STORED:
+        if (entry->compressedSize != entry->size)
+            return false;
+        memcpy(buffer, source, entry->size);
+        return true;
+    case Method::DEFLATE:
+    {
+        uLongf destLen = entry->size;
+        return uncompress(static_cast<Bytef*>(buffer), &destLen, source, entry->compressedSize) == Z_OK &&
+               destLen == entry->size;
+    }
+    default:
+        CCLOG("cocos2d: AssetArchive: unsupported compression method %u for %s",
+              static_cast<unsigned int>(entry->method), std::string{getEntryPath(entry)}.c_str());
+        return false;
+    }
+}
+
+bool AssetArchiveStream::open(std::string_view path, FileStream::Mode mode)
+{
+    close();
+    if (mode != FileStream::Mode::READ || !_archive)
+        return false;
+
+    auto entry = _archive->find(path);
+    if (!entry)
+        return false;
+
+    if (entry->method == AssetArchive::Method::STORED)
+    {
+        auto stored = _archive->getStoredData(entry);
+        if (stored.data() == nullptr || stored.size() != entry->size)
+            return false;
+        _bytes = reinterpret_cast<const uint8_t*>(stored.data());
+    }
+    else
+    {
+        _inflated.reset(new uint8_t[entry->size > 0 ? entry->size : 1]);
+        if (!_archive->read(entry, _inflated.get()))
+        {
+            _inflated.reset();
+            return false;
+        }
+        _bytes = _inflated.get();
+    }
+    _size     = entry->size;
+    _position = 0;
+    return true;
+}
+
+int AssetArchiveStream::close()
+{
+    _inflated.reset();
+    _bytes    = nullptr;
+    _size     = 0;
+    _position = 0;
+    return 0;
+}
+
+int AssetArchiveStream::seek(int64_t offset, int origin)
+{
+    if (!_bytes)
+        return -1;
+
+    int64_t position;
+    switch (origin)
+    {
+    case SEEK_SET:
+        position = offset;
+        break;
+    case SEEK_CUR:
+        position = _position + offset;
+        break;
+    case SEEK_END:
+        position = _size + offset;
+        break;
+    default:
+        return -1;
+    }
+    if (position < 0)
+        return -1;
+
+    _position = position;
+    return 0;
+}
+
+int AssetArchiveStream::read(void* buf, unsigned int size)
+{
+    if (!_bytes)
+        return -1;
+
+    if (_position >= _size)
+        return 0;
+
+    const auto count = static_cast<unsigned int>(std::min<int64_t>(size, _size - _position));
+    memcpy(buf, _bytes + _position, count);
+    _position += count;
+    return static_cast<int>(count);
+}
+
+int AssetArchiveStream::write(const void* /*buf*/, unsigned int /*size*/)
+{
+    return -1;
+}
+
+int64_t AssetArchiveStream::tell()
+{
+    return _bytes ? _position : -1;
+}
+
+int64_t AssetArchiveStream::size()
+{
+    return _bytes ? _size : -1;
+}
+
+bool AssetArchiveStream::isOpen() const
+{
+    return _bytes != nullptr;
+}
+
+NS_CC_END
@@ -0,0 +1,164 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "platform/CCFileStream.h"
+#include "base/CCData.h"
+#include "mio/mio.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class AssetArchive
+ * @brief A read only pack of asset files, indexed by a hash table of their paths.
+ * The archive is memory mapped and its index is used in place, so opening an archive costs the same whatever the
+ * number of files. Stored entries are 4KB aligned and are read without a copy, deflated entries are inflated when they
+ * are read.
+ * Archives are built by tools/asset-archive/pack.py, and are usually mounted with FileUtils::mountArchive.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL AssetArchive
+{
+public:
+    /** Incremented whenever the layout changes, archives of another version are invalid. */
+    static const uint32_t VERSION = 1;
+
+    /** Stored entries start at a multiple of this, so that they can be mapped and read in place. */
+    static const uint32_t STORED_ALIGNMENT = 4096;
+
+    enum class Method : uint8_t
+    {
+        STORED  = 0,
+        DEFLATE = 1,
+        /** Reserved, not supported by this build. */
+        LZ4 = 2,
+        /** Reserved, not supported by this build. */
+        ZSTD = 3,
+    };
+
+    /** An entry of the index, as laid out in the archive. */
+    struct Entry
+    {
+        uint64_t pathHash;
+        uint64_t offset;
+        uint32_t compressedSize;
+        uint32_t size;
+        uint32_t pathOffset;
+        uint16_t pathLength;
+        Method method;
+        uint8_t reserved;
+    };
+
+    /** Hashes a path the way the packer does, '\\' is hashed as '/'. */
+    static uint64_t hashPath(std::string_view path);
+
+    /** Memory maps an archive file, the path must be a real path of the file system. */
+    bool openFile(std::string_view fullPath);
+
+    /** Uses an archive loaded into memory. */
+    bool openData(Data data);
+
+    bool isValid() const { return _bytes != nullptr; }
+
+    uint32_t getEntryCount() const { return _entryCount; }
+
+    /** Gets an entry by its path relative to the archive root, nullptr if there is none. */
+    const Entry* find(std::string_view path) const;
+
+    /** Gets the entry at index, entries are grouped by hash bucket. */
+    const Entry* getEntryAt(uint32_t index) const { return index < _entryCount ? _entries + index : nullptr; }
+
+    /** Gets the path of an entry. */
+    std::string_view getEntryPath(const Entry* entry) const;
+
+    /** Gets the bytes of a stored entry in place, an empty view if the entry is compressed. */
+    std::string_view getStoredData(const Entry* entry) const;
+
+    /**
+     * Reads an entry, decompressing it if needed.
+     * @param entry The entry to read.
+     * @param buffer At least entry->size bytes.
+     * @return false if the entry is corrupted, or compressed with an unsupported method.
+     */
+    bool read(const Entry* entry, void* buffer) const;
+
+private:
+    bool validate(const uint8_t* bytes, size_t size);
+
+    mio::mmap_source _mapping;
+    Data _data;
+    const uint8_t* _bytes     = nullptr;
+    size_t _size              = 0;
+    const uint32_t* _buckets  = nullptr;
+    uint32_t _bucketMask      = 0;
+    const Entry* _entries     = nullptr;
+    uint32_t _entryCount      = 0;
+    const char* _paths        = nullptr;
+    size_t _pathsSize         = 0;
+};
+
+/**
+ * @class AssetArchiveStream
+ * @brief A read only FileStream over an entry of an AssetArchive.
+ * Stored entries are read from the mapping, compressed entries are inflated once when the stream is opened.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL AssetArchiveStream : public FileStream
+{
+public:
+    explicit AssetArchiveStream(std::shared_ptr<const AssetArchive> archive) : _archive(std::move(archive)) {}
+
+    /** Opens an entry of the archive, path is relative to the archive root and mode must be READ. */
+    bool open(std::string_view path, FileStream::Mode mode) override;
+    int close() override;
+
+    int seek(int64_t offset, int origin) override;
+    int read(void* buf, unsigned int size) override;
+    int write(const void* buf, unsigned int size) override;
+    int64_t tell() override;
+    int64_t size() override;
+    bool isOpen() const override;
+
+private:
+    std::shared_ptr<const AssetArchive> _archive;
+    std::unique_ptr<uint8_t[]> _inflated;
+    const uint8_t* _bytes = nullptr;
+    int64_t _size         = 0;
+    int64_t _position     = 0;
+};
+
+NS_CC_END
+// end group
+/// @}
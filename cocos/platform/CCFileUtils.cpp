@@ -34,8 +34,10 @@ THE SOFTWARE.
 #include "base/CCData.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
+#include "base/CCValueSnapshot.h"
 #include "platform/CCSAXParser.h"
 #include "platform/CCPosixFileStream.h"
+#include "platform/CCAssetArchive.h"
 
 #ifdef MINIZIP_FROM_SYSTEM
     #include <minizip/unzip.h>
@@ -50,6 +52,7 @@ THE SOFTWARE.
 #endif
 
 #include "pugixml/pugixml.hpp"
+#include "xxhash.h"
 
 #define DECLARE_GUARD (void)0
 
@@ -148,6 +151,18 @@ public:
         return _rootArray;
     }
 
+    ValueVector arrayWithDataOfFile(const char* filedata, int filesize)
+    {
+        _resultType = SAX_RESULT_ARRAY;
+        SAXParser parser;
+
+        CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
+        parser.setDelegator(this);
+
+        parser.parse(filedata, filesize);
+        return _rootArray;
+    }
+
     void startElement(void* ctx, const char* name, const char** atts) override
     {
         const std::string sName(name);
@@ -344,6 +359,13 @@ public:
 ValueMap FileUtils::getValueMapFromFile(std::string_view filename) const
 {
     const std::string fullPath = fullPathForFilename(filename);
+    if (_valueSnapshotCacheEnabled)
+    {
+        auto snapshot = getValueSnapshotFromFile(fullPath);
+        if (snapshot && snapshot->getRoot().getType() == Value::Type::MAP)
+            return snapshot->getRoot().toValueMap();
+    }
+
     DictMaker tMaker;
     return tMaker.dictionaryWithContentsOfFile(fullPath);
 }
@@ -357,10 +379,119 @@ ValueMap FileUtils::getValueMapFromData(const char* filedata, int filesize) cons
 ValueVector FileUtils::getValueVectorFromFile(std::string_view filename) const
 {
     const std::string fullPath = fullPathForFilename(filename);
+    if (_valueSnapshotCacheEnabled)
+    {
+        auto snapshot = getValueSnapshotFromFile(fullPath);
+        if (snapshot && snapshot->getRoot().getType() == Value::Type::VECTOR)
+            return snapshot->getRoot().toValueVector();
+    }
+
     DictMaker tMaker;
     return tMaker.arrayWithContentsOfFile(fullPath);
 }
 
+Value FileUtils::parseValueFromData(const Data& data) const
+{
+    // the root of a plist is the first dict or array element
+    std::string_view text(reinterpret_cast<const char*>(data.getBytes()), static_cast<size_t>(data.getSize()));
+    auto dictPos  = text.find("<dict"sv);
+    auto arrayPos = text.find("<array"sv);
+    if (dictPos == std::string_view::npos && arrayPos == std::string_view::npos)
+        return Value::Null;
+
+    DictMaker tMaker;
+    if (dictPos < arrayPos)
+        return Value(tMaker.dictionaryWithDataOfFile(text.data(), static_cast<int>(text.size())));
+    return Value(tMaker.arrayWithDataOfFile(text.data(), static_cast<int>(text.size())));
+}
+
+std::shared_ptr<ValueSnapshot> FileUtils::openValueSnapshot(std::string_view fullPath) const
+{
+    if (!isFileExist(fullPath))
+        return nullptr;
+
+    // files inside a package, such as the apk, can't be mapped
+    auto snapshot = std::make_shared<ValueSnapshot>();
+    if (!(isAbsolutePath(fullPath) && snapshot->openFile(fullPath)) && !snapshot->openData(getDataFromFile(fullPath)))
+        return nullptr;
+    return snapshot;
+}
+
+std::shared_ptr<ValueSnapshot> FileUtils::getValueSnapshotFromFile(std::string_view filename) const
+{
+    const std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return nullptr;
+
+    if (getFileExtension(fullPath) == ".vsnap"sv)
+        return openValueSnapshot(fullPath);
+
+    Data source = getDataFromFile(fullPath);
+    if (source.isNull())
+        return nullptr;
+
+    // hashing the plist is far cheaper than parsing it
+    uint64_t sourceHash = XXH64(source.getBytes(), static_cast<size_t>(source.getSize()), 0);
+
+    char hashName[32];
+    snprintf(hashName, sizeof(hashName), "%016llx.vsnap", static_cast<unsigned long long>(sourceHash));
+    const std::string snapshotPaths[] = {fullPath + ".vsnap", getWritablePath() + "vsnap/" + hashName};
+
+    for (auto&& snapshotPath : snapshotPaths)
+    {
+        auto snapshot = openValueSnapshot(snapshotPath);
+        if (snapshot && snapshot->getSourceHash() == sourceHash)
+            return snapshot;
+    }
+
+    Value root = parseValueFromData(source);
+    std::string encoded;
+    if (root.isNull() || !ValueSnapshot::encode(root, sourceHash, &encoded))
+        return nullptr;
+
+    if (!writeValueSnapshot(encoded, snapshotPaths[0]))
+    {
+        createDirectory(getWritablePath() + "vsnap/");
+        writeValueSnapshot(encoded, snapshotPaths[1]);
+    }
+
+    Data data;
+    data.copy(reinterpret_cast<const unsigned char*>(encoded.data()), static_cast<ssize_t>(encoded.size()));
+    auto snapshot = std::make_shared<ValueSnapshot>();
+    snapshot->openData(std::move(data));
+    return snapshot;
+}
+
+bool FileUtils::compileValueSnapshot(std::string_view filename, std::string_view snapshotPath) const
+{
+    const std::string fullPath = fullPathForFilename(filename);
+    Data source                = getDataFromFile(fullPath);
+    if (source.isNull())
+        return false;
+
+    Value root = parseValueFromData(source);
+    std::string encoded;
+    uint64_t sourceHash = XXH64(source.getBytes(), static_cast<size_t>(source.getSize()), 0);
+    if (root.isNull() || !ValueSnapshot::encode(root, sourceHash, &encoded))
+        return false;
+
+    return writeValueSnapshot(encoded, snapshotPath.empty() ? fullPath + ".vsnap" : std::string{snapshotPath});
+}
+
+bool FileUtils::writeValueSnapshot(std::string_view encoded, const std::string& snapshotPath) const
+{
+    // a snapshot loaded earlier may map the old file, truncating it under the mapping would fault on the next access
+    const std::string tempPath = snapshotPath + ".tmp";
+    if (!writeStringToFile(encoded, tempPath))
+        return false;
+
+    if (renameFile(tempPath, snapshotPath))
+        return true;
+
+    removeFile(tempPath);
+    return false;
+}
+
 /*
  * forward statement
  */
@@ -476,7 +607,7 @@ void FileUtils::setDelegate(FileUtils* delegate)
     s_sharedFileUtils = delegate;
 }
 
-FileUtils::FileUtils() : _writablePath("") {}
+FileUtils::FileUtils() : _writablePath(""), _valueSnapshotCacheEnabled(false) {}
 
 FileUtils::~FileUtils() {}
 
@@ -583,6 +714,10 @@ FileUtils::Status FileUtils::getContents(std::string_view filename, ResizableBuf
 
     const auto fullPath = fileUtils->fullPathForFilename(filename);
 
+    Status status;
+    if (fileUtils->getContentsFromArchive(fullPath, buffer, &status))
+        return status;
+
     auto fileStream = fileUtils->openFileStream(fullPath, FileStream::Mode::READ);
     if (!fileStream)
         return Status::OpenFailed;
@@ -692,7 +827,15 @@ std::string FileUtils::fullPathForFilename(std::string_view filename) const
 
     for (const auto& searchIt : _searchPathArray)
     {
-        fullpath = this->getPathForFilename(filename, searchIt);
+        std::string_view entryPath;
+        if (auto archive = findArchive(searchIt, &entryPath))
+        {
+            // the search path may be a directory of the archive
+            const std::string entryName = std::string{entryPath}.append(filename);
+            fullpath = archive->find(entryName) ? std::string{searchIt}.append(filename) : std::string{};
+        }
+        else
+            fullpath = this->getPathForFilename(filename, searchIt);
 
         if (!fullpath.empty())
         {
@@ -883,6 +1026,90 @@ void FileUtils::addSearchPath(std::string_view searchpath, const bool front)
     }
 }
 
+bool FileUtils::mountArchive(std::string_view archivePath, bool front)
+{
+    DECLARE_GUARD;
+    const std::string fullPath = fullPathForFilename(archivePath);
+    if (fullPath.empty())
+        return false;
+
+    // archives inside a package, such as the apk, can't be mapped and are loaded into memory
+    auto archive = std::make_shared<AssetArchive>();
+    if (!(isAbsolutePath(fullPath) && archive->openFile(fullPath)) && !archive->openData(getDataFromFile(fullPath)))
+    {
+        CCLOG("cocos2d: mountArchive: %s isn't a valid asset archive.", fullPath.c_str());
+        return false;
+    }
+
+    unmountArchive(fullPath);
+    std::string mountPoint = fullPath + '/';
+    {
+        std::lock_guard<std::mutex> lock(_archivesMutex);
+        _archives.emplace_back(mountPoint, std::move(archive));
+    }
+    addSearchPath(mountPoint, front);
+
+    // cached paths may be shadowed by the archive
+    _fullPathCache.clear();
+    return true;
+}
+
+void FileUtils::unmountArchive(std::string_view archivePath)
+{
+    DECLARE_GUARD;
+    const std::string mountPoint = fullPathForFilename(archivePath) + '/';
+
+    {
+        std::lock_guard<std::mutex> lock(_archivesMutex);
+        auto it = std::find_if(_archives.begin(), _archives.end(),
+                               [&mountPoint](const auto& mounted) { return mounted.first == mountPoint; });
+        if (it == _archives.end())
+            return;
+
+        _archives.erase(it);
+    }
+    _searchPathArray.erase(std::remove(_searchPathArray.begin(), _searchPathArray.end(), mountPoint),
+                           _searchPathArray.end());
+    _originalSearchPaths.erase(std::remove(_originalSearchPaths.begin(), _originalSearchPaths.end(), mountPoint),
+                               _originalSearchPaths.end());
+    _fullPathCache.clear();
+    _fullPathCacheDir.clear();
+}
+
+std::shared_ptr<AssetArchive> FileUtils::findArchive(std::string_view fullPath, std::string_view* entryPath) const
+{
+    // the archive is returned by value, so it outlives an unmount while being read
+    std::lock_guard<std::mutex> lock(_archivesMutex);
+    for (auto&& mounted : _archives)
+    {
+        if (fullPath.compare(0, mounted.first.size(), mounted.first) == 0)
+        {
+            *entryPath = fullPath.substr(mounted.first.size());
+            return mounted.second;
+        }
+    }
+    return nullptr;
+}
+
+bool FileUtils::getContentsFromArchive(std::string_view fullPath, ResizableBuffer* buffer, Status* status) const
+{
+    std::string_view entryPath;
+    auto archive = findArchive(fullPath, &entryPath);
+    if (!archive)
+        return false;
+
+    auto entry = archive->find(entryPath);
+    if (!entry)
+    {
+        *status = Status::NotExists;
+        return true;
+    }
+
+    buffer->resize(entry->size);
+    *status = (entry->size == 0 || archive->read(entry, buffer->buffer())) ? Status::OK : Status::ReadFailed;
+    return true;
+}
+
 std::string FileUtils::getFullPathForFilenameWithinDirectory(std::string_view directory,
                                                              std::string_view filename) const
 {
@@ -903,6 +1130,10 @@ std::string FileUtils::getFullPathForFilenameWithinDirectory(std::string_view di
 
 bool FileUtils::isFileExist(std::string_view filename) const
 {
+    std::string_view entryPath;
+    if (auto archive = findArchive(filename, &entryPath))
+        return archive->find(entryPath) != nullptr;
+
     if (isAbsolutePath(filename))
     {
         return isFileExistInternal(filename);
@@ -1042,6 +1273,13 @@ void FileUtils::listFilesRecursivelyAsync(std::string_view dirPath,
 
 std::unique_ptr<FileStream> FileUtils::openFileStream(std::string_view filePath, FileStream::Mode mode)
 {
+    std::string_view entryPath;
+    if (auto archive = findArchive(filePath, &entryPath))
+    {
+        auto stream = std::make_unique<AssetArchiveStream>(std::move(archive));
+        return stream->open(entryPath, mode) ? std::move(stream) : nullptr;
+    }
+
     PosixFileStream fs;
     return fs.open(filePath, mode) ? std::make_unique<PosixFileStream>(std::move(fs)) : nullptr;
 }
@@ -1340,6 +1578,13 @@ int64_t FileUtils::getFileSize(std::string_view filepath) const
     else
         path = filepath;
 
+    std::string_view entryPath;
+    if (auto archive = findArchive(path, &entryPath))
+    {
+        auto entry = archive->find(entryPath);
+        return entry ? static_cast<int64_t>(entry->size) : -1;
+    }
+
     struct stat info;
     // Get data associated with "crt_stat.c":
     int result = ::stat(path.data(), &info);
@@ -48,6 +48,9 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class ValueSnapshot;
+class AssetArchive;
+
 /**
  * @addtogroup platform
  * @{
@@ -342,6 +345,23 @@ public:
      */
     void addSearchPath(std::string_view path, const bool front = false);
 
+    /**
+     * Mounts an asset archive as a search path.
+     * Files of the archive are then found by fullPathForFilename, as "<archive full path>/<path in the archive>",
+     * and read by getContents, getDataFromFile, openFileStream and friends like loose files.
+     * @param archivePath The archive, built by tools/asset-archive/pack.py.
+     * @param front Whether the archive is searched before the current search paths.
+     * @return false if the archive doesn't exist or isn't valid.
+     * @note Like addSearchPath, mounting changes the search paths and must not race with loads on other threads.
+     */
+    bool mountArchive(std::string_view archivePath, bool front = false);
+
+    /**
+     * Unmounts an archive mounted by mountArchive, and removes its search path.
+     * @note Must not race with loads on other threads, a file already opened from the archive stays readable.
+     */
+    void unmountArchive(std::string_view archivePath);
+
     /**
      *  Gets the array of search paths.
      *
@@ -525,6 +545,33 @@ public:
     // This method is used internally.
     virtual ValueVector getValueVectorFromFile(std::string_view filename) const;
 
+    /**
+     *  Sets whether plists are cached as binary snapshots, disabled by default.
+     *  When enabled, getValueMapFromFile and getValueVectorFromFile read the snapshot compiled by a previous run instead
+     *  of parsing the plist again. Snapshots are keyed by the hash of the plist content, and written next to the plist
+     *  as `<plist>.vsnap`, or as `<writable path>/vsnap/<hash>.vsnap` when the plist directory is read only.
+     */
+    void setValueSnapshotCacheEnabled(bool enabled) { _valueSnapshotCacheEnabled = enabled; }
+
+    /** Checks whether plists are cached as binary snapshots. */
+    bool isValueSnapshotCacheEnabled() const { return _valueSnapshotCacheEnabled; }
+
+    /**
+     *  Gets the snapshot of a plist, read lazily from a memory mapped file when possible. It's compiled and cached
+     *  when there is no snapshot of the current content of the plist, whether the cache is enabled or not.
+     *  @param filename The plist, or a snapshot file ending with `.vsnap`.
+     *  @return The snapshot, nullptr if the file can't be read or isn't a plist.
+     */
+    virtual std::shared_ptr<ValueSnapshot> getValueSnapshotFromFile(std::string_view filename) const;
+
+    /**
+     *  Compiles a plist into a snapshot file, so that snapshots can be shipped next to the plists.
+     *  @param filename The plist.
+     *  @param snapshotPath The full path of the snapshot, empty for `<plist full path>.vsnap`.
+     *  @return True if the snapshot was written.
+     */
+    virtual bool compileValueSnapshot(std::string_view filename, std::string_view snapshotPath = "") const;
+
     /**
      *  Checks whether a file exists.
      *
@@ -867,6 +914,30 @@ protected:
      */
     std::string _writablePath;
 
+    /**
+     * Whether plists are cached as binary snapshots.
+     */
+    bool _valueSnapshotCacheEnabled;
+
+    /** Parses a plist into a ValueMap or ValueVector, according to its root element. */
+    Value parseValueFromData(const Data& data) const;
+
+    /** Loads a snapshot file, nullptr if it doesn't exist or isn't valid. */
+    std::shared_ptr<ValueSnapshot> openValueSnapshot(std::string_view fullPath) const;
+
+    /** Writes an encoded snapshot through a temporary file renamed over the old one, which may still be mapped. */
+    bool writeValueSnapshot(std::string_view encoded, const std::string& snapshotPath) const;
+
+    /** Gets the mounted archive fullPath is inside of, and the path of the file in it. nullptr if there is none. */
+    std::shared_ptr<AssetArchive> findArchive(std::string_view fullPath, std::string_view* entryPath) const;
+
+    /** Reads a file of a mounted archive, returns false if fullPath isn't inside a mounted archive. */
+    bool getContentsFromArchive(std::string_view fullPath, ResizableBuffer* buffer, Status* status) const;
+
+    /** The mounted archives, by search path. Guarded by _archivesMutex, files are read from loading threads. */
+    std::vector<std::pair<std::string, std::shared_ptr<AssetArchive>>> _archives;
+    mutable std::mutex _archivesMutex;
+
     /**
      *  The singleton pointer of FileUtils.
      */
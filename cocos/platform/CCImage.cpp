@@ -105,6 +105,7 @@ struct dirent* readdir$INODE64(DIR* dir)
 } /* extern "C" */
 
 #include "base/ktxspec_v1.h"
+#include "base/ktxspec_v2.h"
 
 #include "base/s3tc.h"
 #include "base/atitc.h"
@@ -685,6 +686,9 @@ bool Image::initWithImageData(uint8_t* data, ssize_t dataLen, bool ownData)
         case Format::ASTC:
             ret = initWithASTCData(unpackedData, unpackedLen, ownData);
             break;
+        case Format::KTX2:
+            ret = initWithKTX2Data(unpackedData, unpackedLen, ownData);
+            break;
         case Format::BMP:
             ret = initWithBmpData(unpackedData, unpackedLen);
             break;
@@ -789,6 +793,18 @@ bool Image::isASTC(const uint8_t* data, ssize_t /*dataLen*/)
     return (magicval == ASTC_MAGIC_ID);
 }
 
+bool Image::isKTX2(const uint8_t* data, ssize_t dataLen)
+{
+    if (dataLen < KTX_V2_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    auto header = (const KTXv2Header*)data;
+    return header->identifier[0] == 0xAB &&
+           memcmp(&header->identifier[1], KTX_V2_MAGIC, sizeof(KTX_V2_MAGIC) - 1) == 0;
+}
+
 bool Image::isJpg(const uint8_t* data, ssize_t dataLen)
 {
     if (dataLen <= 4)
@@ -866,6 +882,10 @@ Image::Format Image::detectFormat(const uint8_t* data, ssize_t dataLen)
     {
         return Format::ASTC;
     }
+    else if (isKTX2(data, dataLen))
+    {
+        return Format::KTX2;
+    }
     else if (dataLen >= KTX_V1_HEADER_SIZE)
     {  // Check whether ktxspec v1.1 file format
         auto header = (KTXv1Header*)data;
@@ -2187,6 +2207,256 @@ bool Image::initWithPVRData(uint8_t* data, ssize_t dataLen, bool ownData)
     return initWithPVRv2Data(data, dataLen, ownData) || initWithPVRv3Data(data, dataLen, ownData);
 }
 
+namespace
+{
+enum class KTX2Codec
+{
+    NONE,
+    RGBA8,
+    S3TC,
+    ETC2,
+    ASTC,
+};
+
+// describes how the raw blocks of a KTX2 vkFormat are uploaded, or decoded when the device lacks the codec
+struct KTX2FormatInfo
+{
+    KTX2Codec codec;
+    backend::PixelFormat format;
+    uint8_t blockWidth;
+    uint8_t blockHeight;
+    uint8_t blockBytes;
+    int decodeFlag;  // S3TCDecodeFlag or ETC2_*_NO_MIPMAPS
+};
+
+KTX2FormatInfo getKTX2FormatInfo(uint32_t vkFormat)
+{
+    using VkFormat = KTXv2Header::VkFormat;
+    switch (vkFormat)
+    {
+    case VkFormat::R8G8B8A8_UNORM:
+    case VkFormat::R8G8B8A8_SRGB:
+        return {KTX2Codec::RGBA8, backend::PixelFormat::RGBA8, 1, 1, 4, 0};
+    case VkFormat::BC1_RGB_UNORM:
+    case VkFormat::BC1_RGB_SRGB:
+    case VkFormat::BC1_RGBA_UNORM:
+    case VkFormat::BC1_RGBA_SRGB:
+        return {KTX2Codec::S3TC, backend::PixelFormat::S3TC_DXT1, 4, 4, 8, (int)S3TCDecodeFlag::DXT1};
+    case VkFormat::BC2_UNORM:
+    case VkFormat::BC2_SRGB:
+        return {KTX2Codec::S3TC, backend::PixelFormat::S3TC_DXT3, 4, 4, 16, (int)S3TCDecodeFlag::DXT3};
+    case VkFormat::BC3_UNORM:
+    case VkFormat::BC3_SRGB:
+        return {KTX2Codec::S3TC, backend::PixelFormat::S3TC_DXT5, 4, 4, 16, (int)S3TCDecodeFlag::DXT5};
+    case VkFormat::ETC2_R8G8B8_UNORM:
+    case VkFormat::ETC2_R8G8B8_SRGB:
+        return {KTX2Codec::ETC2, backend::PixelFormat::ETC2_RGB, 4, 4, 8, ETC2_RGB_NO_MIPMAPS};
+    case VkFormat::ETC2_R8G8B8A8_UNORM:
+    case VkFormat::ETC2_R8G8B8A8_SRGB:
+        return {KTX2Codec::ETC2, backend::PixelFormat::ETC2_RGBA, 4, 4, 16, ETC2_RGBA_NO_MIPMAPS};
+    case VkFormat::ASTC_4x4_UNORM:
+    case VkFormat::ASTC_4x4_SRGB:
+        return {KTX2Codec::ASTC, backend::PixelFormat::ASTC4x4, 4, 4, 16, 0};
+    case VkFormat::ASTC_5x5_UNORM:
+    case VkFormat::ASTC_5x5_SRGB:
+        return {KTX2Codec::ASTC, backend::PixelFormat::ASTC5x5, 5, 5, 16, 0};
+    case VkFormat::ASTC_6x6_UNORM:
+    case VkFormat::ASTC_6x6_SRGB:
+        return {KTX2Codec::ASTC, backend::PixelFormat::ASTC6x6, 6, 6, 16, 0};
+    case VkFormat::ASTC_8x5_UNORM:
+    case VkFormat::ASTC_8x5_SRGB:
+        return {KTX2Codec::ASTC, backend::PixelFormat::ASTC8x5, 8, 5, 16, 0};
+    case VkFormat::ASTC_8x6_UNORM:
+    case VkFormat::ASTC_8x6_SRGB:
+        return {KTX2Codec::ASTC, backend::PixelFormat::ASTC8x6, 8, 6, 16, 0};
+    case VkFormat::ASTC_8x8_UNORM:
+    case VkFormat::ASTC_8x8_SRGB:
+        return {KTX2Codec::ASTC, backend::PixelFormat::ASTC8x8, 8, 8, 16, 0};
+    case VkFormat::ASTC_10x5_UNORM:
+    case VkFormat::ASTC_10x5_SRGB:
+        return {KTX2Codec::ASTC, backend::PixelFormat::ASTC10x5, 10, 5, 16, 0};
+    default:
+        return {KTX2Codec::NONE, backend::PixelFormat::NONE, 0, 0, 0, 0};
+    }
+}
+
+bool isKTX2CodecSupported(KTX2Codec codec)
+{
+    auto conf = Configuration::getInstance();
+    switch (codec)
+    {
+    case KTX2Codec::RGBA8:
+        return true;
+    case KTX2Codec::S3TC:
+        return conf->supportsS3TC();
+    case KTX2Codec::ETC2:
+        return conf->supportsETC2();
+    case KTX2Codec::ASTC:
+        return conf->supportsASTC();
+    default:
+        return false;
+    }
+}
+}  // namespace
+
+bool Image::initWithKTX2Data(uint8_t* data, ssize_t dataLen, bool ownData)
+{
+    auto header = (const KTXv2Header*)data;
+
+    do
+    {
+        _width  = header->pixelWidth;
+        _height = header->pixelHeight;
+
+        if (_width <= 0 || _height <= 0)
+            break;
+
+        if (header->pixelDepth > 1 || header->layerCount > 1 || header->faceCount != 1)
+        {
+            CCLOG("cocos2d: KTX2 arrays, cubemaps and 3D textures are not supported");
+            break;
+        }
+
+        // levelCount 0 asks the loader to generate mipmaps, we only keep the base level
+        const uint32_t levelCount = (std::max)(header->levelCount, 1u);
+        if (levelCount > MIPMAP_MAX ||
+            dataLen < (ssize_t)(KTX_V2_HEADER_SIZE + levelCount * sizeof(KTXv2LevelIndex)))
+            break;
+
+        const auto levels = (const KTXv2LevelIndex*)(data + KTX_V2_HEADER_SIZE);
+        bool levelsValid  = true;
+        for (uint32_t i = 0; i < levelCount; ++i)
+            levelsValid = levelsValid && levels[i].byteLength && levels[i].byteOffset <= (uint64_t)dataLen &&
+                          levels[i].byteLength <= (uint64_t)dataLen - levels[i].byteOffset;
+        if (!levelsValid)
+        {
+            CCLOG("cocos2d: KTX2 level index out of range");
+            break;
+        }
+
+        // the data format descriptor tells whether the alpha was premultiplied when encoding
+        bool premultiplied = isCompressedImageHavePMA(CompressedImagePMAFlag::KTX2);
+        if (header->dfdByteLength > KTX_V2_DFD_FLAGS_OFFSET &&
+            header->dfdByteOffset + (uint64_t)header->dfdByteLength <= (uint64_t)dataLen)
+        {
+            auto dfdFlags = data[header->dfdByteOffset + KTX_V2_DFD_FLAGS_OFFSET];
+            premultiplied = premultiplied || (dfdFlags & KTX_V2_DFD_FLAG_ALPHA_PREMULTIPLIED);
+        }
+
+        if (header->vkFormat == KTXv2Header::VkFormat::UNDEFINED)
+        {
+            CCLOG("cocos2d: KTX2 Basis Universal (ETC1S/UASTC) payloads are not supported");
+            break;
+        }
+
+        if (header->supercompressionScheme != KTXv2Header::SupercompressionScheme::NONE)
+        {
+            CCLOG("cocos2d: KTX2 supercompression scheme %u is not supported", header->supercompressionScheme);
+            break;
+        }
+
+        const auto info = getKTX2FormatInfo(header->vkFormat);
+        if (info.codec == KTX2Codec::NONE)
+        {
+            CCLOG("cocos2d: KTX2 vkFormat %u is not supported", header->vkFormat);
+            break;
+        }
+
+        // the uploaders and decoders trust the dimensions, every level must hold all of its blocks
+        for (uint32_t i = 0; i < levelCount && levelsValid; ++i)
+        {
+            const uint64_t blocksX = ((std::max)(_width >> i, 1) + info.blockWidth - 1) / info.blockWidth;
+            const uint64_t blocksY = ((std::max)(_height >> i, 1) + info.blockHeight - 1) / info.blockHeight;
+            levelsValid            = levels[i].byteLength >= blocksX * blocksY * info.blockBytes;
+        }
+        if (!levelsValid)
+        {
+            CCLOG("cocos2d: KTX2 level data is shorter than its dimensions");
+            break;
+        }
+
+        if (isKTX2CodecSupported(info.codec))
+        {  // upload the blocks as they are, the levels point into the file data
+            _pixelFormat = info.format;
+            forwardPixels(data, dataLen, 0, ownData);
+            _offset = static_cast<ssize_t>(levels[0].byteOffset);
+            for (uint32_t i = 0; i < levelCount; ++i)
+            {
+                _mipmaps[i].address = _data + levels[i].byteOffset;
+                _mipmaps[i].len     = static_cast<int>(levels[i].byteLength);
+            }
+        }
+        else
+        {
+            CCLOG("cocos2d: Hardware decoder for KTX2 vkFormat %u not present. Using software decoder",
+                  header->vkFormat);
+
+            _pixelFormat = backend::PixelFormat::RGBA8;
+            _dataLen     = 0;
+            for (uint32_t i = 0; i < levelCount; ++i)
+            {
+                const int width  = (std::max)(_width >> i, 1);
+                const int height = (std::max)(_height >> i, 1);
+                _mipmaps[i].len  = width * height * 4;
+                _dataLen += _mipmaps[i].len;
+            }
+            _data = static_cast<uint8_t*>(malloc(_dataLen));
+
+            bool decoded   = true;
+            uint8_t* level = _data;
+            for (uint32_t i = 0; i < levelCount && decoded; ++i)
+            {
+                const int width     = (std::max)(_width >> i, 1);
+                const int height    = (std::max)(_height >> i, 1);
+                auto blocks         = data + levels[i].byteOffset;
+                _mipmaps[i].address = level;
+                switch (info.codec)
+                {
+                case KTX2Codec::S3TC:
+                    if (width % 4 == 0 && height % 4 == 0)
+                        s3tc_decode(blocks, level, width, height, (S3TCDecodeFlag)info.decodeFlag);
+                    else
+                    {  // s3tc_decode only handles whole blocks, decode the padded level and keep the visible pixels
+                        const int paddedWidth  = (width + 3) & ~3;
+                        const int paddedHeight = (height + 3) & ~3;
+                        std::vector<uint8_t> padded(static_cast<size_t>(paddedWidth) * paddedHeight * 4);
+                        s3tc_decode(blocks, padded.data(), paddedWidth, paddedHeight, (S3TCDecodeFlag)info.decodeFlag);
+                        for (int y = 0; y < height; ++y)
+                            memcpy(level + static_cast<size_t>(y) * width * 4,
+                                   padded.data() + static_cast<size_t>(y) * paddedWidth * 4, width * 4);
+                    }
+                    break;
+                case KTX2Codec::ETC2:
+                    decoded = etc2_decode_image(info.decodeFlag, blocks, level, width, height) == 0;
+                    break;
+                case KTX2Codec::ASTC:
+                    decoded = astc_decompress_image(blocks, static_cast<uint32_t>(levels[i].byteLength), level, width,
+                                                    height, info.blockWidth, info.blockHeight) == 0;
+                    break;
+                default:
+                    decoded = false;
+                    break;
+                }
+                level += _mipmaps[i].len;
+            }
+
+            if (!decoded)
+            {
+                CC_SAFE_FREE(_data);
+                _dataLen = 0;
+                break;
+            }
+        }
+
+        _numberOfMipmaps       = levelCount;
+        _hasPremultipliedAlpha = premultiplied;
+
+        return true;
+    } while (false);
+
+    return false;
+}
+
 void Image::forwardPixels(uint8_t* data, ssize_t dataLen, int offset, bool ownData)
 {
     if (ownData)
@@ -2486,12 +2756,7 @@ void Image::premultiplyAlpha()
 #if CC_ENABLE_PREMULTIPLIED_ALPHA
     CCASSERT(_pixelFormat == backend::PixelFormat::RGBA8, "The pixel format should be RGBA8888!");
 
-    unsigned int* fourBytes = (unsigned int*)_data;
-    for (int i = 0; i < _width * _height; i++)
-    {
-        uint8_t* p   = _data + i * 4;
-        fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
-    }
+    backend::PixelFormatUtils::premultiplyAlphaRGBA8(_data, (size_t)_width * _height * 4);
 
     _hasPremultipliedAlpha = true;
 #else
@@ -97,6 +97,8 @@ public:
         TGA,
         //! ASTC
         ASTC,
+        //! KTX2, with raw block data
+        KTX2,
         //! Raw Data
         RAW_DATA,
         //! Unknown format
@@ -111,6 +113,7 @@ public:
             DUAL_SAMPLER = 1 << 1,  // for dual sampler, such as ETC1_RGB + ETC1_Alpha
             ETC2         = 1 << 2,
             PVR          = 1 << 3,
+            KTX2         = 1 << 4,
             ALL          = 0xffff,
         };
     };
@@ -205,6 +208,7 @@ protected:
     bool initWithASTCData(uint8_t* data, ssize_t dataLen, bool ownData);
     bool initWithS3TCData(uint8_t* data, ssize_t dataLen, bool ownData);
     bool initWithATITCData(uint8_t* data, ssize_t dataLen, bool ownData);
+    bool initWithKTX2Data(uint8_t* data, ssize_t dataLen, bool ownData);
 
     // fast forward pixels to GPU if ownData
     void forwardPixels(uint8_t* data, ssize_t dataLen, int offset, bool ownData);
@@ -262,6 +266,7 @@ protected:
     bool isEtc2(const uint8_t* data, ssize_t dataLen);
     bool isS3TC(const uint8_t* data, ssize_t dataLen);
     bool isASTC(const uint8_t* data, ssize_t dataLen);
+    bool isKTX2(const uint8_t* data, ssize_t dataLen);
 };
 
 // end of platform group
@@ -26,6 +26,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "platform/win32/CCFileUtils-win32.h"
 #include "platform/CCCommon.h"
+#include "platform/CCAssetArchive.h"
 #include <Shlobj.h>
 #include <cstdlib>
 #include <regex>
@@ -149,6 +150,10 @@ FileUtils::Status FileUtilsWin32::getContents(std::string_view filename, Resizab
     // read the file from hardware
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
 
+    FileUtils::Status status;
+    if (getContentsFromArchive(fullPath, buffer, &status))
+        return status;
+
     HANDLE fileHandle = ::CreateFileW(ntcvt::from_chars(fullPath).c_str(), GENERIC_READ,
                                       FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, NULL, nullptr);
     if (fileHandle == INVALID_HANDLE_VALUE)
@@ -205,6 +210,14 @@ int64_t FileUtilsWin32::getFileSize(std::string_view filepath) const
 {
     if (filepath.empty())
         return -1;
+
+    std::string_view entryPath;
+    if (auto archive = findArchive(filepath, &entryPath))
+    {
+        auto entry = archive->find(entryPath);
+        return entry ? static_cast<int64_t>(entry->size) : -1;
+    }
+
     WIN32_FILE_ATTRIBUTE_DATA attrs = {0};
     if (GetFileAttributesExW(ntcvt::from_chars(filepath).c_str(), GetFileExInfoStandard, &attrs) &&
         !(attrs.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
@@ -50,6 +50,8 @@ class CC_DLL CallbackCommand : public RenderCommand
 {
     // only allow render to manage the callbackCommand
     friend class Renderer;
+    template <class T, int BLOCK_SIZE>
+    friend class RenderCommandPool;
     CallbackCommand();
     ~CallbackCommand(){};
 
@@ -36,6 +36,8 @@ GroupCommandManager::~GroupCommandManager() {}
 bool GroupCommandManager::init()
 {
     // 0 is the default render group
+    if (_groupMapping.empty())
+        _groupMapping.resize(1);
     _groupMapping[0] = true;
     return true;
 }
@@ -53,7 +55,9 @@ int GroupCommandManager::getGroupID()
 
     // Create new ID
     //    int newID = _groupMapping.size();
-    int newID            = Director::getInstance()->getRenderer()->createRenderQueue();
+    int newID = Director::getInstance()->getRenderer()->createRenderQueue();
+    if (newID >= (int)_groupMapping.size())
+        _groupMapping.resize(newID + 1);
     _groupMapping[newID] = true;
 
     return newID;
@@ -27,7 +27,6 @@
 #define _CC_GROUPCOMMAND_H_
 
 #include <vector>
-#include <unordered_map>
 
 #include "base/CCRef.h"
 #include "renderer/CCRenderCommand.h"
@@ -51,7 +50,8 @@ protected:
     GroupCommandManager();
     ~GroupCommandManager();
     bool init();
-    std::unordered_map<int, bool> _groupMapping;
+    // indexed by group ID, which are dense render queue indices
+    std::vector<bool> _groupMapping;
     std::vector<int> _unusedIDs;
 };
 
@@ -27,72 +27,102 @@
 #define __CC_RENDERCOMMANDPOOL_H__
 /// @cond DO_NOT_SHOW
 
-#include <list>
+#include <vector>
+#include <new>
 
 #include "platform/CCPlatformMacros.h"
 
 NS_CC_BEGIN
 
-template <class T>
+/**
+ * Slab pool for render commands which only live for one frame.
+ * Commands are allocated in blocks and handed out in order, reset() makes every command available again
+ * without touching the heap, so a frame that uses no more commands than a previous one does no allocation.
+ * pushBackCommand() returns a single command early through an intrusive free list.
+ * Commands are constructed the first time they are handed out, since constructing some of them has side effects,
+ * e.g. a GroupCommand creates a render queue.
+ */
+template <class T, int BLOCK_SIZE = 32>
 class RenderCommandPool
 {
+    // storage must be the first member, see slotOf()
+    struct Slot
+    {
+        alignas(T) unsigned char storage[sizeof(T)];
+        Slot* next;
+    };
+
 public:
     RenderCommandPool() {}
-    ~RenderCommandPool()
-    {
-        //        if( 0 != _usedPool.size())
-        //        {
-        //            CCLOG("All RenderCommand should not be used when Pool is released!");
-        //        }
-        _freePool.clear();
-        for (auto&& allocatedPoolBlock : _allocatedPoolBlocks)
-        {
-            delete[] allocatedPoolBlock;
-            allocatedPoolBlock = nullptr;
-        }
-        _allocatedPoolBlocks.clear();
-    }
+    ~RenderCommandPool() { purge(); }
 
     T* generateCommand()
     {
-        T* result = nullptr;
-        if (_freePool.empty())
+        Slot* slot = _freeList;
+        if (slot)
+            _freeList = slot->next;
+        else
         {
-            AllocateCommands();
+            if (_usedSlots == _blocks.size() * BLOCK_SIZE)
+                allocateBlock();
+            slot = _blocks[_usedSlots / BLOCK_SIZE] + _usedSlots % BLOCK_SIZE;
+            // slots are handed out in order, so the constructed ones are a prefix
+            if (_usedSlots == _constructedSlots)
+            {
+                new (slot->storage) T();
+                ++_constructedSlots;
+            }
+            ++_usedSlots;
         }
-        result = _freePool.front();
-        _freePool.pop_front();
-        //_usedPool.insert(result);
-        return result;
+        slot->next = nullptr;
+        return reinterpret_cast<T*>(slot->storage);
     }
 
     void pushBackCommand(T* ptr)
     {
-        //        if(_usedPool.find(ptr) == _usedPool.end())
-        //        {
-        //            CCLOG("push Back Wrong command!");
-        //            return;
-        //        }
-
-        _freePool.emplace_back(ptr);
-        //_usedPool.erase(ptr);
+        auto slot  = slotOf(ptr);
+        slot->next = _freeList;
+        _freeList  = slot;
+    }
+
+    /** Make all commands available again, the commands are kept for reuse. */
+    void reset()
+    {
+        _usedSlots = 0;
+        _freeList  = nullptr;
+    }
+
+    /** Destroy all commands and free their memory. */
+    void purge()
+    {
+        reset();
+        for (size_t i = 0; i < _constructedSlots; ++i)
+            reinterpret_cast<T*>(_blocks[i / BLOCK_SIZE][i % BLOCK_SIZE].storage)->~T();
+        for (auto&& block : _blocks)
+            delete[] block;
+        _blocks.clear();
+        _constructedSlots = 0;
     }
 
+    /** The number of heap allocations made by this pool since it was created. */
+    size_t getAllocationCount() const { return _allocationCount; }
+    /** The number of commands this pool can hand out before allocating. */
+    size_t getCapacity() const { return _blocks.size() * BLOCK_SIZE; }
+
 private:
-    void AllocateCommands()
+    static Slot* slotOf(T* ptr) { return reinterpret_cast<Slot*>(ptr); }
+
+    void allocateBlock()
     {
-        static const int COMMANDS_ALLOCATE_BLOCK_SIZE = 32;
-        T* commands                                   = new T[COMMANDS_ALLOCATE_BLOCK_SIZE];
-        _allocatedPoolBlocks.emplace_back(commands);
-        for (int index = 0; index < COMMANDS_ALLOCATE_BLOCK_SIZE; ++index)
-        {
-            _freePool.emplace_back(commands + index);
-        }
+        _blocks.emplace_back(new Slot[BLOCK_SIZE]);
+        ++_allocationCount;
     }
 
-    std::list<T*> _allocatedPoolBlocks;
-    std::list<T*> _freePool;
-    // std::set<T*> _usedPool;
+    std::vector<Slot*> _blocks;
+    Slot* _freeList         = nullptr;
+    size_t _usedSlots        = 0;
+    size_t _constructedSlots = 0;
+    size_t _allocationCount  = 0;
 };
 
 NS_CC_END
@@ -27,6 +27,7 @@
 #include "renderer/CCRenderer.h"
 
 #include <algorithm>
+#include <memory>
 
 #include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCCustomCommand.h"
@@ -43,6 +44,9 @@
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
+#include "base/CCFrameProfiler.h"
+#include "base/CCMemoryTracker.h"
+#include "base/CCWorkerPool.h"
 #include "2d/CCCamera.h"
 #include "2d/CCScene.h"
 #include "xxhash.h"
@@ -61,230 +65,277 @@ using TargetBufferFlags = cocos2d::backend::TargetBufferFlags;
 NS_CC_BEGIN
 
 #ifdef CC_USE_GFX
-class TriangleBufferPool
+/**
+ * Streams the vertices and indices of dynamic triangle batches.
+ * Pages of vertex/index buffers are partitioned by frame slot, and a slot is only written again
+ * FRAME_SLOTS frames later, once the frames that read it have been presented.
+ * Batches are filled straight into the shadow data of a page, then every flush uploads
+ * the range written to each page with one sub-data update and draws from it by offset.
+ */
+class TriangleRingBuffer
 {
 public:
-    struct TriangleBuffer
+    static constexpr int FRAME_SLOTS = 3;
+
+    struct Page
     {
         RefPtr<backend::BufferGFX> vb;
         RefPtr<backend::BufferGFX> ib;
-        bool used              = false;
-    };
-    struct VertexBuffer
-    {
-        std::vector<V3F_C4B_T2F> data;
-        size_t used = 0;
+        std::vector<V3F_C4B_T2F> vertices;
+        std::vector<uint16_t> indices;
+        size_t vUsed     = 0;
+        size_t iUsed     = 0;
+        size_t vUploaded = 0;
+        size_t iUploaded = 0;
     };
-    struct IndexBuffer
+    struct Range
     {
-        std::vector<uint16_t> data;
-        size_t used = 0;
+        Page* page         = nullptr;
+        size_t vertexStart = 0;
+        size_t indexStart  = 0;
     };
 
 private:
-    static constexpr size_t dataBlockSize = 16384;
-    std::multimap<size_t, TriangleBuffer> buffers;
-    std::multimap<size_t, TriangleBuffer> usedBuffers;
-    std::multimap<size_t, VertexBuffer> vDatas;
-    std::multimap<size_t, IndexBuffer> iDatas;
-    size_t tbVTotal = 0;
-    size_t tbITotal = 0;
-    size_t tbVUsed  = 0;
-    size_t tbIUsed  = 0;
-
-    size_t vbTotal = 0;
-    size_t vbUsed  = 0;
-    size_t ibTotal = 0;
-    size_t ibUsed  = 0;
-
-public:
-    TriangleBuffer nextBuffer(size_t vnum, size_t inum)
+    // indices are 16 bits and relative to the start of the page
+    static constexpr size_t maxPageVertices = 65536;
+    static constexpr size_t minPageVertices = 16384;
+    std::vector<std::unique_ptr<Page>> slots[FRAME_SLOTS];
+    int slot         = 0;
+    size_t pageIndex = 0;
+
+    static std::unique_ptr<Page> newPage(size_t vnum, size_t inum)
     {
         constexpr auto vstride = sizeof(V3F_C4B_T2F);
         constexpr auto istride = sizeof(uint16_t);
-        auto vsize       = vnum * vstride;
-        auto isize       = inum * istride;
-        size_t lastVSizeMax = 0;
-        const auto key = vnum + inum;
-        for (auto it = buffers.lower_bound(key); it != buffers.end(); ++it)
-        {
-            const auto vs = it->second.vb->getSize();
-            const auto is = it->second.ib->getSize();
-            if (vs >= vsize && is >= isize && !it->second.used)
-            {
-                it->second.used = true;
-                tbVUsed += vs;
-                tbIUsed += is;
-                auto copy = it->second;
-                usedBuffers.insert(std::pair(key, copy));
-                buffers.erase(it);
-                return copy;
-            }
-            lastVSizeMax = std::max(lastVSizeMax, it->second.vb->getSize());
-        }
-        // when buffer increases continuously, performance can be bad,
-        // so we give redundancy here
-        if (vnum > 256 && vsize < lastVSizeMax * 1.5)
-        {
-            vsize = size_t(vnum * 1.3) * vstride;
-            isize = size_t(inum * 1.3) * istride;
-        }
+        const auto vcap        = std::min(std::max(vnum, minPageVertices), maxPageVertices);
+        const auto icap        = std::max(inum, vcap * 2);
 
-        TriangleBuffer b;
         const auto device = backend::Device::getInstance();
         const auto d      = dynamic_cast<backend::DeviceGFX*>(device);
         CC_ASSERT(d);
-        b.vb = static_cast<backend::BufferGFX*>(
-            d->newBuffer(vsize, vstride, backend::BufferType::VERTEX, backend::BufferUsage::DYNAMIC));
-        b.ib = static_cast<backend::BufferGFX*>(
-            d->newBuffer(isize, istride, backend::BufferType::INDEX, backend::BufferUsage::DYNAMIC));
-        CC_ASSERT(b.vb);
-        CC_ASSERT(b.ib);
-        b.vb->autorelease();
-        b.ib->autorelease();
-        b.used = true;
-        usedBuffers.insert(std::pair(vnum + inum, b));
-        tbVTotal += vsize;
-        tbITotal += isize;
-        tbVUsed  += vsize;
-        tbIUsed  += isize;
-        return b;
+        auto page = std::make_unique<Page>();
+        page->vb  = static_cast<backend::BufferGFX*>(
+            d->newBuffer(vcap * vstride, vstride, backend::BufferType::VERTEX, backend::BufferUsage::DYNAMIC));
+        page->ib = static_cast<backend::BufferGFX*>(
+            d->newBuffer(icap * istride, istride, backend::BufferType::INDEX, backend::BufferUsage::DYNAMIC));
+        CC_ASSERT(page->vb);
+        CC_ASSERT(page->ib);
+        page->vb->autorelease();
+        page->ib->autorelease();
+        page->vertices.resize(vcap);
+        page->indices.resize(icap);
+        return page;
     }
-    V3F_C4B_T2F* nextVertexData(size_t vnum)
+
+public:
+    /** Reserves a contiguous range for one batch in the current frame slot. */
+    Range allocate(size_t vnum, size_t inum)
     {
-        for (auto it = vDatas.lower_bound(vnum); it != vDatas.end(); ++it)
+        CCASSERT(vnum <= maxPageVertices, "too many vertices in one triangle batch");
+        auto& pages = slots[slot];
+        // pages are filled in order, so the range written to a page during a frame stays contiguous
+        for (; pageIndex < pages.size(); ++pageIndex)
         {
-            const auto used   = it->second.used;
-            const auto unused = (ssize_t)it->second.data.size() - (ssize_t)used;
-            if (unused >= vnum)
-            {
-                it->second.used += vnum;
-                vbUsed          += vnum;
-                return it->second.data.data() + used;
-            }
+            auto& p = *pages[pageIndex];
+            if (p.vUsed + vnum <= p.vertices.size() && p.iUsed + inum <= p.indices.size())
+                break;
         }
-        const auto size = std::max(vnum, dataBlockSize);
-        auto it         = vDatas.insert(std::pair(size, VertexBuffer{}));
-        it->second.data.resize(size);
-        it->second.used = vnum;
-        vbTotal         += size;
-        vbUsed          += vnum;
-        return it->second.data.data();
+        if (pageIndex == pages.size())
+            pages.push_back(newPage(vnum, inum));
+
+        auto& p = *pages[pageIndex];
+        Range r{&p, p.vUsed, p.iUsed};
+        p.vUsed += vnum;
+        p.iUsed += inum;
+        return r;
     }
-    uint16_t* nextIndexData(size_t inum)
+    /** Uploads everything allocated since the previous call. */
+    void upload()
     {
-        for (auto it = iDatas.lower_bound(inum); it != iDatas.end(); ++it)
+        constexpr auto vstride = sizeof(V3F_C4B_T2F);
+        constexpr auto istride = sizeof(uint16_t);
+        auto& pages            = slots[slot];
+        for (size_t i = 0; i <= pageIndex && i < pages.size(); ++i)
         {
-            const auto used   = it->second.used;
-            const auto unused = (ssize_t)it->second.data.size() - (ssize_t)used;
-            if (unused >= inum)
-            {
-                it->second.used += inum;
-                ibUsed         += inum;
-                return it->second.data.data() + used;
-            }
+            auto& p = *pages[i];
+            if (p.vUsed > p.vUploaded)
+                p.vb->updateSubData(p.vertices.data() + p.vUploaded, p.vUploaded * vstride,
+                                    (p.vUsed - p.vUploaded) * vstride);
+            if (p.iUsed > p.iUploaded)
+                p.ib->updateSubData(p.indices.data() + p.iUploaded, p.iUploaded * istride,
+                                    (p.iUsed - p.iUploaded) * istride);
+            p.vUploaded = p.vUsed;
+            p.iUploaded = p.iUsed;
         }
-        const auto size = std::max(inum, dataBlockSize);
-        auto it         = iDatas.insert(std::pair(size, IndexBuffer{}));
-        it->second.data.resize(size);
-        it->second.used = inum;
-        ibTotal         += size;
-        ibUsed          += inum;
-        return it->second.data.data();
     }
-    void reuse()
+    /** Retires the current frame slot and moves to the oldest one. */
+    void nextFrame()
     {
+        // drop pages that were not needed in the frame just recorded
+        auto& pages = slots[slot];
+        for (auto it = pages.begin(); it != pages.end();)
         {
-            for (auto&& it : buffers)
-            {
-                tbVTotal -= it.second.vb->getSize();
-                tbITotal -= it.second.ib->getSize();
-            }
-            buffers.clear();
-            buffers = usedBuffers;
-            usedBuffers.clear();
-        }
-        for (auto& it : buffers)
-            it.second.used = false;
-        tbVUsed = 0;
-        tbIUsed = 0;
-        //
-        {
-            // remove unused
-            for (auto it = vDatas.begin(); it != vDatas.end();)
-            {
-                if (it->second.used == 0)
-                {
-                    vbTotal -= it->second.data.size();
-                    it = vDatas.erase(it);
-                }
-                else
-                    ++it;
-            }
-        }
-        for (auto& it : vDatas)
-            it.second.used = 0;
-        vbUsed = 0;
-        //
-        {
-            // remove unused
-            for (auto it = iDatas.begin(); it != iDatas.end();)
-            {
-                if (it->second.used == 0)
-                {
-                    ibTotal -= it->second.data.size();
-                    it = iDatas.erase(it);
-                }
-                else
-                    ++it;
-            }
+            if ((*it)->vUsed == 0)
+                it = pages.erase(it);
+            else
+                ++it;
         }
-        for (auto& it : iDatas)
-            it.second.used = 0;
-        ibUsed = 0;
+        slot      = (slot + 1) % FRAME_SLOTS;
+        pageIndex = 0;
+        for (auto& p : slots[slot])
+            p->vUsed = p->iUsed = p->vUploaded = p->iUploaded = 0;
     }
     void reset()
     {
-        buffers.clear();
-        usedBuffers.clear();
-        vDatas.clear();
-        iDatas.clear();
-        tbVTotal = 0;
-        tbITotal = 0;
-        tbVUsed = 0;
-        tbIUsed = 0;
-        vbTotal = 0;
-        vbUsed = 0;
-        ibTotal = 0;
-        ibUsed = 0;
+        for (auto& pages : slots)
+            pages.clear();
+        slot      = 0;
+        pageIndex = 0;
     }
     size_t getMemorySize() const
     {
-        size_t total = buffers.size() * sizeof(TriangleBuffer);
-        for (auto&& it : buffers)
+        size_t total = 0;
+        for (auto& pages : slots)
         {
-            total += it.second.ib->getSize();
-            total += it.second.vb->getSize();
+            for (auto& p : pages)
+            {
+                total += sizeof(Page) + p->vb->getSize() + p->ib->getSize();
+                total += p->vertices.capacity() * sizeof(V3F_C4B_T2F) + p->indices.capacity() * sizeof(uint16_t);
+            }
         }
-        for (auto&& it : vDatas)
-            total += sizeof(it.first) + sizeof(it.second) + it.second.data.capacity() * sizeof(V3F_C4B_T2F);
-        for (auto&& it : iDatas)
-            total += sizeof(it.first) + sizeof(it.second) + it.second.data.capacity() * sizeof(uint16_t);
         return total;
     }
 };
-static TriangleBufferPool GlobalTriangleBufferPool;
+static TriangleRingBuffer GlobalTriangleRingBuffer;
 #endif  // CC_USE_GFX
 
 // helper
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+// maps a float to an unsigned key with the same ordering, -0 and +0 share one key
+static inline uint32_t floatToSortKey(float value)
 {
-    return a->getGlobalOrder() < b->getGlobalOrder();
+    if (value == 0.0f)
+        value = 0.0f;
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
 }
 
-static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
+// Stable LSD radix sort of commands by 32bit key, 8 bits per pass.
+// Passes where every key has the same digit are skipped, and the sort returns early
+// when the commands are already in order.
+template <typename KeyFunc>
+static void radixSortCommands(std::vector<RenderCommand*>& commands, RenderQueue::SortBuffer& scratch, KeyFunc keyOf)
 {
-    return a->getDepth() > b->getDepth();
+    const size_t count = commands.size();
+    if (count < 2)
+        return;
+
+    if (scratch.size() < count * 2)
+        scratch.resize(count * 2);
+    auto src = scratch.data();
+    auto dst = src + count;
+
+    uint32_t histograms[4][256] = {};
+    bool sorted      = true;
+    uint32_t lastKey = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint32_t key = keyOf(commands[i]);
+        src[i]             = {key, commands[i]};
+        sorted             = sorted && key >= lastKey;
+        lastKey            = key;
+        ++histograms[0][key & 0xff];
+        ++histograms[1][(key >> 8) & 0xff];
+        ++histograms[2][(key >> 16) & 0xff];
+        ++histograms[3][key >> 24];
+    }
+    if (sorted)
+        return;
+
+    for (int pass = 0; pass < 4; ++pass)
+    {
+        auto& histogram   = histograms[pass];
+        const int shift   = pass * 8;
+        const auto digit0 = (src[0].key >> shift) & 0xff;
+        if (histogram[digit0] == count)
+            continue;
+
+        uint32_t offset = 0;
+        for (auto& bucket : histogram)
+        {
+            const auto n = bucket;
+            bucket       = offset;
+            offset       += n;
+        }
+        for (size_t i = 0; i < count; ++i)
+            dst[histogram[(src[i].key >> shift) & 0xff]++] = src[i];
+        std::swap(src, dst);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        commands[i] = src[i].command;
+}
+
+// world space xy bounds of a TrianglesCommand, false when it doesn't lie in the z = 0 plane
+static bool getTrianglesBounds(const TrianglesCommand* cmd, float& minX, float& minY, float& maxX, float& maxY)
+{
+    const auto count = cmd->getVertexCount();
+    const auto verts = cmd->getVertices();
+    if (count == 0)
+        return false;
+
+    Vec3 lo = verts[0].vertices;
+    Vec3 hi = lo;
+    for (size_t i = 1; i < count; ++i)
+    {
+        const auto& v = verts[i].vertices;
+        lo.set(std::min(lo.x, v.x), std::min(lo.y, v.y), std::min(lo.z, v.z));
+        hi.set(std::max(hi.x, v.x), std::max(hi.y, v.y), std::max(hi.z, v.z));
+    }
+
+    if (!cmd->isSkipModelView())
+    {
+        Vec3 corners[8] = {{lo.x, lo.y, lo.z}, {hi.x, lo.y, lo.z}, {lo.x, hi.y, lo.z}, {hi.x, hi.y, lo.z},
+                           {lo.x, lo.y, hi.z}, {hi.x, lo.y, hi.z}, {lo.x, hi.y, hi.z}, {hi.x, hi.y, hi.z}};
+        cmd->getModelView().transformPoints(corners, 8);
+        lo = hi = corners[0];
+        for (auto& c : corners)
+        {
+            lo.set(std::min(lo.x, c.x), std::min(lo.y, c.y), std::min(lo.z, c.z));
+            hi.set(std::max(hi.x, c.x), std::max(hi.y, c.y), std::max(hi.z, c.z));
+        }
+    }
+
+    if (lo.z != 0 || hi.z != 0)
+        return false;
+
+    minX = lo.x;
+    minY = lo.y;
+    maxX = hi.x;
+    maxY = hi.y;
+    return true;
+}
+
+static bool isBatchedWith(const RenderCommand* prev, const TrianglesCommand* cmd)
+{
+    if (!prev || prev->getType() != RenderCommand::Type::TRIANGLES_COMMAND)
+        return false;
+    return !prev->isSkipBatching() && !cmd->isSkipBatching() &&
+           static_cast<const TrianglesCommand*>(prev)->getMaterialID() == cmd->getMaterialID();
+}
+
+static size_t countTriangleBatches(const std::vector<RenderCommand*>& commands)
+{
+    size_t batches            = 0;
+    const RenderCommand* prev = nullptr;
+    for (auto command : commands)
+    {
+        if (command->getType() == RenderCommand::Type::TRIANGLES_COMMAND &&
+            !isBatchedWith(prev, static_cast<TrianglesCommand*>(command)))
+            ++batches;
+        prev = command;
+    }
+    return batches;
 }
 
 // queue
@@ -335,14 +386,21 @@ ssize_t RenderQueue::size() const
 }
 
 void RenderQueue::sort()
+{
+    SortBuffer scratch;
+    sort(scratch);
+}
+
+void RenderQueue::sort(SortBuffer& scratch)
 {
     // Don't sort _queue0, it already comes sorted
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]),
-                     std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]),
-                     compareRenderCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]),
-                     compareRenderCommand);
+    // transparent 3D objects are drawn back to front, so larger depth comes first
+    radixSortCommands(_commands[QUEUE_GROUP::TRANSPARENT_3D], scratch,
+                      [](RenderCommand* command) { return ~floatToSortKey(command->getDepth()); });
+    radixSortCommands(_commands[QUEUE_GROUP::GLOBALZ_NEG], scratch,
+                      [](RenderCommand* command) { return floatToSortKey(command->getGlobalOrder()); });
+    radixSortCommands(_commands[QUEUE_GROUP::GLOBALZ_POS], scratch,
+                      [](RenderCommand* command) { return floatToSortKey(command->getGlobalOrder()); });
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -405,21 +463,21 @@ Renderer::Renderer()
 
 Renderer::~Renderer()
 {
-    _renderGroups.clear();
+    MemoryTracker::getInstance()->setSampler(MemoryTracker::TAG_VERTEX_DATA, nullptr);
 
-    for (auto&& clearCommand : _callbackCommandsPool)
-        delete clearCommand;
-    _callbackCommandsPool.clear();
+    _renderGroups.clear();
 
-    for (auto&& clearCommand : _groupCommandPool)
-        delete clearCommand;
-    _groupCommandPool.clear();
+    _callbackCommandsPool.purge();
+    // group commands release their queue IDs, so they must go before the manager
+    _groupCommandPool.purge();
 
     _groupCommandManager->release();
 
+    CC_SAFE_DELETE(_batchWorkerPool);
+
 #ifdef CC_USE_GFX
     delete[] _triBatchesToDraw;
-    GlobalTriangleBufferPool.reset();
+    GlobalTriangleRingBuffer.reset();
 #else
     free(_triBatchesToDraw);
 #endif
@@ -449,6 +507,9 @@ void Renderer::init()
 
     _depthStencilState = device->newDepthStencilState();
     _commandBuffer->setDepthStencilState(_depthStencilState);
+
+    MemoryTracker::getInstance()->setSampler(MemoryTracker::TAG_VERTEX_DATA,
+                                             [this]() { return (int64_t)getTriangleBufferMemorySize(); });
 }
 
 backend::RenderTarget* Renderer::getOffscreenRenderTarget()
@@ -459,6 +520,23 @@ backend::RenderTarget* Renderer::getOffscreenRenderTarget()
                                                                            TargetBufferFlags::DEPTH_AND_STENCIL));
 }
 
+void Renderer::setBatchBuildThreads(int threads)
+{
+    CCASSERT(!_isRendering, "Cannot change batch build threads while rendering");
+    threads = std::max(threads, 1);
+    if (threads == getBatchBuildThreads())
+        return;
+
+    CC_SAFE_DELETE(_batchWorkerPool);
+    if (threads > 1)
+        _batchWorkerPool = new WorkerPool(threads - 1);
+}
+
+int Renderer::getBatchBuildThreads() const
+{
+    return _batchWorkerPool ? _batchWorkerPool->getConcurrency() : 1;
+}
+
 void Renderer::addCallbackCommand(std::function<void()> func, float globalZOrder)
 {
     auto cmd = nextCallbackCommand();
@@ -484,13 +562,7 @@ void Renderer::addCommand(RenderCommand* command, int renderQueueID)
 
 GroupCommand* Renderer::getNextGroupCommand()
 {
-    if (_groupCommandPool.empty())
-    {
-        return new GroupCommand();
-    }
-
-    auto* command = _groupCommandPool.back();
-    _groupCommandPool.pop_back();
+    auto* command = _groupCommandPool.generateCommand();
     command->reset();
 
     return command;
@@ -577,7 +649,6 @@ void Renderer::processRenderCommand(RenderCommand* command)
         break;
     case RenderCommand::Type::GROUP_COMMAND:
         processGroupCommand(static_cast<GroupCommand*>(command));
-        _groupCommandPool.emplace_back(static_cast<GroupCommand*>(command));
         break;
     case RenderCommand::Type::CUSTOM_COMMAND:
         flush();
@@ -586,7 +657,6 @@ void Renderer::processRenderCommand(RenderCommand* command)
     case RenderCommand::Type::CALLBACK_COMMAND:
         flush();
         static_cast<CallbackCommand*>(command)->execute();
-        _callbackCommandsPool.emplace_back(static_cast<CallbackCommand*>(command));
         break;
     default:
         assert(false);
@@ -596,6 +666,13 @@ void Renderer::processRenderCommand(RenderCommand* command)
 
 void Renderer::visitRenderQueue(RenderQueue& queue)
 {
+    if (_batchReorderEnabled)
+    {
+        reorderForBatching(queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_NEG));
+        reorderForBatching(queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_ZERO));
+        reorderForBatching(queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_POS));
+    }
+
     //
     // Process Global-Z < 0 Objects
     //
@@ -628,6 +705,62 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     doVisitRenderQueue(queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_POS));
 }
 
+void Renderer::reorderForBatching(std::vector<RenderCommand*>& commands)
+{
+    const auto batches = countTriangleBatches(commands);
+    _batchesBeforeReorder += batches;
+    if (batches < 2)
+    {
+        _batchesAfterReorder += batches;
+        return;
+    }
+
+    _reorderedCommands.clear();
+    _reorderedBounds.clear();
+    // commands placed before this index can't be passed
+    size_t barrier = 0;
+    for (auto command : commands)
+    {
+        if (command->getType() != RenderCommand::Type::TRIANGLES_COMMAND)
+        {
+            _reorderedCommands.emplace_back(command);
+            _reorderedBounds.push_back({0, 0, 0, 0, false});
+            barrier = _reorderedCommands.size();
+            continue;
+        }
+
+        auto cmd = static_cast<TrianglesCommand*>(command);
+        ReorderBounds bounds;
+        bounds.known = getTrianglesBounds(cmd, bounds.minX, bounds.minY, bounds.maxX, bounds.maxY);
+
+        size_t insertAt = _reorderedCommands.size();
+        if (bounds.known && !cmd->isSkipBatching())
+        {
+            const size_t placed   = _reorderedCommands.size();
+            const size_t lookback = BATCH_REORDER_LOOKBACK;
+            const size_t lowest   = std::max(barrier, placed > lookback ? placed - lookback : 0);
+            for (size_t k = placed; k > lowest; --k)
+            {
+                if (isBatchedWith(_reorderedCommands[k - 1], cmd))
+                {
+                    insertAt = k;
+                    break;
+                }
+                // touching edges are fine, the rasterizer never covers a pixel from both sides
+                const auto& other = _reorderedBounds[k - 1];
+                if (!other.known || (bounds.minX < other.maxX && other.minX < bounds.maxX && bounds.minY < other.maxY &&
+                                     other.minY < bounds.maxY))
+                    break;
+            }
+        }
+        _reorderedCommands.insert(_reorderedCommands.begin() + insertAt, command);
+        _reorderedBounds.insert(_reorderedBounds.begin() + insertAt, bounds);
+    }
+    commands.swap(_reorderedCommands);
+
+    _batchesAfterReorder += countTriangleBatches(commands);
+}
+
 void Renderer::doVisitRenderQueue(const std::vector<RenderCommand*>& renderCommands)
 {
     for (const auto& command : renderCommands)
@@ -639,6 +772,8 @@ void Renderer::doVisitRenderQueue(const std::vector<RenderCommand*>& renderComma
 
 void Renderer::render()
 {
+    CC_PROFILE_ZONE("Renderer::render");
+
     // TODO: setup camera or MVP
     _isRendering = true;
     //    if (_glViewAssigned)
@@ -647,7 +782,7 @@ void Renderer::render()
         // 1. Sort render commands based on ID
         for (auto&& renderqueue : _renderGroups)
         {
-            renderqueue.sort();
+            renderqueue.sort(_renderQueueSortBuffer);
         }
         visitRenderQueue(_renderGroups[0]);
     }
@@ -675,7 +810,18 @@ void Renderer::endFrame()
 #endif
     _queuedTotalIndexCount  = 0;
     _queuedTotalVertexCount = 0;
-    GlobalTriangleBufferPool.reuse();
+#ifdef CC_USE_GFX
+    GlobalTriangleRingBuffer.nextFrame();
+#endif
+}
+
+size_t Renderer::getTriangleBufferMemorySize() const
+{
+#ifdef CC_USE_GFX
+    return GlobalTriangleRingBuffer.getMemorySize();
+#else
+    return (_vertexBuffer ? _vertexBuffer->getSize() : 0) + (_indexBuffer ? _indexBuffer->getSize() : 0);
+#endif
 }
 
 void Renderer::clean()
@@ -693,6 +839,10 @@ void Renderer::clean()
 
     // Clear batch commands
     _queuedTriangleCommands.clear();
+
+    // All pooled commands queued so far have been processed or dropped with their queues
+    _callbackCommandsPool.reset();
+    _groupCommandPool.reset();
 }
 
 void Renderer::setDepthTest(bool value)
@@ -845,14 +995,11 @@ void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int
     size_t vertexCount = cmd->getVertexCount();
     memcpy(&_verts[_filledVertex], cmd->getVertices(), sizeof(V3F_C4B_T2F) * vertexCount);
 
-    if (!c->isSkipModelView())
+    if (!cmd->isSkipModelView())
     {
         // fill vertex, and convert them to world coordinates
         const Mat4& modelView = cmd->getModelView();
-        for (size_t i = 0; i < vertexCount; ++i)
-        {
-            modelView.transformPoint(&(_verts[i + _filledVertex].vertices));
-        }
+        modelView.transformPoints(&_verts[_filledVertex].vertices, vertexCount, sizeof(V3F_C4B_T2F));
     }
 
     // fill index
@@ -868,6 +1015,23 @@ void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int
 #endif
 }
 
+void Renderer::fillTriangles(const TriFillJob* jobs, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto& job   = jobs[i];
+        const auto cmd    = job.cmd;
+        const auto vcount = cmd->getVertexCount();
+        const auto icount = cmd->getIndexCount();
+        memcpy(job.vertices, cmd->getVertices(), sizeof(V3F_C4B_T2F) * vcount);
+        if (!cmd->isSkipModelView())
+            cmd->getModelView().transformPoints(&job.vertices->vertices, vcount, sizeof(V3F_C4B_T2F));
+        const auto indices = cmd->getIndices();
+        for (size_t j = 0; j < icount; ++j)
+            job.indices[j] = job.vertexBase + indices[j];
+    }
+}
+
 #ifdef CC_USE_GFX
 void Renderer::drawBatchedTriangles()
 {
@@ -935,55 +1099,67 @@ void Renderer::drawBatchedTriangles()
     }
     batchesTotal++;
 
-    /************** 2: Draw *************/
-    beginRenderPass();
-
+    /************** 2: Fill vertices/indices *************/
+    // each command gets a disjoint range of the pooled data, so filling can be split across workers
+    _triFillJobs.clear();
+    size_t queuedVertices = 0;
     for (int i = 0; i < batchesTotal; ++i)
     {
-        const auto& tb = _triBatchesToDraw[i];
-        size_t vTotal  = 0;
-        size_t iTotal  = 0;
+        auto& tb      = _triBatchesToDraw[i];
+        size_t vTotal = 0;
+        size_t iTotal = 0;
         for (auto& c : tb.cmds)
         {
             vTotal += c->getVertexCount();
             iTotal += c->getIndexCount();
         }
-        const auto vbuffer = GlobalTriangleBufferPool.nextVertexData(vTotal);
-        const auto ibuffer = GlobalTriangleBufferPool.nextIndexData(iTotal);
-        size_t vCurrent    = 0;
-        size_t iCurrent    = 0;
+        CC_ASSERT(iTotal == tb.indicesToDraw);
+        const auto range  = GlobalTriangleRingBuffer.allocate(vTotal, iTotal);
+        tb.vertexBuffer   = range.page->vb;
+        tb.indexBuffer    = range.page->ib;
+        tb.vertices       = range.page->vertices.data() + range.vertexStart;
+        tb.indices        = range.page->indices.data() + range.indexStart;
+        tb.verticesToDraw = (unsigned int)vTotal;
+        tb.offset         = (unsigned int)(range.indexStart * sizeof(uint16_t));
+        size_t vCurrent   = 0;
+        size_t iCurrent   = 0;
         for (auto& c : tb.cmds)
         {
-            const auto vcount = c->getVertexCount();
-            const auto icount = c->getIndexCount();
-            memcpy(vbuffer + vCurrent, c->getVertices(), sizeof(V3F_C4B_T2F) * vcount);
-            if (!c->isSkipModelView())
-            {
-                const auto& modelView = c->getModelView();
-                for (size_t j = 0; j < vcount; ++j)
-                    modelView.transformPoint(&((vbuffer + vCurrent + j)->vertices));
-            }
-            const auto indices = c->getIndices();
-            for (size_t j = 0; j < icount; ++j)
-                ibuffer[iCurrent + j] = vCurrent + indices[j];
-            vCurrent += vcount;
-            iCurrent += icount;
+            // indices address the whole page of the ring buffer
+            _triFillJobs.push_back(
+                {c, tb.vertices + vCurrent, tb.indices + iCurrent, (unsigned int)(range.vertexStart + vCurrent)});
+            vCurrent += c->getVertexCount();
+            iCurrent += c->getIndexCount();
         }
-        auto b = GlobalTriangleBufferPool.nextBuffer(vTotal, iTotal);
-        b.vb->updateData(vbuffer, sizeof(V3F_C4B_T2F) * vTotal);
-        b.ib->updateData(ibuffer, sizeof(uint16_t) * iTotal);
-        _filledVertex += vTotal;
-        _filledIndex  += iTotal;
-        CC_ASSERT(iTotal == tb.indicesToDraw);
+        queuedVertices += vTotal;
+    }
+
+    const auto fillJobs = _triFillJobs.data();
+    if (_batchWorkerPool && queuedVertices >= BATCH_BUILD_PARALLEL_MIN_VERTICES)
+        _batchWorkerPool->parallelFor(
+            _triFillJobs.size(), BATCH_BUILD_PARALLEL_GRAIN,
+            [fillJobs](size_t begin, size_t end) { fillTriangles(fillJobs + begin, end - begin); });
+    else
+        fillTriangles(fillJobs, _triFillJobs.size());
+
+    /************** 3: Draw *************/
+    GlobalTriangleRingBuffer.upload();
+    beginRenderPass();
+
+    for (int i = 0; i < batchesTotal; ++i)
+    {
+        const auto& tb = _triBatchesToDraw[i];
+        _filledVertex  += tb.verticesToDraw;
+        _filledIndex   += tb.indicesToDraw;
 
         // beginRenderPass(tb.cmd);
-        _commandBuffer->setVertexBuffer(b.vb);
-        _commandBuffer->setIndexBuffer(b.ib);
+        _commandBuffer->setVertexBuffer(tb.vertexBuffer);
+        _commandBuffer->setIndexBuffer(tb.indexBuffer);
         auto& pipelineDescriptor = tb.cmd->getPipelineDescriptor();
         _commandBuffer->updatePipelineState(_currentRT, tb.cmd->getPipelineDescriptor());
         _commandBuffer->setProgramState(pipelineDescriptor.programState);
         _commandBuffer->drawElements(backend::PrimitiveType::TRIANGLE, backend::IndexFormat::U_SHORT, tb.indicesToDraw,
-                                     0);
+                                     tb.offset);
 
         //_commandBuffer->endRenderPass();
 
@@ -992,7 +1168,7 @@ void Renderer::drawBatchedTriangles()
     }
 
     endRenderPass();
-    /************** 3: Cleanup *************/
+    /************** 4: Cleanup *************/
     _queuedTriangleCommands.clear();
 }
 
@@ -1270,15 +1446,8 @@ void Renderer::clear(ClearFlag flags, const Color4F& color, float depth, unsigne
 
 CallbackCommand* Renderer::nextCallbackCommand()
 {
-    CallbackCommand* cmd = nullptr;
-    if (!_callbackCommandsPool.empty())
-    {
-        cmd = _callbackCommandsPool.back();
-        cmd->reset();
-        _callbackCommandsPool.pop_back();
-    }
-    else
-        cmd = new CallbackCommand();
+    auto cmd = _callbackCommandsPool.generateCommand();
+    cmd->reset();
     return cmd;
 }
 
@@ -32,6 +32,9 @@
 
 #include "platform/CCPlatformMacros.h"
 #include "renderer/CCRenderCommand.h"
+#include "renderer/CCRenderCommandPool.h"
+#include "renderer/CCCallbackCommand.h"
+#include "renderer/CCGroupCommand.h"
 #include "renderer/backend/Types.h"
 #include "renderer/backend/ProgramManager.h"
 
@@ -63,6 +66,7 @@ class GroupCommand;
 class CallbackCommand;
 struct PipelineDescriptor;
 class Texture2D;
+class WorkerPool;
 
 /** Class that knows how to sort `RenderCommand` objects.
  Since the commands that have `z == 0` are "pushed back" in
@@ -90,6 +94,14 @@ public:
         QUEUE_COUNT = 5,
     };
 
+    /**Key/command pair used while sorting, the owner keeps the buffer so it is reused every frame.*/
+    struct SortEntry
+    {
+        uint32_t key;
+        RenderCommand* command;
+    };
+    using SortBuffer = std::vector<SortEntry>;
+
 public:
     /**Constructor.*/
     RenderQueue();
@@ -99,6 +111,8 @@ public:
     ssize_t size() const;
     /**Sort the render commands.*/
     void sort();
+    /**Sort the render commands, using scratch as temporary memory.*/
+    void sort(SortBuffer& scratch);
     /**Treat sorted commands as an array, access them one by one.*/
     RenderCommand* operator[](ssize_t index) const;
     /**Clear all rendered commands.*/
@@ -139,6 +153,12 @@ public:
     static const int BATCH_TRIAGCOMMAND_RESERVED_SIZE = 64;
     /**Reserved for material id, which means that the command could not be batched.*/
     static const int MATERIAL_ID_DO_NOT_BATCH = 0;
+    /**Batches with fewer queued vertices than this are always built on the render thread.*/
+    static const int BATCH_BUILD_PARALLEL_MIN_VERTICES = 4096;
+    /**The number of TrianglesCommand a batch building worker takes at a time.*/
+    static const int BATCH_BUILD_PARALLEL_GRAIN = 64;
+    /**How many queued commands a TrianglesCommand may be moved back over when reordering for batching.*/
+    static const int BATCH_REORDER_LOOKBACK = 32;
     /**Constructor.*/
     Renderer();
     /**Destructor.*/
@@ -181,8 +201,38 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) TrianglesCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* returns the number of TrianglesCommand batches before reordering in the last frame */
+    ssize_t getBatchesBeforeReorder() const { return _batchesBeforeReorder; }
+    /* returns the number of TrianglesCommand batches after reordering in the last frame */
+    ssize_t getBatchesAfterReorder() const { return _batchesAfterReorder; }
+    /* returns the number of heap allocations made by the internal command pools, constant once warmed up */
+    size_t getCommandPoolAllocations() const
+    {
+        return _callbackCommandsPool.getAllocationCount() + _groupCommandPool.getAllocationCount();
+    }
+    /* returns the bytes held by the ring buffer streaming batched triangles, GPU buffers and shadow data */
+    size_t getTriangleBufferMemorySize() const;
     /* clear draw stats */
-    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    void clearDrawStats() { _drawnBatches = _drawnVertices = _batchesBeforeReorder = _batchesAfterReorder = 0; }
+
+    /**
+     * Enable/disable reordering of 2D render queues to reduce draw calls.
+     * A TrianglesCommand is moved back next to an earlier command with the same material ID
+     * if its bounds don't overlap any command it passes, so the visual result is unchanged.
+     * Commands of other types are never passed. Disabled by default.
+     */
+    void setBatchReorderEnabled(bool enabled) { _batchReorderEnabled = enabled; }
+    bool isBatchReorderEnabled() const { return _batchReorderEnabled; }
+
+    /**
+     * Set the number of threads used to build triangle batches, including the render thread.
+     * Vertex copy, model-view transform and index rebasing of queued `TrianglesCommand` are split across them,
+     * buffer upload and draw submission stay on the render thread.
+     * @param threads 1 (default) builds batches on the render thread only.
+     */
+    void setBatchBuildThreads(int threads);
+    /** Get the number of threads used to build triangle batches. */
+    int getBatchBuildThreads() const;
 
     /**
      Set render targets. If not set, will use default render targets. It will effect all commands.
@@ -488,9 +538,14 @@ protected:
     void processGroupCommand(GroupCommand*);
     void visitRenderQueue(RenderQueue& queue);
     void doVisitRenderQueue(const std::vector<RenderCommand*>&);
+    void reorderForBatching(std::vector<RenderCommand*>& commands);
 
     void fillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int vertexBufferOffset);
 
+    struct TriFillJob;
+    /// Copy, transform and rebase the given commands into their batch ranges, safe to call from any thread.
+    static void fillTriangles(const TriFillJob* jobs, size_t count);
+
     void pushStateBlock();
 
     void popStateBlock();
@@ -504,13 +559,14 @@ protected:
     std::stack<int> _commandGroupStack;
 
     std::vector<RenderQueue> _renderGroups;
+    RenderQueue::SortBuffer _renderQueueSortBuffer;
 
     std::vector<TrianglesCommand*> _queuedTriangleCommands;
 
-    // the pool for callback commands
-    std::vector<CallbackCommand*> _callbackCommandsPool;
+    // the pools for callback and group commands, recycled at the end of every render()
+    RenderCommandPool<CallbackCommand> _callbackCommandsPool;
 
-    std::vector<GroupCommand*> _groupCommandPool;
+    RenderCommandPool<GroupCommand> _groupCommandPool;
 
     // for TrianglesCommand
     V3F_C4B_T2F _verts[VBO_SIZE];
@@ -531,6 +587,11 @@ protected:
         TrianglesCommand* cmd      = nullptr;  // needed for the Material
 #ifdef CC_USE_GFX
         std::vector<TrianglesCommand*> cmds;
+        backend::Buffer* vertexBuffer = nullptr;  // page of the triangle ring buffer
+        backend::Buffer* indexBuffer  = nullptr;
+        V3F_C4B_T2F* vertices         = nullptr;
+        unsigned short* indices       = nullptr;
+        unsigned int verticesToDraw   = 0;
 #endif
         unsigned int indicesToDraw = 0;
         unsigned int offset        = 0;
@@ -540,6 +601,27 @@ protected:
     // the TriBatches
     TriBatchToDraw* _triBatchesToDraw = nullptr;
 
+    // Range of a batch filled from one TrianglesCommand, disjoint from all others
+    struct TriFillJob
+    {
+        const TrianglesCommand* cmd = nullptr;
+        V3F_C4B_T2F* vertices       = nullptr;
+        unsigned short* indices     = nullptr;
+        unsigned int vertexBase     = 0;
+    };
+    std::vector<TriFillJob> _triFillJobs;
+    WorkerPool* _batchWorkerPool = nullptr;
+
+    // for reorderForBatching
+    struct ReorderBounds
+    {
+        float minX, minY, maxX, maxY;
+        bool known;
+    };
+    std::vector<RenderCommand*> _reorderedCommands;
+    std::vector<ReorderBounds> _reorderedBounds;
+    bool _batchReorderEnabled = false;
+
     unsigned int _queuedTotalVertexCount = 0;
     unsigned int _queuedTotalIndexCount  = 0;
     unsigned int _queuedVertexCount      = 0;
@@ -548,8 +630,10 @@ protected:
     unsigned int _filledVertex           = 0;
 
     // stats
-    size_t _drawnBatches  = 0;
-    size_t _drawnVertices = 0;
+    size_t _drawnBatches         = 0;
+    size_t _drawnVertices        = 0;
+    size_t _batchesBeforeReorder = 0;
+    size_t _batchesAfterReorder  = 0;
     // the flag for checking whether renderer is rendering
     bool _isRendering      = false;
     bool _isDepthTestFor2D = false;
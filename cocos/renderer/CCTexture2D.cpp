@@ -87,6 +87,7 @@ Texture2D::~Texture2D()
 
     CC_SAFE_DELETE(_ninePatchInfo);
 
+    setMemorySize(0);
     CC_SAFE_RELEASE(_texture);
     CC_SAFE_RELEASE(_programState);
 }
@@ -350,6 +351,7 @@ bool Texture2D::updateWithMipmaps(MipmapInfo* mipmaps,
     int width                           = pixelsWide;
     int height                          = pixelsHigh;
     backend::PixelFormat oriPixelFormat = pixelFormat;
+    int64_t memorySize                  = 0;
     for (int i = 0; i < mipmapsNum; ++i)
     {
         unsigned char* data    = mipmaps[i].address;
@@ -377,10 +379,12 @@ bool Texture2D::updateWithMipmaps(MipmapInfo* mipmaps,
         if (compressed)
         {
             _texture->updateCompressedData(data, width, height, dataLen, i, index);
+            memorySize += dataLen;
         }
         else
         {
             _texture->updateData(outData, width, height, i, index);
+            memorySize += (int64_t)width * height * backend::PixelFormatUtils::getFormatDescriptor(pixelFormat).bpp / 8;
         }
 
         if (outData && outData != data && outDataLen > 0)
@@ -422,6 +426,9 @@ bool Texture2D::updateWithMipmaps(MipmapInfo* mipmaps,
         _samplerFlags |= TextureSamplerFlag::DUAL_SAMPLER;
     }
 
+    // the alpha texture of a dual sampler texture is updated after the color one
+    setMemorySize(index == 0 ? memorySize : _memorySize + memorySize);
+
     return true;
 }
 
@@ -574,9 +581,28 @@ bool Texture2D::updateTextureDescriptor(const backend::TextureDescriptor& descri
     if (_pixelFormat == PixelFormat::NONE)
         _pixelFormat = descriptor.textureFormat;
 
+    setMemorySize((int64_t)_pixelsWide * _pixelsHigh *
+                  backend::PixelFormatUtils::getFormatDescriptor(descriptor.textureFormat).bpp / 8);
+
     return true;
 }
 
+void Texture2D::setMemoryTag(int tag)
+{
+    auto tracker = MemoryTracker::getInstance();
+    tracker->release(_memoryTag, _memorySize);
+    tracker->allocate(tag, _memorySize);
+    _memoryTag = tag;
+}
+
+void Texture2D::setMemorySize(int64_t size)
+{
+    auto tracker = MemoryTracker::getInstance();
+    tracker->release(_memoryTag, _memorySize);
+    tracker->allocate(_memoryTag, size);
+    _memorySize = size;
+}
+
 void Texture2D::setRenderTarget(bool renderTarget)
 {
     if (renderTarget)
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include <unordered_map>
 
 #include "base/CCRef.h"
+#include "base/CCMemoryTracker.h"
 #include "math/CCMath.h"
 #include "base/ccTypes.h"
 #include "renderer/CCCustomCommand.h"
@@ -372,6 +373,13 @@ public:
 
     std::string getPath() const { return _filePath; }
 
+    /** Accounts the memory of the texture under another MemoryTracker tag, such as MemoryTracker::TAG_FONT_ATLAS. */
+    void setMemoryTag(int tag);
+    int getMemoryTag() const { return _memoryTag; }
+
+    /** Gets the estimated size of the texture in the video memory, in bytes. */
+    int64_t getMemorySize() const { return _memorySize; }
+
 private:
     /**
      * A struct for storing 9-patch image capInsets.
@@ -418,6 +426,8 @@ private:
 
     void initProgram();
 
+    void setMemorySize(int64_t size);
+
 protected:
     /** pixel format of the texture */
     backend::PixelFormat _pixelFormat;
@@ -451,6 +461,9 @@ protected:
     bool _valid;
     std::string _filePath;
 
+    int _memoryTag      = MemoryTracker::TAG_TEXTURE;
+    int64_t _memorySize = 0;
+
     backend::ProgramState* _programState = nullptr;
     backend::UniformLocation _mvpMatrixLocation;
     backend::UniformLocation _textureLocation;
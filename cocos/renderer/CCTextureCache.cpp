@@ -34,12 +34,15 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
+#include <chrono>
 
 #include "renderer/CCTexture2D.h"
 #include "base/ccMacros.h"
 #include "base/ccUTF8.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCFrameProfiler.h"
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
 #include "base/CCNinePatchImageParser.h"
@@ -63,7 +66,13 @@ std::string TextureCache::getETC1AlphaFileSuffix()
     return s_etc1AlphaFileSuffix;
 }
 
-TextureCache::TextureCache() : _loadingThread(nullptr), _needQuit(false), _asyncRefCount(0) {}
+TextureCache::TextureCache()
+    : _loadingThreadCount(std::clamp(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1, 4))
+    , _needQuit(false)
+    , _asyncRefCount(0)
+    , _asyncUploadLimit(0)
+    , _asyncUploadTimeBudget(0.0f)
+{}
 
 TextureCache::~TextureCache()
 {
@@ -72,7 +81,8 @@ TextureCache::~TextureCache()
     for (auto&& texture : _textures)
         texture.second->release();
 
-    CC_SAFE_DELETE(_loadingThread);
+    if (!_loadingThreads.empty())
+        waitForQuit();
 }
 
 std::string TextureCache::getDescription() const
@@ -88,6 +98,7 @@ public:
         , callback(f)
         , callbackKey(key)
         , pixelFormat(Texture2D::getDefaultAlphaPixelFormat())
+        , priority(0)
         , loadSuccess(false)
     {}
 
@@ -97,14 +108,15 @@ public:
     Image image;
     Image imageAlpha;
     backend::PixelFormat pixelFormat;
+    int priority;
     bool loadSuccess;
 };
 
 /**
  The addImageAsync logic follow the steps:
  - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to
- _responseQueue (Load thread)
+ - get AsyncStruct of the highest priority from _requestQueue, load res and fill image data to AsyncStruct.image, then
+ add AsyncStruct to _responseQueue (Load threads)
  - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL
  thread)
 
@@ -114,7 +126,7 @@ public:
 
  the object's life time:
  - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
+ - image data: new in Load threads, delete in GL thread(by Image instance)
 
  Note:
  - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
@@ -126,11 +138,11 @@ public:
  - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
 
  Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
+ - Convert image to texture faster than load image from disk, and setAsyncUploadBudget spreads the
+ conversions across frames when many images are decoded at once.
 
  Call unbindImageAsync(path) to prevent the call to the callback when the
- texture is loaded.
+ texture is loaded, the request is dropped if its image isn't being decoded yet.
  */
 void TextureCache::addImageAsync(std::string_view path, const std::function<void(Texture2D*)>& callback)
 {
@@ -140,8 +152,8 @@ void TextureCache::addImageAsync(std::string_view path, const std::function<void
 /**
  The addImageAsync logic follow the steps:
  - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to
- _responseQueue (Load thread)
+ - get AsyncStruct of the highest priority from _requestQueue, load res and fill image data to AsyncStruct.image, then
+ add AsyncStruct to _responseQueue (Load threads)
  - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL
  thread)
 
@@ -151,7 +163,7 @@ void TextureCache::addImageAsync(std::string_view path, const std::function<void
 
  the object's life time:
  - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
+ - image data: new in Load threads, delete in GL thread(by Image instance)
 
  Note:
  - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
@@ -163,8 +175,8 @@ void TextureCache::addImageAsync(std::string_view path, const std::function<void
  - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
 
  Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
+ - Convert image to texture faster than load image from disk, and setAsyncUploadBudget spreads the
+ conversions across frames when many images are decoded at once.
 
  The callbackKey allows to unbind the callback in cases where the loading of
  path is requested by several sources simultaneously. Each source can then
@@ -174,6 +186,14 @@ void TextureCache::addImageAsync(std::string_view path, const std::function<void
 void TextureCache::addImageAsync(std::string_view path,
                                  const std::function<void(Texture2D*)>& callback,
                                  std::string_view callbackKey)
+{
+    addImageAsync(path, callback, callbackKey, 0);
+}
+
+void TextureCache::addImageAsync(std::string_view path,
+                                 const std::function<void(Texture2D*)>& callback,
+                                 std::string_view callbackKey,
+                                 int priority)
 {
     Texture2D* texture = nullptr;
 
@@ -198,14 +218,6 @@ void TextureCache::addImageAsync(std::string_view path,
         return;
     }
 
-    // lazy init
-    if (_loadingThread == nullptr)
-    {
-        // create a new thread to load images
-        _needQuit      = false;
-        _loadingThread = new std::thread(&TextureCache::loadImage, this);
-    }
-
     if (0 == _asyncRefCount)
     {
         Director::getInstance()->getScheduler()->schedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack),
@@ -216,11 +228,25 @@ void TextureCache::addImageAsync(std::string_view path,
 
     // generate async struct
     AsyncStruct* data = new AsyncStruct(fullpath, callback, callbackKey);
+    data->priority    = priority;
 
     // add async struct into queue
     _asyncStructQueue.emplace_back(data);
     std::unique_lock<std::mutex> ul(_requestMutex);
-    _requestQueue.emplace_back(data);
+
+    // after the requests of the same or a higher priority
+    auto pos = _requestQueue.end();
+    while (pos != _requestQueue.begin() && (*(pos - 1))->priority < priority)
+        --pos;
+    _requestQueue.insert(pos, data);
+
+    // lazy init, a thread is started per pending request up to the thread count
+    if (_loadingThreads.empty())
+        _needQuit = false;
+    if (_loadingThreads.size() < static_cast<size_t>(_loadingThreadCount) &&
+        _loadingThreads.size() < _requestQueue.size())
+        _loadingThreads.emplace_back(&TextureCache::loadImage, this);
+
     _sleepCondition.notify_one();
 }
 
@@ -231,13 +257,7 @@ void TextureCache::unbindImageAsync(std::string_view callbackKey)
         return;
     }
 
-    for (auto&& asyncStruct : _asyncStructQueue)
-    {
-        if (asyncStruct->callbackKey == callbackKey)
-        {
-            asyncStruct->callback = nullptr;
-        }
-    }
+    cancelImageAsync([callbackKey](const AsyncStruct* asyncStruct) { return asyncStruct->callbackKey == callbackKey; });
 }
 
 void TextureCache::unbindAllImageAsync()
@@ -246,40 +266,74 @@ void TextureCache::unbindAllImageAsync()
     {
         return;
     }
+
+    cancelImageAsync([](const AsyncStruct*) { return true; });
+}
+
+void TextureCache::cancelImageAsync(const std::function<bool(const AsyncStruct*)>& match)
+{
+    std::vector<AsyncStruct*> dropped;
+    {
+        std::lock_guard<std::mutex> lk(_requestMutex);
+        auto it = std::stable_partition(_requestQueue.begin(), _requestQueue.end(),
+                                        [&match](const AsyncStruct* asyncStruct) { return !match(asyncStruct); });
+        dropped.assign(it, _requestQueue.end());
+        _requestQueue.erase(it, _requestQueue.end());
+    }
+
+    for (auto&& asyncStruct : dropped)
+    {
+        _asyncStructQueue.erase(std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct));
+        delete asyncStruct;
+        --_asyncRefCount;
+    }
+
+    // the requests being decoded complete without calling back
     for (auto&& asyncStruct : _asyncStructQueue)
     {
-        asyncStruct->callback = nullptr;
+        if (match(asyncStruct))
+            asyncStruct->callback = nullptr;
     }
+
+    if (!dropped.empty() && 0 == _asyncRefCount)
+    {
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack),
+                                                            this);
+    }
+}
+
+void TextureCache::setAsyncLoadingThreadCount(int count)
+{
+    _loadingThreadCount = std::max(count, 1);
+}
+
+void TextureCache::setAsyncUploadBudget(int maxTextures, float maxSeconds)
+{
+    _asyncUploadLimit      = std::max(maxTextures, 0);
+    _asyncUploadTimeBudget = std::max(maxSeconds, 0.0f);
 }
 
 void TextureCache::loadImage()
 {
+    FrameProfiler::getInstance()->setThreadName("TextureCache");
+
     AsyncStruct* asyncStruct = nullptr;
-    while (!_needQuit)
+    while (true)
     {
         std::unique_lock<std::mutex> ul(_requestMutex);
-        // pop an AsyncStruct from request queue
-        if (_requestQueue.empty())
-        {
-            asyncStruct = nullptr;
-        }
-        else
+        _sleepCondition.wait(ul, [this] { return _needQuit || !_requestQueue.empty(); });
+        if (_needQuit)
         {
-            asyncStruct = _requestQueue.front();
-            _requestQueue.pop_front();
+            break;
         }
 
-        if (nullptr == asyncStruct)
-        {
-            if (_needQuit)
-            {
-                break;
-            }
-            _sleepCondition.wait(ul);
-            continue;
-        }
+        // pop the AsyncStruct of the highest priority from request queue
+        asyncStruct = _requestQueue.front();
+        _requestQueue.pop_front();
         ul.unlock();
 
+        CC_PROFILE_ZONE("TextureCache::loadImage");
+
         // load image
         asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
 
@@ -302,6 +356,8 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
 {
     Texture2D* texture       = nullptr;
     AsyncStruct* asyncStruct = nullptr;
+    int uploads              = 0;
+    const auto start         = std::chrono::steady_clock::now();
     while (true)
     {
         // pop an AsyncStruct from response queue
@@ -314,10 +370,6 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
         {
             asyncStruct = _responseQueue.front();
             _responseQueue.pop_front();
-
-            // the asyncStruct's sequence order in _asyncStructQueue must equal to the order in _responseQueue
-            CC_ASSERT(asyncStruct == _asyncStructQueue.front());
-            _asyncStructQueue.pop_front();
         }
         _responseMutex.unlock();
 
@@ -326,6 +378,9 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
             break;
         }
 
+        // several threads decode by priority, so the responses come in any order
+        _asyncStructQueue.erase(std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct));
+
         // check the image has been convert to texture or not
         auto it = _textures.find(asyncStruct->filename);
         if (it != _textures.end())
@@ -358,6 +413,7 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
                 {
                     texture->updateWithImage(&asyncStruct->imageAlpha, asyncStruct->pixelFormat, 1);
                 }
+                ++uploads;
             }
             else
             {
@@ -375,6 +431,15 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
         // release the asyncStruct
         delete asyncStruct;
         --_asyncRefCount;
+
+        // the remaining responses are handled on the next frames
+        if (uploads > 0 && ((_asyncUploadLimit > 0 && uploads >= _asyncUploadLimit) ||
+                            (_asyncUploadTimeBudget > 0 &&
+                             std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() >=
+                                 _asyncUploadTimeBudget)))
+        {
+            break;
+        }
     }
 
     if (0 == _asyncRefCount)
@@ -391,6 +456,8 @@ Texture2D* TextureCache::addImage(std::string_view path)
 
 Texture2D* TextureCache::addImage(std::string_view path, PixelFormat format)
 {
+    CC_PROFILE_ZONE("TextureCache::addImage");
+
     Texture2D* texture = nullptr;
     Image* image       = nullptr;
     // Split up directory and filename
@@ -644,13 +711,14 @@ std::string TextureCache::getTextureFilePath(cocos2d::Texture2D* texture) const
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
+    // notify sub threads to quit
     std::unique_lock<std::mutex> ul(_requestMutex);
     _needQuit = true;
-    _sleepCondition.notify_one();
+    _sleepCondition.notify_all();
     ul.unlock();
-    if (_loadingThread)
-        _loadingThread->join();
+    for (auto&& thread : _loadingThreads)
+        thread.join();
+    _loadingThreads.clear();
 }
 
 std::string TextureCache::getCachedTextureInfo() const
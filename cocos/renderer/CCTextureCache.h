@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <vector>
 
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
@@ -115,19 +116,44 @@ public:
                        const std::function<void(Texture2D*)>& callback,
                        std::string_view callbackKey);
 
+    /** Same as above, but the image is decoded before the pending ones of a lower priority, for example a visible
+     * texture before preloaded ones. Images of the same priority are decoded in request order.
+     * @param priority The default priority is 0.
+     */
+    void addImageAsync(std::string_view path,
+                       const std::function<void(Texture2D*)>& callback,
+                       std::string_view callbackKey,
+                       int priority);
+
     /** Unbind a specified bound image asynchronous callback.
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is
      * invoked, the object always need to unbind this callback manually.
+     * Requests which aren't being decoded yet are dropped, so their image isn't loaded.
      * @param filename It's the related/absolute path of the file image.
      * @since v3.1
      */
     virtual void unbindImageAsync(std::string_view filename);
 
     /** Unbind all bound image asynchronous load callbacks.
+     * Requests which aren't being decoded yet are dropped, so their image isn't loaded.
      * @since v3.1
      */
     virtual void unbindAllImageAsync();
 
+    /** Sets the number of threads which decode the images of addImageAsync, they are started when needed.
+     * Running threads are kept when the count is lowered. The default is one less than the hardware concurrency,
+     * at most 4.
+     */
+    void setAsyncLoadingThreadCount(int count);
+    int getAsyncLoadingThreadCount() const { return _loadingThreadCount; }
+
+    /** Limits the textures created from the decoded images in one frame, so that the uploads are spread across
+     * frames. At least one texture is created per frame.
+     * @param maxTextures The maximum count of textures per frame, 0 for no limit.
+     * @param maxSeconds The time after which no more textures are created in the frame, 0 for no limit.
+     */
+    void setAsyncUploadBudget(int maxTextures, float maxSeconds = 0.0f);
+
     /** Returns a Texture2D object given an Image.
      * If the image was not previously loaded, it will create a new Texture2D object and it will return it.
      * Otherwise it will return a reference of a previously loaded image.
@@ -215,7 +241,11 @@ public:
 protected:
     struct AsyncStruct;
 
-    std::thread* _loadingThread;
+    // drops the matching requests which aren't being decoded yet and unbinds the callback of the others
+    void cancelImageAsync(const std::function<bool(const AsyncStruct*)>& match);
+
+    std::vector<std::thread> _loadingThreads;
+    int _loadingThreadCount;
 
     std::deque<AsyncStruct*> _asyncStructQueue;
     std::deque<AsyncStruct*> _requestQueue;
@@ -230,6 +260,9 @@ protected:
 
     int _asyncRefCount;
 
+    int _asyncUploadLimit;
+    float _asyncUploadTimeBudget;
+
     hlookup::string_map<Texture2D*> _textures;
 
     static std::string s_etc1AlphaFileSuffix;
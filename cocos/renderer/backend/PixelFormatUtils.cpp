@@ -27,6 +27,19 @@
 #include "PixelFormatUtils.h"
 #include "Macros.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        #define INCLUDE_SSE
+        #include <immintrin.h>
+        #if defined(_MSC_VER) && !defined(__clang__)
+            #include <intrin.h>
+        #endif
+    #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    #define INCLUDE_NEON
+    #include <arm_neon.h>
+#endif
+
 NS_CC_BEGIN
 
 namespace backend
@@ -34,6 +47,53 @@ namespace backend
 namespace PixelFormatUtils
 {
 
+#if defined(INCLUDE_SSE)
+    #include "renderer/backend/PixelFormatUtilsSSE.inl"
+#elif defined(INCLUDE_NEON)
+    #include "renderer/backend/PixelFormatUtilsNeon.inl"
+#else
+namespace simd
+{
+// no vector unit, the scalar loops handle every pixel
+static size_t premultiplyAlphaRGBA8(unsigned char*, size_t)
+{
+    return 0;
+}
+static size_t convertRGBA8ToRGBA4(const unsigned char*, size_t, unsigned char*)
+{
+    return 0;
+}
+static size_t convertRGBA8ToRGB565(const unsigned char*, size_t, unsigned char*)
+{
+    return 0;
+}
+static size_t convertRGBA8ToRGB5A1(const unsigned char*, size_t, unsigned char*)
+{
+    return 0;
+}
+static size_t convertL8ToRGBA8(const unsigned char*, size_t, unsigned char*)
+{
+    return 0;
+}
+static size_t convertLA8ToRGBA8(const unsigned char*, size_t, unsigned char*)
+{
+    return 0;
+}
+static size_t convertA8ToRGBA8(const unsigned char*, size_t, unsigned char*)
+{
+    return 0;
+}
+static size_t convertRGB8ToRGBA8(const unsigned char*, size_t, unsigned char*)
+{
+    return 0;
+}
+static size_t convertBGRA8ToRGBA8(const unsigned char*, size_t, unsigned char*)
+{
+    return 0;
+}
+}  // namespace simd
+#endif
+
 static const PixelFormatDescriptor s_pixelFormatDescriptors[] = {
     //  +--------------------------------------------- bpp
     //  |   +----------------------------------------- block width
@@ -139,7 +199,9 @@ void convertLA8ToRGB8(const unsigned char* data, size_t dataLen, unsigned char*
 // IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBBAAAAAAAA
 void convertL8ToRGBA8(const unsigned char* data, size_t dataLen, unsigned char* outData)
 {
-    for (size_t i = 0; i < dataLen; ++i)
+    size_t i = simd::convertL8ToRGBA8(data, dataLen, outData);
+    outData += i * 4;
+    for (; i < dataLen; ++i)
     {
         *outData++ = data[i];  // R
         *outData++ = data[i];  // G
@@ -151,7 +213,9 @@ void convertL8ToRGBA8(const unsigned char* data, size_t dataLen, unsigned char*
 // IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void convertLA8ToRGBA8(const unsigned char* data, size_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    const size_t done = simd::convertLA8ToRGBA8(data, dataLen / 2, outData);
+    outData += done * 4;
+    for (ssize_t i = done * 2, l = dataLen - 1; i < l; i += 2)
     {
         *outData++ = data[i];      // R
         *outData++ = data[i];      // G
@@ -268,7 +332,9 @@ void convertLA8ToL8(const unsigned char* data, size_t dataLen, unsigned char* ou
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void convertRGB8ToRGBA8(const unsigned char* data, size_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    const size_t done = simd::convertRGB8ToRGBA8(data, dataLen / 3, outData);
+    outData += done * 4;
+    for (ssize_t i = done * 3, l = dataLen - 2; i < l; i += 3)
     {
         *outData++ = data[i];      // R
         *outData++ = data[i + 1];  // G
@@ -303,8 +369,9 @@ void convertRGB8ToRGB565(const unsigned char* data, size_t dataLen, unsigned cha
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
 void convertRGBA8ToRGB565(const unsigned char* data, size_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    const size_t done     = simd::convertRGBA8ToRGB565(data, dataLen / 4, outData);
+    unsigned short* out16 = (unsigned short*)outData + done;
+    for (ssize_t i = done * 4, l = dataLen - 3; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F8) << 8         // R
                    | (data[i + 1] & 0x00FC) << 3   // G
@@ -389,8 +456,9 @@ void convertRGB8ToRGBA4(const unsigned char* data, size_t dataLen, unsigned char
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
 void convertRGBA8ToRGBA4(const unsigned char* data, size_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    const size_t done     = simd::convertRGBA8ToRGBA4(data, dataLen / 4, outData);
+    unsigned short* out16 = (unsigned short*)outData + done;
+    for (ssize_t i = done * 4, l = dataLen - 3; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F0) << 8        // R
                    | (data[i + 1] & 0x00F0) << 4  // G
@@ -415,8 +483,9 @@ void convertRGB8ToRGB5A1(const unsigned char* data, size_t dataLen, unsigned cha
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGG GGBBBBBA
 void convertRGBA8ToRGB5A1(const unsigned char* data, size_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
+    const size_t done     = simd::convertRGBA8ToRGB5A1(data, dataLen / 4, outData);
+    unsigned short* out16 = (unsigned short*)outData + done;
+    for (ssize_t i = done * 4, l = dataLen - 2; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F8) << 8         // R
                    | (data[i + 1] & 0x00F8) << 3   // G
@@ -472,7 +541,9 @@ void convertRGBA4ToRGBA8(const unsigned char* data, size_t dataLen, unsigned cha
 
 void convertA8ToRGBA8(const unsigned char* data, size_t dataLen, unsigned char* outData)
 {
-    for (size_t i = 0; i < dataLen; i++)
+    size_t i = simd::convertA8ToRGBA8(data, dataLen, outData);
+    outData += i * 4;
+    for (; i < dataLen; i++)
     {
         *outData++ = 0;
         *outData++ = 0;
@@ -484,7 +555,9 @@ void convertA8ToRGBA8(const unsigned char* data, size_t dataLen, unsigned char*
 void convertBGRA8ToRGBA8(const unsigned char* data, size_t dataLen, unsigned char* outData)
 {
     const size_t pixelCounts = dataLen / 4;
-    for (size_t i = 0; i < pixelCounts; i++)
+    size_t i                 = simd::convertBGRA8ToRGBA8(data, pixelCounts, outData);
+    outData += i * 4;
+    for (; i < pixelCounts; i++)
     {
         *outData++ = data[i * 4 + 2];
         *outData++ = data[i * 4 + 1];
@@ -493,6 +566,20 @@ void convertBGRA8ToRGBA8(const unsigned char* data, size_t dataLen, unsigned cha
     }
 }
 
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> (R*(A+1))>>8 (G*(A+1))>>8 (B*(A+1))>>8 A
+void premultiplyAlphaRGBA8(unsigned char* data, size_t dataLen)
+{
+    const size_t pixelCounts = dataLen / 4;
+    for (size_t i = simd::premultiplyAlphaRGBA8(data, pixelCounts); i < pixelCounts; i++)
+    {
+        unsigned char* p = data + i * 4;
+        const unsigned a = p[3] + 1;
+        p[0]             = (unsigned char)((p[0] * a) >> 8);
+        p[1]             = (unsigned char)((p[1] * a) >> 8);
+        p[2]             = (unsigned char)((p[2] * a) >> 8);
+    }
+}
+
 // converter function end
 //////////////////////////////////////////////////////////////////////////
 
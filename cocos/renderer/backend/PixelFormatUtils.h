@@ -163,6 +163,9 @@ void convertRGBA4ToRGBA8(const unsigned char* data, size_t dataLen, unsigned cha
 
 // BGRA8 to XXX
 void convertBGRA8ToRGBA8(const unsigned char* data, size_t dataLen, unsigned char* outData);
+
+// RGBA8 in place, same result as CC_RGB_PREMULTIPLY_ALPHA for every pixel
+void premultiplyAlphaRGBA8(unsigned char* data, size_t dataLen);
 };  // namespace PixelFormatUtils
 }  // namespace backend
 NS_CC_END
@@ -0,0 +1,179 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// NEON kernels, the de-interleaving loads do the channel shuffles for free. Every kernel processes blocks of
+// 16 pixels and returns the pixel count it handled, the caller finishes the tail with the scalar loop.
+
+namespace simd
+{
+
+// (c * (a + 1)) >> 8, same rounding as CC_RGB_PREMULTIPLY_ALPHA
+static inline uint8x16_t premultiply(uint8x16_t c, uint8x16_t a)
+{
+    uint16x8_t lo = vaddw_u8(vmull_u8(vget_low_u8(c), vget_low_u8(a)), vget_low_u8(c));
+    uint16x8_t hi = vaddw_u8(vmull_u8(vget_high_u8(c), vget_high_u8(a)), vget_high_u8(c));
+    return vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+}
+
+static size_t premultiplyAlphaRGBA8(unsigned char* data, size_t pixels)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        p.val[0]       = premultiply(p.val[0], p.val[3]);
+        p.val[1]       = premultiply(p.val[1], p.val[3]);
+        p.val[2]       = premultiply(p.val[2], p.val[3]);
+        vst4q_u8(data + i * 4, p);
+    }
+    return i;
+}
+
+// RRRRGGGG BBBBAAAA, stored as the high and low byte of each 16 bit pixel
+static size_t convertRGBA8ToRGBA4(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const uint8x16_t highNibble = vdupq_n_u8(0xF0);
+
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        uint8x16x2_t out;
+        out.val[0] = vorrq_u8(vandq_u8(p.val[2], highNibble), vshrq_n_u8(p.val[3], 4));
+        out.val[1] = vorrq_u8(vandq_u8(p.val[0], highNibble), vshrq_n_u8(p.val[1], 4));
+        vst2q_u8(outData + i * 2, out);
+    }
+    return i;
+}
+
+// RRRRRGGG GGGBBBBB
+static size_t convertRGBA8ToRGB565(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        uint8x16x2_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(vandq_u8(p.val[1], vdupq_n_u8(0x1C)), 3), vshrq_n_u8(p.val[2], 3));
+        out.val[1] = vorrq_u8(vandq_u8(p.val[0], vdupq_n_u8(0xF8)), vshrq_n_u8(p.val[1], 5));
+        vst2q_u8(outData + i * 2, out);
+    }
+    return i;
+}
+
+// RRRRRGGG GGBBBBBA
+static size_t convertRGBA8ToRGB5A1(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        uint8x16_t g   = vshlq_n_u8(vandq_u8(p.val[1], vdupq_n_u8(0x18)), 3);
+        uint8x16_t b   = vandq_u8(vshrq_n_u8(p.val[2], 2), vdupq_n_u8(0x3E));
+        uint8x16x2_t out;
+        out.val[0] = vorrq_u8(vorrq_u8(g, b), vshrq_n_u8(p.val[3], 7));
+        out.val[1] = vorrq_u8(vandq_u8(p.val[0], vdupq_n_u8(0xF8)), vshrq_n_u8(p.val[1], 5));
+        vst2q_u8(outData + i * 2, out);
+    }
+    return i;
+}
+
+static size_t convertL8ToRGBA8(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16_t l = vld1q_u8(data + i);
+        uint8x16x4_t out;
+        out.val[0] = l;
+        out.val[1] = l;
+        out.val[2] = l;
+        out.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8(outData + i * 4, out);
+    }
+    return i;
+}
+
+static size_t convertLA8ToRGBA8(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x2_t la = vld2q_u8(data + i * 2);
+        uint8x16x4_t out;
+        out.val[0] = la.val[0];
+        out.val[1] = la.val[0];
+        out.val[2] = la.val[0];
+        out.val[3] = la.val[1];
+        vst4q_u8(outData + i * 4, out);
+    }
+    return i;
+}
+
+static size_t convertA8ToRGBA8(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t out;
+        out.val[0] = vdupq_n_u8(0);
+        out.val[1] = vdupq_n_u8(0);
+        out.val[2] = vdupq_n_u8(0);
+        out.val[3] = vld1q_u8(data + i);
+        vst4q_u8(outData + i * 4, out);
+    }
+    return i;
+}
+
+static size_t convertRGB8ToRGBA8(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x3_t p = vld3q_u8(data + i * 3);
+        uint8x16x4_t out;
+        out.val[0] = p.val[0];
+        out.val[1] = p.val[1];
+        out.val[2] = p.val[2];
+        out.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8(outData + i * 4, out);
+    }
+    return i;
+}
+
+static size_t convertBGRA8ToRGBA8(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        uint8x16_t b   = p.val[0];
+        p.val[0]       = p.val[2];
+        p.val[2]       = b;
+        vst4q_u8(outData + i * 4, p);
+    }
+    return i;
+}
+
+}  // namespace simd
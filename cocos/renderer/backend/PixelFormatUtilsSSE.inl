@@ -0,0 +1,353 @@
+/****************************************************************************
+ Copyright (c) 2022 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// SSE2 kernels are always used on x86 builds, AVX2 ones are picked at runtime when the cpu supports them.
+// Every kernel processes a multiple of its block size and returns the pixel count it handled, the caller
+// finishes the tail with the scalar loop, so the result is bit-exact with the scalar conversion.
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define PFU_TARGET_AVX2
+#else
+    #define PFU_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace simd
+{
+
+static bool detectAVX2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    // AVX and OSXSAVE, then the OS must save the ymm state
+    if ((info[2] & (1 << 27 | 1 << 28)) != (1 << 27 | 1 << 28))
+        return false;
+    if ((_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static bool hasAVX2()
+{
+    static const bool s_hasAVX2 = detectAVX2();
+    return s_hasAVX2;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// AVX2
+
+namespace avx2
+{
+
+PFU_TARGET_AVX2 static size_t premultiplyAlphaRGBA8(unsigned char* data, size_t pixels)
+{
+    const __m256i zero      = _mm256_setzero_si256();
+    const __m256i one       = _mm256_set1_epi16(1);
+    const __m256i alphaMask = _mm256_set1_epi32((int)0xFF000000);
+
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m256i p  = _mm256_loadu_si256((const __m256i*)(data + i * 4));
+        __m256i lo = _mm256_unpacklo_epi8(p, zero);
+        __m256i hi = _mm256_unpackhi_epi8(p, zero);
+
+        // broadcast (a + 1) to the four channels of each pixel
+        __m256i alo = _mm256_add_epi16(_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, 0xFF), 0xFF), one);
+        __m256i ahi = _mm256_add_epi16(_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, 0xFF), 0xFF), one);
+        lo          = _mm256_srli_epi16(_mm256_mullo_epi16(lo, alo), 8);
+        hi          = _mm256_srli_epi16(_mm256_mullo_epi16(hi, ahi), 8);
+
+        __m256i r = _mm256_packus_epi16(lo, hi);
+        r         = _mm256_or_si256(_mm256_andnot_si256(alphaMask, r), _mm256_and_si256(alphaMask, p));
+        _mm256_storeu_si256((__m256i*)(data + i * 4), r);
+    }
+    return i;
+}
+
+PFU_TARGET_AVX2 static inline __m256i packRGBA4(__m256i p)
+{
+    const __m256i m00F0 = _mm256_set1_epi32(0x00F0);
+    const __m256i m0F00 = _mm256_set1_epi32(0x0F00);
+    __m256i r           = _mm256_slli_epi32(_mm256_and_si256(p, m00F0), 8);
+    __m256i g           = _mm256_and_si256(_mm256_srli_epi32(p, 4), m0F00);
+    __m256i b           = _mm256_and_si256(_mm256_srli_epi32(p, 16), m00F0);
+    __m256i a           = _mm256_srli_epi32(p, 28);
+    return _mm256_or_si256(_mm256_or_si256(r, g), _mm256_or_si256(b, a));
+}
+
+PFU_TARGET_AVX2 static inline __m256i packRGB565(__m256i p)
+{
+    __m256i r = _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0x00F8)), 8);
+    __m256i g = _mm256_and_si256(_mm256_srli_epi32(p, 5), _mm256_set1_epi32(0x07E0));
+    __m256i b = _mm256_and_si256(_mm256_srli_epi32(p, 19), _mm256_set1_epi32(0x001F));
+    return _mm256_or_si256(_mm256_or_si256(r, g), b);
+}
+
+PFU_TARGET_AVX2 static inline __m256i packRGB5A1(__m256i p)
+{
+    __m256i r = _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0x00F8)), 8);
+    __m256i g = _mm256_and_si256(_mm256_srli_epi32(p, 5), _mm256_set1_epi32(0x07C0));
+    __m256i b = _mm256_and_si256(_mm256_srli_epi32(p, 18), _mm256_set1_epi32(0x003E));
+    __m256i a = _mm256_srli_epi32(p, 31);
+    return _mm256_or_si256(_mm256_or_si256(r, g), _mm256_or_si256(b, a));
+}
+
+template <__m256i (*Pack)(__m256i)>
+PFU_TARGET_AVX2 static size_t convertRGBA8To16(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        __m256i p0 = Pack(_mm256_loadu_si256((const __m256i*)(data + i * 4)));
+        __m256i p1 = Pack(_mm256_loadu_si256((const __m256i*)(data + i * 4 + 32)));
+        // packus works per 128-bit lane, restore the pixel order afterwards
+        __m256i r = _mm256_permute4x64_epi64(_mm256_packus_epi32(p0, p1), 0xD8);
+        _mm256_storeu_si256((__m256i*)(outData + i * 2), r);
+    }
+    return i;
+}
+
+PFU_TARGET_AVX2 static size_t convertL8ToRGBA8(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const __m256i splat = _mm256_set1_epi32(0x00010101);
+    const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m256i l = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(data + i)));
+        l         = _mm256_or_si256(_mm256_mullo_epi32(l, splat), alpha);
+        _mm256_storeu_si256((__m256i*)(outData + i * 4), l);
+    }
+    return i;
+}
+
+PFU_TARGET_AVX2 static size_t convertRGB8ToRGBA8(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha   = _mm_set1_epi32((int)0xFF000000);
+
+    // every load reads 16 bytes for 4 pixels (12 bytes), keep the over-read inside the source
+    size_t i = 0;
+    for (; i + 6 <= pixels; i += 4)
+    {
+        __m128i p = _mm_loadu_si128((const __m128i*)(data + i * 3));
+        p         = _mm_or_si128(_mm_shuffle_epi8(p, shuffle), alpha);
+        _mm_storeu_si128((__m128i*)(outData + i * 4), p);
+    }
+    return i;
+}
+
+}  // namespace avx2
+
+//////////////////////////////////////////////////////////////////////////
+// SSE2
+
+static size_t premultiplyAlphaRGBA8(unsigned char* data, size_t pixels)
+{
+    size_t i = hasAVX2() ? avx2::premultiplyAlphaRGBA8(data, pixels) : 0;
+
+    const __m128i zero      = _mm_setzero_si128();
+    const __m128i one       = _mm_set1_epi16(1);
+    const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+    for (; i + 4 <= pixels; i += 4)
+    {
+        __m128i p  = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i lo = _mm_unpacklo_epi8(p, zero);
+        __m128i hi = _mm_unpackhi_epi8(p, zero);
+
+        // broadcast (a + 1) to the four channels of each pixel
+        __m128i alo = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xFF), 0xFF), one);
+        __m128i ahi = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xFF), 0xFF), one);
+        lo          = _mm_srli_epi16(_mm_mullo_epi16(lo, alo), 8);
+        hi          = _mm_srli_epi16(_mm_mullo_epi16(hi, ahi), 8);
+
+        __m128i r = _mm_packus_epi16(lo, hi);
+        r         = _mm_or_si128(_mm_andnot_si128(alphaMask, r), _mm_and_si128(alphaMask, p));
+        _mm_storeu_si128((__m128i*)(data + i * 4), r);
+    }
+    return i;
+}
+
+static inline __m128i packRGBA4(__m128i p)
+{
+    const __m128i m00F0 = _mm_set1_epi32(0x00F0);
+    const __m128i m0F00 = _mm_set1_epi32(0x0F00);
+    __m128i r           = _mm_slli_epi32(_mm_and_si128(p, m00F0), 8);
+    __m128i g           = _mm_and_si128(_mm_srli_epi32(p, 4), m0F00);
+    __m128i b           = _mm_and_si128(_mm_srli_epi32(p, 16), m00F0);
+    __m128i a           = _mm_srli_epi32(p, 28);
+    return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+}
+
+static inline __m128i packRGB565(__m128i p)
+{
+    __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x00F8)), 8);
+    __m128i g = _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07E0));
+    __m128i b = _mm_and_si128(_mm_srli_epi32(p, 19), _mm_set1_epi32(0x001F));
+    return _mm_or_si128(_mm_or_si128(r, g), b);
+}
+
+static inline __m128i packRGB5A1(__m128i p)
+{
+    __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x00F8)), 8);
+    __m128i g = _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07C0));
+    __m128i b = _mm_and_si128(_mm_srli_epi32(p, 18), _mm_set1_epi32(0x003E));
+    __m128i a = _mm_srli_epi32(p, 31);
+    return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+}
+
+// SSE2 has no unsigned 32->16 pack, sign extend the low halves so packs_epi32 keeps them intact
+static inline __m128i pack32To16(__m128i lo, __m128i hi)
+{
+    lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+    hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+    return _mm_packs_epi32(lo, hi);
+}
+
+template <__m128i (*Pack)(__m128i)>
+static size_t convertRGBA8To16(const unsigned char* data, size_t pixels, unsigned char* outData, size_t i)
+{
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m128i p0 = Pack(_mm_loadu_si128((const __m128i*)(data + i * 4)));
+        __m128i p1 = Pack(_mm_loadu_si128((const __m128i*)(data + i * 4 + 16)));
+        _mm_storeu_si128((__m128i*)(outData + i * 2), pack32To16(p0, p1));
+    }
+    return i;
+}
+
+static size_t convertRGBA8ToRGBA4(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = hasAVX2() ? avx2::convertRGBA8To16<avx2::packRGBA4>(data, pixels, outData) : 0;
+    return convertRGBA8To16<packRGBA4>(data, pixels, outData, i);
+}
+
+static size_t convertRGBA8ToRGB565(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = hasAVX2() ? avx2::convertRGBA8To16<avx2::packRGB565>(data, pixels, outData) : 0;
+    return convertRGBA8To16<packRGB565>(data, pixels, outData, i);
+}
+
+static size_t convertRGBA8ToRGB5A1(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = hasAVX2() ? avx2::convertRGBA8To16<avx2::packRGB5A1>(data, pixels, outData) : 0;
+    return convertRGBA8To16<packRGB5A1>(data, pixels, outData, i);
+}
+
+static size_t convertL8ToRGBA8(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = hasAVX2() ? avx2::convertL8ToRGBA8(data, pixels, outData) : 0;
+
+    const __m128i ff = _mm_set1_epi8((char)0xFF);
+    for (; i + 16 <= pixels; i += 16)
+    {
+        __m128i l  = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i ll = _mm_unpacklo_epi8(l, l);
+        __m128i la = _mm_unpacklo_epi8(l, ff);
+        __m128i hl = _mm_unpackhi_epi8(l, l);
+        __m128i ha = _mm_unpackhi_epi8(l, ff);
+
+        __m128i* out = (__m128i*)(outData + i * 4);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(ll, la));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(ll, la));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hl, ha));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hl, ha));
+    }
+    return i;
+}
+
+static size_t convertLA8ToRGBA8(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const __m128i lowMask = _mm_set1_epi16(0x00FF);
+
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m128i la = _mm_loadu_si128((const __m128i*)(data + i * 2));
+        __m128i l  = _mm_and_si128(la, lowMask);
+        __m128i ll = _mm_or_si128(l, _mm_slli_epi16(l, 8));
+
+        __m128i* out = (__m128i*)(outData + i * 4);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(ll, la));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(ll, la));
+    }
+    return i;
+}
+
+static size_t convertA8ToRGBA8(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        __m128i a  = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i lo = _mm_unpacklo_epi8(zero, a);
+        __m128i hi = _mm_unpackhi_epi8(zero, a);
+
+        __m128i* out = (__m128i*)(outData + i * 4);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(zero, lo));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(zero, lo));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(zero, hi));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(zero, hi));
+    }
+    return i;
+}
+
+static size_t convertRGB8ToRGBA8(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    // the 3 byte stride needs a byte shuffle, which SSE2 does not have
+    return hasAVX2() ? avx2::convertRGB8ToRGBA8(data, pixels, outData) : 0;
+}
+
+static size_t convertBGRA8ToRGBA8(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const __m128i agMask  = _mm_set1_epi32((int)0xFF00FF00);
+    const __m128i lowMask = _mm_set1_epi32(0x000000FF);
+
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4)
+    {
+        __m128i p  = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i ag = _mm_and_si128(p, agMask);
+        __m128i r  = _mm_and_si128(_mm_srli_epi32(p, 16), lowMask);
+        __m128i b  = _mm_slli_epi32(_mm_and_si128(p, lowMask), 16);
+        _mm_storeu_si128((__m128i*)(outData + i * 4), _mm_or_si128(ag, _mm_or_si128(r, b)));
+    }
+    return i;
+}
+
+}  // namespace simd
+
+#undef PFU_TARGET_AVX2
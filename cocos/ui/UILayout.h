@@ -375,6 +375,7 @@ public:
     virtual void addChild(Node* child, int localZOrder, std::string_view name) override;
 
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
     virtual void removeChild(Node* child, bool cleanup = true) override;
 
@@ -253,6 +253,7 @@ public:
      * @js NA
      */
     virtual void visit(cocos2d::Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
     /**
      * Set a callback to touch vent listener.
@@ -197,6 +197,7 @@ protected:
     virtual void visit(cocos2d::Renderer* renderer,
                        const cocos2d::Mat4& parentTransform,
                        uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
     // a help function for SkeletonNode
     // for batch bone's draw to _rootSkeleton
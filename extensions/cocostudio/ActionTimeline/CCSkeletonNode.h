@@ -83,6 +83,7 @@ protected:
     virtual void visit(cocos2d::Renderer* renderer,
                        const cocos2d::Mat4& parentTransform,
                        uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
     virtual void draw(cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t flags) override;
 
 protected:
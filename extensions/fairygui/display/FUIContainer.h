@@ -80,6 +80,7 @@ public:
     void onExitTransitionDidStart() override;
     void onExit() override;
     void visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &parentTransform, uint32_t parentFlags) override;
+    bool hasCustomVisit() const override { return true; }
     void setCameraMask(unsigned short mask, bool applyChildren = true) override;
     void setGlobalZOrder(float globalZOrder) override;
 
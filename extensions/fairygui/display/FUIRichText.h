@@ -43,6 +43,7 @@ public:
 
     const char* hitTestLink(const cocos2d::Vec2& worldPoint);
     virtual void visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
     virtual const cocos2d::Size& getContentSize() const override;
 
@@ -53,6 +53,7 @@ extern "C" {
 #include "scripting/lua-bindings/manual/physics/axlua_physics_manual.hpp"
 #include "scripting/lua-bindings/auto/axlua_backend_auto.hpp"
 #include "base/ZipUtils.h"
+#include "base/CCMemoryTracker.h"
 #include "platform/CCFileUtils.h"
 
 namespace
@@ -104,6 +105,14 @@ int lua_version(lua_State* L)
     lua_pushinteger(L, LUA_VERSION_NUM);
     return 1;
 }
+
+void track_lua_memory(lua_State* L)
+{
+    // the Lua heap is owned by its allocator, so its size is sampled once per frame
+    cocos2d::MemoryTracker::getInstance()->setSampler(cocos2d::MemoryTracker::TAG_SCRIPT, [L]() {
+        return (int64_t)lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+    });
+}
 }  // namespace
 
 NS_CC_BEGIN
@@ -112,6 +121,7 @@ LuaStack::~LuaStack()
 {
     if (nullptr != _state)
     {
+        MemoryTracker::getInstance()->setSampler(MemoryTracker::TAG_SCRIPT, nullptr);
         lua_close(_state);
     }
 }
@@ -135,6 +145,7 @@ LuaStack* LuaStack::attach(lua_State* L)
 bool LuaStack::init()
 {
     _state = lua_open();
+    track_lua_memory(_state);
     luaL_openlibs(_state);
     toluafix_open(_state);
 
@@ -178,6 +189,7 @@ bool LuaStack::init()
 bool LuaStack::initWithLuaState(lua_State* L)
 {
     _state = L;
+    track_lua_memory(_state);
     return true;
 }
 
@@ -0,0 +1,156 @@
+#!/usr/bin/python
+#-*- coding: UTF-8 -*-
+# ----------------------------------------------------------------------------
+# Pack a directory of assets into an archive for FileUtils::mountArchive.
+#
+# License: MIT
+# ----------------------------------------------------------------------------
+'''
+Pack a directory of assets into an archive for FileUtils::mountArchive.
+The layout is documented in cocos/platform/CCAssetArchive.cpp, both must be changed together.
+'''
+
+import os
+import struct
+import zlib
+
+from argparse import ArgumentParser
+
+ARCHIVE_MAGIC = 0x4B504343  # "CCPK"
+ARCHIVE_VERSION = 1
+STORED_ALIGNMENT = 4096
+
+METHOD_STORED = 0
+METHOD_DEFLATE = 1
+
+HEADER_FORMAT = '<IIIIQQQ'
+ENTRY_FORMAT = '<QQIIIHBB'
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+
+# formats which are compressed already, or are worth reading in place
+DEFAULT_STORED_EXTENSIONS = 'png,jpg,jpeg,webp,ktx,ktx2,pvr,pkm,astc,ogg,mp3,mp4,ttf,otf'
+
+
+class KnownException(Exception):
+    pass
+
+
+def hash_path(path):
+    # FNV-1a 64, must match AssetArchive::hashPath
+    h = 0xcbf29ce484222325
+    for c in path.encode('utf-8'):
+        h ^= c
+        h = (h * 0x100000001b3) & 0xffffffffffffffff
+    return h
+
+
+def collect_files(src_dir):
+    files = []
+    for root, dirs, names in os.walk(src_dir):
+        dirs.sort()
+        for name in sorted(names):
+            full_path = os.path.join(root, name)
+            rel_path = os.path.relpath(full_path, src_dir).replace(os.sep, '/')
+            files.append((rel_path, full_path))
+    return files
+
+
+def align(offset, alignment):
+    return (offset + alignment - 1) // alignment * alignment
+
+
+def pack(src_dir, dst_file, stored_extensions, level, verbose):
+    files = collect_files(src_dir)
+    if len(files) >= 1 << 32:
+        raise KnownException('Too many files in %s' % src_dir)
+
+    entries = []
+    with open(dst_file, 'wb') as f:
+        f.write(b'\0' * HEADER_SIZE)
+        offset = HEADER_SIZE
+
+        for rel_path, full_path in files:
+            with open(full_path, 'rb') as src:
+                data = src.read()
+            if len(data) >= 1 << 32:
+                raise KnownException('%s is larger than 4GB' % rel_path)
+
+            method = METHOD_STORED
+            payload = data
+            ext = os.path.splitext(rel_path)[1][1:].lower()
+            if level > 0 and ext not in stored_extensions:
+                deflated = zlib.compress(data, level)
+                # inflating costs more than reading a few more bytes
+                if len(deflated) < len(data) * 0.9:
+                    method = METHOD_DEFLATE
+                    payload = deflated
+
+            if method == METHOD_STORED:
+                padding = align(offset, STORED_ALIGNMENT) - offset
+                f.write(b'\0' * padding)
+                offset += padding
+
+            f.write(payload)
+            entries.append((hash_path(rel_path), offset, len(payload), len(data), method, rel_path))
+            offset += len(payload)
+
+            if verbose:
+                print('%s %s %d -> %d' % ('stored ' if method == METHOD_STORED else 'deflate', rel_path,
+                                          len(data), len(payload)))
+
+        # a power of two, at most one entry per bucket on average
+        bucket_count = 1
+        while bucket_count < len(entries):
+            bucket_count *= 2
+        entries.sort(key=lambda e: (e[0] & (bucket_count - 1), e[5]))
+
+        buckets = [0] * (bucket_count + 1)
+        for e in entries:
+            buckets[(e[0] & (bucket_count - 1)) + 1] += 1
+        for i in range(bucket_count):
+            buckets[i + 1] += buckets[i]
+
+        paths = bytearray()
+        index = bytearray(struct.pack('<%dI' % (bucket_count + 1), *buckets))
+        index += b'\0' * (align(len(index), 8) - len(index))
+        for path_hash, data_offset, compressed_size, size, method, rel_path in entries:
+            encoded = rel_path.encode('utf-8')
+            if len(encoded) >= 1 << 16:
+                raise KnownException('%s is too long' % rel_path)
+            index += struct.pack(ENTRY_FORMAT, path_hash, data_offset, compressed_size, size, len(paths), len(encoded),
+                                 method, 0)
+            paths += encoded + b'\0'
+        index += paths
+
+        index_offset = align(offset, 8)
+        f.write(b'\0' * (index_offset - offset))
+        f.write(index)
+        archive_size = index_offset + len(index)
+
+        f.seek(0)
+        f.write(struct.pack(HEADER_FORMAT, ARCHIVE_MAGIC, ARCHIVE_VERSION, len(entries), bucket_count, index_offset,
+                            len(index), archive_size))
+
+    print('Packed %d files of %s into %s, %d bytes.' % (len(entries), src_dir, dst_file, archive_size))
+
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description='Pack a directory of assets into an archive for FileUtils::mountArchive.')
+    parser.add_argument('src_dir', help='The directory to pack, paths in the archive are relative to it.')
+    parser.add_argument('dst_file', help='The archive to write.')
+    parser.add_argument('-s', '--stored', dest='stored', default=DEFAULT_STORED_EXTENSIONS,
+                        help='Comma separated extensions which are never compressed. Default: %s' %
+                             DEFAULT_STORED_EXTENSIONS)
+    parser.add_argument('-l', '--level', dest='level', type=int, default=6,
+                        help='The deflate level, 0 stores every file. Default: 6')
+    parser.add_argument('-v', '--verbose', dest='verbose', action='store_true', help='Print every packed file.')
+    args = parser.parse_args()
+
+    try:
+        if not os.path.isdir(args.src_dir):
+            raise KnownException('%s is not a directory' % args.src_dir)
+        stored_extensions = set(ext.strip().lower().lstrip('.') for ext in args.stored.split(',') if ext.strip())
+        pack(args.src_dir, args.dst_file, stored_extensions, args.level, args.verbose)
+    except KnownException as e:
+        print(e)
+        exit(1)